@@ -4,16 +4,42 @@
 #include <cctype>
 #include <cassert>
 #include <cinttypes>
+#include <cfloat>
 
 #include <string>
 #include <limits>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
 
 #include "vf128.h"
 #include "stdbits.h"
 #include "stdendian.h"
+#include "vf128_pow5.h"
 
 #define DEBUG_ENCODING 0
 
+#if defined (_MSC_VER)
+#define VF_ALWAYS_INLINE __forceinline
+#define VF_NOINLINE __declspec(noinline)
+#elif defined (__GNUC__)
+#define VF_ALWAYS_INLINE inline __attribute__((always_inline))
+#define VF_NOINLINE __attribute__((noinline,cold))
+#else
+#define VF_ALWAYS_INLINE inline
+#define VF_NOINLINE
+#endif
+
+/* target attributes for the dispatched kernels */
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define VF_KERNEL_X86 1
+#define VF_TARGET(T) __attribute__((target(T)))
+#else
+#define VF_KERNEL_X86 0
+#define VF_TARGET(T)
+#endif
+
 /*
  * buffer implementation
  */
@@ -24,8 +50,10 @@ vf_buf* vf_buf_new(size_t size)
 
     buf->data_offset = 0;
     buf->data_size = size;
-    buf->data = (char*)malloc(buf->data_size);
-    memset(buf->data, 0, buf->data_size);
+    buf->data_pad = VF_BUF_PADDING;
+    buf->stats = nullptr;
+    buf->data = (char*)malloc(buf->data_size + buf->data_pad);
+    memset(buf->data, 0, buf->data_size + buf->data_pad);
 
     return buf;
 }
@@ -61,6 +89,275 @@ void vf_buf_dump(vf_buf *buf)
     }
 }
 
+/*
+ * buffer pool
+ *
+ * pooled buffers are one allocation holding the node, the data and the
+ * padding, bucketed in power of two size classes. released buffers go to
+ * a per-thread cache and overflow in batches to a global free list per
+ * class. the global lists are lock-free stacks where push links with a
+ * compare and swap and a thread refills its cache by exchanging the whole
+ * list for null, so no node is popped from under a concurrent pop (ABA).
+ *
+ * thread caches belong to the pool and are found through a small thread
+ * local table keyed by the pool id, ids are never reused so entries of a
+ * destroyed pool never match. a thread owns at most one cache per pool.
+ * when a table entry is evicted or its thread exits, the cache buffers
+ * are flushed to the global lists and the cache is released for the next
+ * thread that misses, so caches and buffers are not stranded. a registry
+ * of live pools under a mutex keeps a flush from racing with destroy.
+ */
+
+enum : size_t {
+    vf_pool_min_shift = 8,
+    vf_pool_classes = 19,
+    vf_pool_cache_bytes = 4 << 20,
+    vf_pool_cache_max = 64,
+    vf_pool_tls_slots = 4,
+    vf_pool_direct = vf_pool_classes
+};
+
+struct vf_pool_node
+{
+    vf_buf buf;
+    vf_pool_node *next;
+    size_t cls;
+};
+
+struct vf_pool_cache
+{
+    vf_pool_node *head[vf_pool_classes];
+    size_t count[vf_pool_classes];
+    vf_pool_cache *next;
+    std::atomic<bool> owned;
+};
+
+struct vf_buf_pool
+{
+    u64 id;
+    std::atomic<vf_pool_node*> free[vf_pool_classes];
+    std::atomic<vf_pool_cache*> caches;
+    vf_buf_pool *live_next;
+};
+
+struct vf_pool_tls
+{
+    u64 id;
+    vf_buf_pool *pool;
+    vf_pool_cache *cache;
+};
+
+static void _vf_pool_tls_flush(vf_pool_tls &slot);
+
+struct vf_pool_tls_table
+{
+    vf_pool_tls slot[vf_pool_tls_slots];
+    size_t victim;
+
+    ~vf_pool_tls_table()
+    {
+        for (size_t i = 0; i < vf_pool_tls_slots; i++) _vf_pool_tls_flush(slot[i]);
+    }
+};
+
+static std::atomic<u64> _vf_pool_next_id(1);
+static std::mutex _vf_pool_live_lock;
+static vf_buf_pool *_vf_pool_live;
+static thread_local vf_pool_tls_table _vf_pool_tls;
+
+static size_t _vf_pool_class_size(size_t cls)
+{
+    return (size_t)1 << (cls + vf_pool_min_shift);
+}
+
+/* vf_pool_direct for sizes above the largest class */
+static size_t _vf_pool_class(size_t size)
+{
+    if (size <= _vf_pool_class_size(0)) return 0;
+    if (size > _vf_pool_class_size(vf_pool_classes - 1)) return vf_pool_direct;
+    return 64 - clz((u64)size - 1) - vf_pool_min_shift;
+}
+
+static size_t _vf_pool_cache_limit(size_t cls)
+{
+    size_t n = vf_pool_cache_bytes / _vf_pool_class_size(cls);
+    return n < 2 ? 2 : n > vf_pool_cache_max ? vf_pool_cache_max : n;
+}
+
+static void _vf_pool_push(vf_buf_pool *pool, size_t cls,
+    vf_pool_node *first, vf_pool_node *last);
+
+/* return the buffers of a slot to its pool and release the cache */
+static void _vf_pool_tls_flush(vf_pool_tls &slot)
+{
+    if (!slot.cache) return;
+    std::lock_guard<std::mutex> lock(_vf_pool_live_lock);
+    vf_buf_pool *p = _vf_pool_live;
+    while (p && !(p == slot.pool && p->id == slot.id)) p = p->live_next;
+    if (p) {
+        vf_pool_cache *c = slot.cache;
+        for (size_t cls = 0; cls < vf_pool_classes; cls++) {
+            vf_pool_node *last = c->head[cls];
+            if (!last) continue;
+            while (last->next) last = last->next;
+            _vf_pool_push(p, cls, c->head[cls], last);
+            c->head[cls] = nullptr;
+            c->count[cls] = 0;
+        }
+        c->owned.store(false, std::memory_order_release);
+    }
+    slot = vf_pool_tls {};
+}
+
+static vf_pool_cache* _vf_pool_cache_get(vf_buf_pool *pool)
+{
+    for (size_t i = 0; i < vf_pool_tls_slots; i++) {
+        if (_vf_pool_tls.slot[i].id == pool->id) return _vf_pool_tls.slot[i].cache;
+    }
+
+    /* take a released cache of the pool before allocating one */
+    vf_pool_cache *c = pool->caches.load(std::memory_order_acquire);
+    for (; c; c = c->next) {
+        bool expected = false;
+        if (!c->owned.load(std::memory_order_relaxed) &&
+            c->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) break;
+    }
+    if (!c) {
+        c = (vf_pool_cache*)calloc(1, sizeof(vf_pool_cache));
+        if (!c) return nullptr;
+        c->owned.store(true, std::memory_order_relaxed);
+        c->next = pool->caches.load(std::memory_order_relaxed);
+        while (!pool->caches.compare_exchange_weak(c->next, c,
+            std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    vf_pool_tls &slot = _vf_pool_tls.slot[_vf_pool_tls.victim++ % vf_pool_tls_slots];
+    _vf_pool_tls_flush(slot);
+    slot.id = pool->id;
+    slot.pool = pool;
+    slot.cache = c;
+    return c;
+}
+
+/* push the chain first..last onto the global list of its class */
+static void _vf_pool_push(vf_buf_pool *pool, size_t cls,
+    vf_pool_node *first, vf_pool_node *last)
+{
+    std::atomic<vf_pool_node*> &head = pool->free[cls];
+    last->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(last->next, first,
+        std::memory_order_release, std::memory_order_relaxed));
+}
+
+static void _vf_pool_free_list(vf_pool_node *n)
+{
+    while (n) {
+        vf_pool_node *next = n->next;
+        free(n);
+        n = next;
+    }
+}
+
+vf_buf_pool* vf_buf_pool_new(void)
+{
+    vf_buf_pool *pool = new (std::nothrow) vf_buf_pool();
+    if (!pool) return nullptr;
+    pool->id = _vf_pool_next_id.fetch_add(1, std::memory_order_relaxed);
+    for (size_t i = 0; i < vf_pool_classes; i++) pool->free[i].store(nullptr);
+    pool->caches.store(nullptr);
+    std::lock_guard<std::mutex> lock(_vf_pool_live_lock);
+    pool->live_next = _vf_pool_live;
+    _vf_pool_live = pool;
+    return pool;
+}
+
+void vf_buf_pool_destroy(vf_buf_pool *pool)
+{
+    {
+        std::lock_guard<std::mutex> lock(_vf_pool_live_lock);
+        vf_buf_pool **p = &_vf_pool_live;
+        while (*p != pool) p = &(*p)->live_next;
+        *p = pool->live_next;
+    }
+    vf_pool_cache *c = pool->caches.load(std::memory_order_acquire);
+    while (c) {
+        vf_pool_cache *next = c->next;
+        for (size_t i = 0; i < vf_pool_classes; i++) _vf_pool_free_list(c->head[i]);
+        free(c);
+        c = next;
+    }
+    for (size_t i = 0; i < vf_pool_classes; i++) {
+        _vf_pool_free_list(pool->free[i].load(std::memory_order_acquire));
+    }
+    delete pool;
+}
+
+vf_buf* vf_buf_acquire(vf_buf_pool *pool, size_t size)
+{
+    size_t cls = _vf_pool_class(size), cap = size;
+    vf_pool_cache *c = nullptr;
+    vf_pool_node *n = nullptr;
+
+    if (cls < vf_pool_classes) {
+        cap = _vf_pool_class_size(cls);
+        c = _vf_pool_cache_get(pool);
+        if (c && !c->head[cls]) {
+            /* refill from the whole global list */
+            c->head[cls] = pool->free[cls].exchange(nullptr, std::memory_order_acquire);
+            for (vf_pool_node *p = c->head[cls]; p; p = p->next) c->count[cls]++;
+        }
+        if (c && c->head[cls]) {
+            n = c->head[cls];
+            c->head[cls] = n->next;
+            c->count[cls]--;
+        }
+    } else {
+        cls = vf_pool_direct;
+    }
+
+    if (!n) {
+        n = (vf_pool_node*)malloc(sizeof(vf_pool_node) + cap + VF_BUF_PADDING);
+        if (!n) return nullptr;
+        n->cls = cls;
+        n->buf.data = (char*)(n + 1);
+        memset(n->buf.data + cap, 0, VF_BUF_PADDING);
+    }
+
+    n->buf.data_offset = 0;
+    n->buf.data_size = size;
+    n->buf.data_pad = (n->cls < vf_pool_classes ? _vf_pool_class_size(n->cls) : size)
+        - size + VF_BUF_PADDING;
+    n->buf.stats = nullptr;
+    return &n->buf;
+}
+
+void vf_buf_release(vf_buf_pool *pool, vf_buf *buf)
+{
+    vf_pool_node *n = (vf_pool_node*)buf;
+    size_t cls = n->cls;
+    vf_pool_cache *c;
+
+    if (cls == vf_pool_direct || !(c = _vf_pool_cache_get(pool))) {
+        if (cls == vf_pool_direct) free(n);
+        else _vf_pool_push(pool, cls, n, n);
+        return;
+    }
+
+    n->next = c->head[cls];
+    c->head[cls] = n;
+    if (++c->count[cls] <= _vf_pool_cache_limit(cls)) return;
+
+    /* keep half and move the rest to the global list in one push */
+    size_t keep = c->count[cls] / 2;
+    vf_pool_node *last = c->head[cls];
+    for (size_t i = 1; i < keep; i++) last = last->next;
+    vf_pool_node *first = last->next, *tail = first;
+    while (tail->next) tail = tail->next;
+    last->next = nullptr;
+    c->count[cls] = keep;
+    _vf_pool_push(pool, cls, first, tail);
+}
+
 /*
  * structure of ASN.1 tagged data
  *
@@ -399,6 +696,17 @@ size_t vf_le_ber_integer_u64_length_byval(const u64 value)
     return value == 0 ? 1 : 8 - (clz(value) / 8);
 }
 
+/*
+ * load 8 bytes and mask to len bytes when the buffer has tail padding
+ */
+static VF_ALWAYS_INLINE u64 _vf_le_load_masked(const char *p, size_t len)
+{
+    u64 o;
+    memcpy(&o, p, sizeof(o));
+    o = le64(o);
+    return len < 8 ? o & ~(~0ull << (len << 3)) : o;
+}
+
 int vf_le_ber_integer_u64_read(vf_buf *buf, size_t len, u64 *value)
 {
     u64 v = 0, o = 0;
@@ -406,6 +714,11 @@ int vf_le_ber_integer_u64_read(vf_buf *buf, size_t len, u64 *value)
     if (len > 8) {
         goto err;
     }
+    if (buf->data_offset + len <= buf->data_size && vf_buf_check_padded(buf, 8)) {
+        *value = _vf_le_load_masked(buf->data + buf->data_offset, len);
+        buf->data_offset += len;
+        return 0;
+    }
 
 #if USE_UNALIGNED_ACCESSES
     *value = 0;
@@ -433,6 +746,11 @@ u64_result vf_le_ber_integer_u64_read_byval(vf_buf *buf, size_t len)
     if (len > 8) {
         return u64_result { 0, -1 };
     }
+    if (buf->data_offset + len <= buf->data_size && vf_buf_check_padded(buf, 8)) {
+        v = _vf_le_load_masked(buf->data + buf->data_offset, len);
+        buf->data_offset += len;
+        return u64_result { v, 0 };
+    }
 
     if (vf_buf_read_bytes(buf, (char*)&o, len) != len) {
         return u64_result { 0, -1 };
@@ -505,7 +823,7 @@ size_t vf_asn1_ber_integer_s64_length_byval(const s64 value)
     return v == 0 ? 1 : 8 - ((clz(v < 0 ? ~v : v)-1) / 8);
 }
 
-static s64 _sign_extend_s64(s64 x, size_t y) { return ((s64)(x << y)) >> y; }
+static s64 _sign_extend_s64(s64 x, size_t y) { return (s64)((u64)x << y) >> y; }
 
 int vf_asn1_ber_integer_s64_read(vf_buf *buf, size_t len, s64 *value)
 {
@@ -573,6 +891,109 @@ int vf_le_ber_integer_s64_write_byval(vf_buf *buf, size_t len, const s64 value)
     return vf_le_ber_integer_u64_write_byval(buf, len, value);
 }
 
+/*
+ * encoding statistics
+ *
+ * records are classified from the header byte after encoding or before
+ * decoding. out-of-line records with an exponent at or below sub_exp
+ * are renormalized subnormals.
+ */
+
+void vf_stats_reset(vf_stats *stats)
+{
+    memset(stats, 0, sizeof(vf_stats));
+}
+
+void vf_stats_merge(vf_stats *dst, const vf_stats *src)
+{
+    for (size_t i = 0; i < vf_class_count; i++) {
+        dst->records[i] += src->records[i];
+    }
+    for (size_t i = 0; i <= vf_stats_max_length; i++) {
+        dst->length[i] += src->length[i];
+    }
+    dst->header_bytes += src->header_bytes;
+    dst->exp_bytes += src->exp_bytes;
+    dst->man_bytes += src->man_bytes;
+}
+
+const char* vf_class_name(vf_class c)
+{
+    switch (c) {
+    case vf_class_zero: return "zero";
+    case vf_class_inf: return "inf";
+    case vf_class_nan: return "nan";
+    case vf_class_inline: return "inline";
+    case vf_class_pow2: return "pow2";
+    case vf_class_unary: return "unary";
+    case vf_class_subnormal: return "subnormal";
+    case vf_class_full: return "full";
+    default: return "unknown";
+    }
+}
+
+VF_NOINLINE static size_t _vf_stats_add(vf_stats *stats, const char *p, s64 sub_exp)
+{
+    u8 pre = (u8)p[0];
+    size_t vf_exp = (pre >> 4) & 3, vf_man = pre & 15, len = 1;
+    vf_class c;
+
+    if (!(pre & 0x80)) {
+        if (vf_exp == 0 && vf_man == 0) {
+            c = vf_class_zero;
+        } else if (vf_exp == 3) {
+            c = vf_man ? vf_class_nan : vf_class_inf;
+        } else {
+            c = vf_class_inline;
+        }
+    } else {
+        len += vf_exp + vf_man;
+        stats->exp_bytes += vf_exp;
+        stats->man_bytes += vf_man;
+        if (vf_man == 0) {
+            c = vf_class_pow2;
+        } else if (vf_exp == 0) {
+            c = vf_class_unary;
+        } else {
+            u64 e = 0;
+            memcpy(&e, p + 1, vf_exp);
+            s64 x = _sign_extend_s64((s64)le64(e), 64 - (vf_exp << 3));
+            c = x <= sub_exp ? vf_class_subnormal : vf_class_full;
+        }
+    }
+
+    stats->records[c]++;
+    stats->header_bytes++;
+    stats->length[len < vf_stats_max_length ? len : (size_t)vf_stats_max_length]++;
+    return len;
+}
+
+VF_NOINLINE static void _vf_stats_add_range(vf_stats *stats, const char *p, const char *end, s64 sub_exp)
+{
+    while (p < end) {
+        p += _vf_stats_add(stats, p, sub_exp);
+    }
+}
+
+static VF_ALWAYS_INLINE bool _vf_stats_ok(int r) { return r == 0; }
+static VF_ALWAYS_INLINE bool _vf_stats_ok(size_t r) { return r != 0; }
+static VF_ALWAYS_INLINE bool _vf_stats_ok(f32_result r) { return r.error == 0; }
+static VF_ALWAYS_INLINE bool _vf_stats_ok(f64_result r) { return r.error == 0; }
+
+/*
+ * run a codec for the record at the buffer offset and add the record to
+ * the buffer statistics if it succeeds. sub_exp is the subnormal
+ * exponent of the float type.
+ */
+template <typename Fn>
+static VF_ALWAYS_INLINE auto _vf_stats_record(vf_buf *buf, s64 sub_exp, Fn fn) -> decltype(fn())
+{
+    size_t start = buf->data_offset;
+    auto r = fn();
+    if (buf->stats && _vf_stats_ok(r)) _vf_stats_add(buf->stats, buf->data + start, sub_exp);
+    return r;
+}
+
 /*
  * read and write tagged integer
  */
@@ -623,7 +1044,7 @@ int vf_asn1_der_integer_s64_read(vf_buf *buf, asn1_tag _tag, s64 *value)
     return vf_asn1_ber_integer_s64_read(buf, hdr._length, value);
 }
 
-s64_result vf_asn1_der_integer_s64_read_byval(vf_buf *buf, asn1_tag _tag, s64 *value)
+s64_result vf_asn1_der_integer_s64_read_byval(vf_buf *buf, asn1_tag _tag)
 {
     asn1_hdr hdr;
     if (vf_asn1_ber_ident_read(buf, &hdr._id) < 0) return s64_result { 0, -1 };
@@ -751,6 +1172,127 @@ double _f64_inf() { return std::numeric_limits<double>::infinity(); }
 double _f64_nan() { return std::numeric_limits<double>::quiet_NaN(); }
 double _f64_snan() { return std::numeric_limits<double>::signaling_NaN(); }
 
+#if defined (__SIZEOF_INT128__)
+typedef unsigned __int128 u128;
+
+static int _clz_u(u128 x) { u64 hi = (u64)(x >> 64); return hi ? clz(hi) : 64 + clz((u64)x); }
+static int _ctz_u(u128 x) { u64 lo = (u64)x; return lo ? ctz(lo) : 64 + ctz((u64)(x >> 64)); }
+#endif
+
+static int _clz_u(u64 x) { return clz(x); }
+
+/*
+ * round an integer fraction and binary exponent in an IEEE 754 layout
+ * with mant_size stored bits and exp_size exponent bits, with graceful
+ * underflow and overflow to infinity. returns the encoding without the
+ * sign, which directed rounding modes need to know. the implied leading
+ * one carries into the exponent field, which handles subnormals rounding
+ * up to normal and mantissa overflow.
+ */
+template <typename U, int mant_size, int exp_size, vf_rounding mode = vf_round_nearest>
+static VF_ALWAYS_INLINE U _ieee_from_parts(U frac, s64 exp2, bool sign = false)
+{
+    const int w = sizeof(U) << 3;
+    const s64 exp_mask = (1ll << exp_size) - 1, exp_bias = (1ll << (exp_size - 1)) - 1;
+    const U inf = (U)exp_mask << mant_size;
+    const bool away = (mode == vf_round_up && !sign) || (mode == vf_round_down && sign);
+    U m, rem, half, bits;
+    s64 fexp;
+    int lz, sh;
+
+    if (frac == 0) {
+        return 0;
+    }
+
+    /* left-justify the fraction, fexp is the biased exponent of the msb */
+    lz = _clz_u(frac);
+    m = frac << lz;
+    fexp = exp2 + (w - 1) - lz + exp_bias;
+    if (fexp >= exp_mask) {
+        return inf;
+    }
+    if (fexp < -(s64)mant_size) {
+        return away ? 1 : 0;
+    }
+
+    /* shift to mant_size + 1 bits for normals and fewer for subnormals */
+    sh = fexp >= 1 ? w - 1 - mant_size : (int)(w - mant_size - fexp);
+    if (sh == w) {
+        rem = m;
+        m = 0;
+    } else {
+        rem = m & (((U)1 << sh) - 1);
+        m >>= sh;
+    }
+    half = (U)1 << (sh - 1);
+    if (mode == vf_round_nearest ? rem > half || (rem == half && (m & 1)) :
+        mode == vf_round_zero ? false : away && rem != 0) {
+        m++;
+    }
+
+    bits = fexp >= 1 ? ((U)(fexp - 1) << mant_size) + m : m;
+    return bits < inf ? bits : inf;
+}
+
+static f64 _f64_from_parts(bool sign, u64 frac, s64 exp2)
+{
+    return f64_from_bits(_ieee_from_parts<u64,f64_mant_size,f64_exp_size>(frac, exp2)
+        | f64_sign_enc(sign));
+}
+
+static f32 _f32_from_parts(bool sign, u64 frac, s64 exp2)
+{
+    return f32_from_bits((u32)_ieee_from_parts<u64,f32_mant_size,f32_exp_size>(frac, exp2)
+        | f32_sign_enc(sign));
+}
+
+#if defined (VF_HAS_F80)
+/*
+ * x87 extended precision has a 64-bit significand with an explicit
+ * leading one and a 16-bit sign and exponent.
+ */
+enum { f80_exp_bias = 16383, f80_exp_mask = 0x7fff, f80_mant_size = 63 };
+
+struct f80_bits { u64 sig; u16 se; };
+
+static f80_bits f80_to_bits(f80 x)
+{
+    f80_bits b;
+    memcpy(&b.sig, &x, 8);
+    memcpy(&b.se, (const char*)&x + 8, 2);
+    return b;
+}
+
+static f80 f80_from_bits(u64 sig, u16 se)
+{
+    f80 x = 0;
+    memcpy(&x, &sig, 8);
+    memcpy((char*)&x + 8, &se, 2);
+    return x;
+}
+
+static f80 _f80_from_parts(bool sign, u128 frac, s64 exp2)
+{
+    u128 bits = _ieee_from_parts<u128,f80_mant_size,15>(frac, exp2);
+    u64 e = (u64)(bits >> f80_mant_size);
+    u64 sig = ((u64)bits & ~(1ull << f80_mant_size)) | ((u64)(e != 0) << f80_mant_size);
+    return f80_from_bits(sig, (u16)(e | ((u64)sign << 15)));
+}
+#endif
+
+#if defined (VF_HAS_F128)
+enum { f128_exp_bias = 16383, f128_exp_mask = 0x7fff, f128_mant_size = 112 };
+
+static u128 f128_to_bits(f128 x) { u128 u; memcpy(&u, &x, 16); return u; }
+static f128 f128_from_bits(u128 u) { f128 x; memcpy(&x, &u, 16); return x; }
+
+static f128 _f128_from_parts(bool sign, u128 frac, s64 exp2)
+{
+    return f128_from_bits(_ieee_from_parts<u128,f128_mant_size,15>(frac, exp2)
+        | ((u128)sign << 127));
+}
+#endif
+
 /*
  * ISO/IEC 8825-1:2003 8.5 real
  *
@@ -830,8 +1372,8 @@ enum _real_decimal_nr {
 enum _real_special {
     _real_special_pos_inf   = 0b01000000,
     _real_special_neg_inf   = 0b01000001,
-    _real_special_neg_zero  = 0b01000010,
-    _real_special_nan       = 0b01000011,
+    _real_special_nan       = 0b01000010,
+    _real_special_neg_zero  = 0b01000011,
 };
 
 static _real_fmt _asn1_real_format(u8 x)
@@ -844,6 +1386,16 @@ static _real_exp _asn1_real_exp(u8 x)
     return (_real_exp)((x >> _real_exp_shift) & _real_exp_mask);
 }
 
+static _real_base _asn1_real_base(u8 x)
+{
+    return (_real_base)((x >> _real_base_shift) & _real_base_mask);
+}
+
+static u8 _asn1_real_scale(u8 x)
+{
+    return (x >> _real_scale_shift) & _real_scale_mask;
+}
+
 static u8 _asn1_real_binary_full(bool sign, _real_exp exp, _real_base base, u8 scale)
 {
     return 0x80 | ((u8)sign<<6)  | (((u8)base)<<4) | ((scale&3)<<2) | (u8)exp;
@@ -881,12 +1433,14 @@ static f64_real_data f64_asn1_data_get(double value)
 
     sexp = (s64)f64_exp_dec(value);
     frac = (s64)f64_mant_dec(value) | (-(s64)(sexp > 0) & f64_mant_prefix);
-    frac_tz = ctz(frac);
+    frac_tz = frac ? ctz(frac) : 0;
     frac_lz = clz(frac);
     frac >>= frac_tz;
 
     if (sexp > 0) {
         sexp += frac_lz + frac_tz - 63 - f64_exp_bias;
+    } else if (frac != 0) {
+        sexp = frac_tz + 1 - f64_exp_bias - f64_mant_size;
     }
 
     return f64_real_data {
@@ -898,6 +1452,96 @@ static f64_real_data f64_asn1_data_get(double value)
     };
 }
 
+/*
+ * f32 and f80 fractions fit f64_real_data, binary128 needs 113 bits
+ */
+static f64_real_data f32_asn1_data_get(float value)
+{
+    u64 frac;
+    s64 sexp;
+    size_t frac_tz;
+
+    sexp = (s64)f32_exp_dec(value);
+    frac = (u64)f32_mant_dec(value) | (sexp > 0 ? (u64)f32_mant_prefix : 0);
+    frac_tz = frac ? ctz(frac) : 0;
+    frac >>= frac_tz;
+
+    if (frac != 0) {
+        sexp = (sexp > 0 ? sexp : 1) + frac_tz - f32_exp_bias - f32_mant_size;
+    }
+
+    return f64_real_data {
+        frac, sexp,
+        vf_asn1_ber_integer_u64_length(&frac),
+        vf_asn1_ber_integer_s64_length(&sexp),
+        !!f32_sign_dec(value), !!f32_is_inf(value),
+        !!f32_is_nan(value), !!f32_is_zero(value)
+    };
+}
+
+#if defined (VF_HAS_F80)
+static f64_real_data f80_asn1_data_get(f80 value)
+{
+    f80_bits b = f80_to_bits(value);
+    s64 e = b.se & f80_exp_mask, sexp = 0;
+    bool special = e == f80_exp_mask;
+    u64 frac = b.sig;
+    size_t frac_tz;
+
+    frac_tz = frac ? ctz(frac) : 0;
+    frac >>= frac_tz;
+
+    if (frac != 0 && !special) {
+        sexp = (e > 0 ? e : 1) + frac_tz - f80_exp_bias - f80_mant_size;
+    }
+
+    return f64_real_data {
+        frac, sexp,
+        vf_asn1_ber_integer_u64_length(&frac),
+        vf_asn1_ber_integer_s64_length(&sexp),
+        !!(b.se >> 15), special && (b.sig << 1) == 0,
+        special && (b.sig << 1) != 0, e == 0 && b.sig == 0
+    };
+}
+#endif
+
+#if defined (VF_HAS_F128)
+struct f128_real_data
+{
+    u128 frac;
+    s64 sexp;
+    size_t frac_len, exp_len;
+    bool sign : 1, inf : 1, nan : 1, zero : 1;
+};
+
+static f128_real_data f128_asn1_data_get(f128 value)
+{
+    u128 u = f128_to_bits(value);
+    u128 frac = u & (((u128)1 << f128_mant_size) - 1);
+    s64 e = (s64)(u >> f128_mant_size) & f128_exp_mask, sexp = 0;
+    bool special = e == f128_exp_mask, fzero = frac == 0;
+    size_t frac_tz;
+
+    if (e != 0 && !special) {
+        frac |= (u128)1 << f128_mant_size;
+    }
+    frac_tz = frac ? _ctz_u(frac) : 0;
+    frac >>= frac_tz;
+
+    if (frac != 0 && !special) {
+        sexp = (e > 0 ? e : 1) + frac_tz - f128_exp_bias - f128_mant_size;
+    }
+
+    return f128_real_data {
+        frac, sexp,
+        frac ? (size_t)(128 - _clz_u(frac) + 7) >> 3 : 1,
+        vf_asn1_ber_integer_s64_length(&sexp),
+        !!(u >> 127), special && fzero,
+        special && !fzero, e == 0 && fzero
+    };
+}
+#endif
+
 size_t vf_asn1_ber_real_f64_length(const double *value)
 {
     f64_real_data d = f64_asn1_data_get(*value);
@@ -924,153 +1568,483 @@ size_t vf_asn1_ber_real_f64_length_byval(const double value)
     }
 }
 
-int vf_asn1_ber_real_f64_read(vf_buf *buf, size_t len, double *value)
+template <typename U>
+static VF_ALWAYS_INLINE void _vf_be_store(char *p, U v, size_t len)
 {
-    int8_t b;
-    double v = 0;
-    _real_fmt fmt;
-    _real_exp exp_mode;
-    size_t frac_len;
-    size_t exp_len;
-    u64 frac;
-    s64 sexp;
-    u64 fexp;
-    bool sign;
-    size_t frac_lz;
-
-    if (vf_buf_read_i8(buf, &b) != 1) {
-        goto err;
-    }
-    fmt = _asn1_real_format(b);
-    switch (b) {
-    case _real_special_pos_inf:  *value = std::numeric_limits<f64>::infinity();  return 0;
-    case _real_special_neg_inf:  *value = -std::numeric_limits<f64>::infinity(); return 0;
-    case _real_special_neg_zero: *value = -0.0;     return 0;
-    case _real_special_nan:      *value = std::numeric_limits<f64>::quiet_NaN();  return 0;
-    default: break;
-    }
-    switch (fmt) {
-    case _real_fmt_binary_pos: sign = false; break;
-    case _real_fmt_binary_neg: sign = true; break;
-    default: goto err;
-    }
-    exp_mode = _asn1_real_exp(b);
-    switch(exp_mode) {
-    case _real_exp_1: exp_len = 1; break;
-    case _real_exp_2: exp_len = 2; break;
-    default: goto err;
+    for (size_t i = len; i > 0; i--) {
+        p[i - 1] = (char)(v & 0xff);
+        v >>= 8;
     }
-    frac_len = len - exp_len - 1;
+}
 
-    if (vf_asn1_ber_integer_s64_read(buf, exp_len, &sexp) < 0) {
-        goto err;
-    }
-    if (vf_asn1_ber_integer_u64_read(buf, frac_len, &frac) < 0) {
-        goto err;
+static VF_ALWAYS_INLINE u64 _vf_be_load(const char *p, size_t len)
+{
+    u64 v = 0;
+    for (size_t i = 0; i < len; i++) {
+        v = (v << 8) | (u8)p[i];
     }
-    frac_lz = clz(frac);
+    return v;
+}
 
-    /*
-     * IEEE 754 exponent is relative to the msb of the mantissa
-     * ASN.1 exponent is relative to the lsb of the mantissa
-     *
-     * left-justify the fraction with the most significant set bit in bit 51
-     * (0-indexed) cropping off the IEEE 754 implied leading digit 0b1.xxx
-     */
-    if (frac == 1 && sexp == 0) {
-        frac = 0;
-        fexp = f64_exp_bias;
-    } else if (frac == 0 && sexp == 0) {
-        fexp = 0;
+template <typename D>
+static VF_ALWAYS_INLINE size_t _asn1_real_content_length(const D &d)
+{
+    if (d.zero) {
+        return d.sign ? 1 : 3;
+    } else if (d.inf || d.nan) {
+        return 1;
     } else {
-        frac = (frac << (frac_lz + 1)) >> (64 - f64_mant_size);
-        fexp = f64_exp_bias + 63 + sexp - frac_lz;
+        return 1 + d.exp_len + d.frac_len;
     }
-    if (fexp > f64_exp_mask || frac > f64_mant_mask) {
-        return -1;
+}
+
+/*
+ * encode REAL contents without capacity checks. the exponent of every
+ * supported type fits in two octets.
+ */
+template <typename D>
+static VF_ALWAYS_INLINE size_t _asn1_real_content_encode(char *p, const D &d)
+{
+    if (d.zero && d.sign) {
+        p[0] = (char)_real_special_neg_zero;
+        return 1;
+    } else if (d.inf) {
+        p[0] = (char)(d.sign ? _real_special_neg_inf : _real_special_pos_inf);
+        return 1;
+    } else if (d.nan) {
+        p[0] = (char)_real_special_nan;
+        return 1;
     }
-    v = f64_pack_float(f64_struct{frac, fexp, sign});
+    p[0] = (char)_asn1_real_binary(d.sign, d.exp_len == 1 ? _real_exp_1 : _real_exp_2);
+    _vf_be_store(p + 1, (u64)d.sexp, d.exp_len);
+    _vf_be_store(p + 1 + d.exp_len, d.frac, d.frac_len);
+    return 1 + d.exp_len + d.frac_len;
+}
 
-    *value = v;
+template <typename D>
+static int _asn1_real_data_write(vf_buf *buf, const D &d)
+{
+    size_t len = _asn1_real_content_length(d);
+    if (vf_buf_check_capacity(buf, len)) return -1;
+    _asn1_real_content_encode(buf->data + buf->data_offset, d);
+    buf->data_offset += len;
     return 0;
-err:
-    *value = 0;
-    return -1;
 }
 
-f64_result vf_asn1_ber_real_f64_read_byval(vf_buf *buf, size_t len)
+static VF_ALWAYS_INLINE u64 _u64_mul_128(u64 a, u64 b, u64 *hi)
 {
-    int8_t b;
-    double v = 0;
-    _real_fmt fmt;
-    _real_exp exp_mode;
-    size_t frac_len;
-    size_t exp_len;
-    u64 frac;
-    s64 sexp;
-    u64 fexp;
+#if defined (__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *hi = (u64)(r >> 64);
+    return (u64)r;
+#elif defined (_MSC_VER) && defined (_M_X64)
+    return _umul128(a, b, hi);
+#else
+    u64 a_lo = (u32)a, a_hi = a >> 32, b_lo = (u32)b, b_hi = b >> 32;
+    u64 p0 = a_lo * b_lo, p1 = a_lo * b_hi, p2 = a_hi * b_lo, p3 = a_hi * b_hi;
+    u64 mid = (p0 >> 32) + (u32)p1 + (u32)p2;
+    *hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+    return (mid << 32) | (u32)p0;
+#endif
+}
+
+static const f64 _f64_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const f32 _f32_pow10[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+/*
+ * convert w * 10^q to IEEE 754 bits without the sign (Eisel-Lemire).
+ *
+ * w is left-justified and multiplied by a 128-bit truncated power of five.
+ * the second word is only needed when the bits below the result and its
+ * round bit are all ones, and the product is then always accurate enough
+ * to round. ties are only possible for small q where 5^q is exact. values
+ * below 10^min_pow10 round to zero and above 10^max_pow10 to infinity.
+ */
+template <int mant_size, int exp_size, int min_pow10, int max_pow10, int min_even, int max_even>
+static u64 _ieee_decimal_bits(u64 w, s64 q)
+{
+    const s64 exp_mask = (1ll << exp_size) - 1, exp_bias = (1ll << (exp_size - 1)) - 1;
+    const u64 precision_mask = ~0ull >> (mant_size + 3);
+    u64 lo, hi, lo2, hi2, mant;
+    const u64 *p5;
+    s64 lz, upper, power2;
+    int shift;
+
+    if (w == 0 || q < min_pow10) {
+        return 0;
+    }
+    if (q > max_pow10) {
+        return (u64)exp_mask << mant_size;
+    }
+
+    lz = clz(w);
+    w <<= lz;
+    p5 = _vf_pow5_128 + 2 * (q - _vf_pow5_min);
+    lo = _u64_mul_128(w, p5[0], &hi);
+    if ((hi & precision_mask) == precision_mask) {
+        lo2 = _u64_mul_128(w, p5[1], &hi2);
+        (void)lo2;
+        lo += hi2;
+        if (hi2 > lo) hi++;
+    }
+
+    upper = (s64)(hi >> 63);
+    shift = (int)(upper + 64 - mant_size - 3);
+    mant = hi >> shift;
+    power2 = (((152170 + 65536) * q) >> 16) + 63 + upper - lz + exp_bias;
+
+    if (power2 <= 0) {
+        /* subnormal, rounding up to 2^mant_size carries into the smallest normal */
+        if (-power2 + 1 >= 64) {
+            return 0;
+        }
+        mant >>= -power2 + 1;
+        mant += mant & 1;
+        return mant >> 1;
+    }
+
+    /* exact halfway case rounds to even */
+    if (lo <= 1 && q >= min_even && q <= max_even && (mant & 3) == 1) {
+        if ((mant << shift) == hi) {
+            mant &= ~1ull;
+        }
+    }
+    mant += mant & 1;
+    mant >>= 1;
+    if (mant >= (2ull << mant_size)) {
+        mant = 1ull << mant_size;
+        power2++;
+    }
+    if (power2 >= exp_mask) {
+        return (u64)exp_mask << mant_size;
+    }
+    return (mant & ((1ull << mant_size) - 1)) | ((u64)power2 << mant_size);
+}
+
+static u64 _f64_decimal_bits(u64 w, s64 q)
+{
+    return _ieee_decimal_bits<f64_mant_size,f64_exp_size,-342,308,-4,23>(w, q);
+}
+
+static u64 _f32_decimal_bits(u64 w, s64 q)
+{
+    return _ieee_decimal_bits<f32_mant_size,f32_exp_size,-65,38,-17,10>(w, q);
+}
+
+static VF_ALWAYS_INLINE bool _is_digit(char c) { return c >= '0' && c <= '9'; }
+
+/*
+ * decimal strings are scanned into the first 19 significant digits in w
+ * with the value w * 10^q, and trunc is set if any of the remaining digits
+ * are non-zero. mark and exp record which optional parts were present.
+ */
+struct decimal_data
+{
+    const char *str, *end;
+    u64 w;
+    s64 q;
+    bool neg, trunc, mark, exp;
+};
+
+/*
+ * [spaces] [sign] digits [mark digits] [E [sign] digits], where the mark
+ * is '.' or alt_mark and the digits on either side of the mark may be
+ * empty but not both. the whole string must be consumed.
+ */
+static int _decimal_scan(const char *p, const char *end, char alt_mark, decimal_data *d)
+{
+    bool digits = false;
+    size_t nd = 0;
+    s64 e = 0;
+
+    d->w = 0;
+    d->q = 0;
+    d->neg = d->trunc = d->mark = d->exp = false;
+    d->end = end;
+
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    d->str = p;
+    if (p < end && (*p == '+' || *p == '-')) {
+        d->neg = *p++ == '-';
+    }
+    for (; p < end && _is_digit(*p); p++) {
+        digits = true;
+        if (nd < 19) {
+            d->w = d->w * 10 + (*p - '0');
+            nd += d->w != 0;
+        } else {
+            d->q++;
+            d->trunc |= *p != '0';
+        }
+    }
+    if (p < end && (*p == '.' || *p == alt_mark)) {
+        d->mark = true;
+        for (p++; p < end && _is_digit(*p); p++) {
+            digits = true;
+            if (nd < 19) {
+                d->w = d->w * 10 + (*p - '0');
+                nd += d->w != 0;
+                d->q--;
+            } else {
+                d->trunc |= *p != '0';
+            }
+        }
+    }
+    if (!digits) return -1;
+    if (p < end && (*p == 'E' || *p == 'e')) {
+        bool eneg = false, edigits = false;
+        d->exp = true;
+        if (++p < end && (*p == '+' || *p == '-')) {
+            eneg = *p++ == '-';
+        }
+        for (; p < end && _is_digit(*p); p++) {
+            edigits = true;
+            if (e < 100000000) e = e * 10 + (*p - '0');
+        }
+        if (!edigits) return -1;
+        d->q += eneg ? -e : e;
+    }
+    return p == end ? 0 : -1;
+}
+
+/*
+ * decimal REAL contents in ISO 6093 form: NR1 is an integer, NR2 adds a
+ * decimal mark ('.' or ',') and NR3 adds an exponent.
+ */
+static int _asn1_real_decimal_parse(const char *p, size_t len, u8 nr, decimal_data *d)
+{
+    if (_decimal_scan(p, p + len, ',', d) < 0) return -1;
+    switch (nr) {
+    case _real_decimal_nr_1: return d->mark || d->exp ? -1 : 0;
+    case _real_decimal_nr_2: return d->exp ? -1 : 0;
+    case _real_decimal_nr_3: return d->exp ? 0 : -1;
+    default: return -1;
+    }
+}
+
+/* copy of the digits for the C library with '.' as the decimal mark */
+static std::string _decimal_str(const decimal_data &d)
+{
+    std::string s(d.str, d.end - d.str);
+    for (char &c : s) if (c == ',') c = '.';
+    return s;
+}
+
+/*
+ * up to 19 significant digits convert exactly with Clinger's fast path or
+ * Eisel-Lemire. longer inputs are converted twice, with w and w + 1, and
+ * only fall back to the C library when the two results differ.
+ */
+static f64 _f64_decimal(const decimal_data &d)
+{
+    u64 bits;
+
+    if (d.w == 0) {
+        return d.neg ? -0.0 : 0.0;
+    }
+#if FLT_EVAL_METHOD == 0
+    if (!d.trunc && d.q >= -22 && d.q <= 22 && d.w <= (1ull << 53)) {
+        f64 v = (f64)d.w;
+        v = d.q < 0 ? v / _f64_pow10[-d.q] : v * _f64_pow10[d.q];
+        return d.neg ? -v : v;
+    }
+#endif
+    bits = _f64_decimal_bits(d.w, d.q);
+    if (d.trunc && bits != _f64_decimal_bits(d.w + 1, d.q)) {
+        return strtod(_decimal_str(d).c_str(), nullptr);
+    }
+    return f64_from_bits(bits | f64_sign_enc(d.neg));
+}
+
+static f32 _f32_decimal(const decimal_data &d)
+{
+    u64 bits;
+
+    if (d.w == 0) {
+        return d.neg ? -0.0f : 0.0f;
+    }
+#if FLT_EVAL_METHOD == 0
+    if (!d.trunc && d.q >= -10 && d.q <= 10 && d.w <= (1ull << 24)) {
+        f32 v = (f32)d.w;
+        v = d.q < 0 ? v / _f32_pow10[-d.q] : v * _f32_pow10[d.q];
+        return d.neg ? -v : v;
+    }
+#endif
+    bits = _f32_decimal_bits(d.w, d.q);
+    if (d.trunc && bits != _f32_decimal_bits(d.w + 1, d.q)) {
+        return strtof(_decimal_str(d).c_str(), nullptr);
+    }
+    return f32_from_bits((u32)bits | f32_sign_enc(d.neg));
+}
+
+/*
+ * REAL contents (X.690 8.5) parsed into a fraction of up to 128 bits and
+ * a binary exponent, or the leading octet of special and decimal forms.
+ */
+enum _real_kind { _real_kind_binary, _real_kind_special, _real_kind_decimal };
+
+struct asn1_real_parts
+{
+    u64 hi, lo;
+    s64 exp2;
+    _real_kind kind;
     bool sign;
-    size_t frac_lz;
-    s64_result rexp;
-    u64_result rfrac;
+    u8 b;
+};
 
-    if (vf_buf_read_i8(buf, &b) != 1) {
-        return f64_result { 0, -1 };
+/*
+ * binary values are N * 2^F * B^E for base B of 2, 8 or 16, scale factor
+ * F, and exponent E of 1, 2, 3 or a length prefixed number of octets.
+ * empty contents are plus zero. fractions wider than 16 octets keep a
+ * sticky bit below the round bit.
+ */
+static VF_ALWAYS_INLINE int _asn1_real_parse(const char *p, size_t len, asn1_real_parts *r)
+{
+    const char *q, *end = p + len;
+    size_t exp_len, frac_len;
+    s64 sexp;
+    u8 b;
+
+    r->hi = r->lo = 0;
+    r->exp2 = 0;
+    r->kind = _real_kind_binary;
+    r->sign = false;
+
+    if (len == 0) {
+        return 0;
+    }
+    r->b = b = (u8)p[0];
+    switch (_asn1_real_format(b)) {
+    case _real_fmt_special:
+        r->kind = _real_kind_special;
+        return b <= _real_special_neg_zero ? 0 : -1;
+    case _real_fmt_decimal:
+        r->kind = _real_kind_decimal;
+        return 0;
+    case _real_fmt_binary_pos: r->sign = false; break;
+    case _real_fmt_binary_neg: r->sign = true; break;
     }
-    fmt = _asn1_real_format(b);
-    switch (b) {
-    case _real_special_pos_inf:  return f64_result { std::numeric_limits<f64>::infinity(), 0 };
-    case _real_special_neg_inf:  return f64_result { -std::numeric_limits<f64>::infinity(), 0 };
-    case _real_special_neg_zero: return f64_result { -0.0, 0 };
-    case _real_special_nan:      return f64_result { std::numeric_limits<f64>::quiet_NaN(), 0 };
-    default: break;
-    }
-    switch (fmt) {
-    case _real_fmt_binary_pos: sign = false; break;
-    case _real_fmt_binary_neg: sign = true; break;
-    default: return f64_result { 0, -1 };
-    }
-    exp_mode = _asn1_real_exp(b);
-    switch(exp_mode) {
+
+    q = p + 1;
+    switch (_asn1_real_exp(b)) {
     case _real_exp_1: exp_len = 1; break;
     case _real_exp_2: exp_len = 2; break;
-    default: return f64_result { 0, -1 };
+    case _real_exp_3: exp_len = 3; break;
+    default:
+        if (len < 2) return -1;
+        exp_len = (u8)*q++;
+        break;
     }
-    frac_len = len - exp_len - 1;
+    if (exp_len == 0 || exp_len > (size_t)(end - q)) return -1;
+
+    /* exponents wider than 8 octets saturate unless they are sign extended */
+    if (exp_len > 8) {
+        u8 ext = (s8)q[exp_len - 8] < 0 ? 0xff : 0;
+        bool fits = true;
+        for (size_t i = 0; i < exp_len - 8; i++) fits &= (u8)q[i] == ext;
+        sexp = fits ? (s64)_vf_be_load(q + exp_len - 8, 8) :
+            (s8)q[0] < 0 ? -(1ll << 40) : (1ll << 40);
+    } else {
+        sexp = _sign_extend_s64((s64)_vf_be_load(q, exp_len), 64 - (exp_len << 3));
+    }
+    sexp = sexp < -(1ll << 40) ? -(1ll << 40) : sexp > (1ll << 40) ? (1ll << 40) : sexp;
+    q += exp_len;
+
+    switch (_asn1_real_base(b)) {
+    case _real_base_2:  r->exp2 = sexp;     break;
+    case _real_base_8:  r->exp2 = sexp * 3; break;
+    case _real_base_16: r->exp2 = sexp * 4; break;
+    default: return -1;
+    }
+    r->exp2 += _asn1_real_scale(b);
+
+    while (q < end && *q == 0) q++;
+    frac_len = end - q;
+    if (frac_len <= 8) {
+        r->lo = _vf_be_load(q, frac_len);
+    } else if (frac_len <= 16) {
+        r->hi = _vf_be_load(q, frac_len - 8);
+        r->lo = _vf_be_load(q + frac_len - 8, 8);
+    } else {
+        bool sticky = false;
+        for (const char *s = q + 16; s < end; s++) sticky |= *s != 0;
+        r->hi = _vf_be_load(q, 8);
+        r->lo = _vf_be_load(q + 8, 8) | sticky;
+        r->exp2 += (s64)(frac_len - 16) << 3;
+    }
+    return 0;
+}
+
+/* fold a 128-bit fraction to 64 bits keeping a sticky bit */
+static VF_ALWAYS_INLINE u64 _asn1_real_frac_u64(const asn1_real_parts &r, s64 *exp2)
+{
+    int sh;
 
-    rexp = vf_asn1_ber_integer_s64_read_byval(buf, exp_len);
-    if (rexp.error < 0) {
-        return f64_result { 0, rexp.error };
+    *exp2 = r.exp2;
+    if (r.hi == 0) {
+        return r.lo;
     }
-    sexp = rexp.value;
-    rfrac = vf_asn1_ber_integer_u64_read_byval(buf, frac_len);
-    if (rfrac.error < 0) {
-        return f64_result { 0, rfrac.error };
+    sh = 64 - clz(r.hi);
+    *exp2 += sh;
+    if (sh == 64) {
+        return r.hi | (r.lo != 0);
     }
-    frac = rfrac.value;
-    frac_lz = clz(frac);
+    return (r.hi << (64 - sh)) | (r.lo >> sh) | ((r.lo << (64 - sh)) != 0);
+}
 
-    /*
-     * IEEE 754 exponent is relative to the msb of the mantissa
-     * ASN.1 exponent is relative to the lsb of the mantissa
-     *
-     * left-justify the fraction with the most significant set bit in bit 51
-     * (0-indexed) cropping off the IEEE 754 implied leading digit 0b1.xxx
-     */
-    if (frac == 1 && sexp == 0) {
-        frac = 0;
-        fexp = f64_exp_bias;
-    } else if (frac == 0 && sexp == 0) {
-        fexp = 0;
-    } else {
-        frac = (frac << (frac_lz + 1)) >> (64 - f64_mant_size);
-        fexp = f64_exp_bias + 63 + sexp - frac_lz;
+static VF_ALWAYS_INLINE int _asn1_real_f64_content_decode(const char *p, size_t len, double *value)
+{
+    asn1_real_parts r;
+    decimal_data d;
+    u64 frac;
+    s64 exp2;
+
+    if (_asn1_real_parse(p, len, &r) < 0) return -1;
+    switch (r.kind) {
+    case _real_kind_special:
+        switch (r.b) {
+        case _real_special_pos_inf:  *value = std::numeric_limits<f64>::infinity();  return 0;
+        case _real_special_neg_inf:  *value = -std::numeric_limits<f64>::infinity(); return 0;
+        case _real_special_neg_zero: *value = -0.0;     return 0;
+        default:                     *value = std::numeric_limits<f64>::quiet_NaN();  return 0;
+        }
+    case _real_kind_decimal:
+        if (_asn1_real_decimal_parse(p + 1, len - 1, r.b, &d) < 0) return -1;
+        *value = _f64_decimal(d);
+        return 0;
+    default:
+        frac = _asn1_real_frac_u64(r, &exp2);
+        *value = _f64_from_parts(r.sign, frac, exp2);
+        return 0;
     }
-    if (fexp > f64_exp_mask || frac > f64_mant_mask) {
-        return f64_result { 0, -1 };
+}
+
+int vf_asn1_ber_real_f64_read(vf_buf *buf, size_t len, double *value)
+{
+    if (vf_buf_check_capacity(buf, len) ||
+        _asn1_real_f64_content_decode(buf->data + buf->data_offset, len, value) < 0) {
+        *value = 0;
+        return -1;
     }
-    v = f64_pack_float(f64_struct{frac, fexp, sign});
+    buf->data_offset += len;
+    return 0;
+}
+
+f64_result vf_asn1_ber_real_f64_read_byval(vf_buf *buf, size_t len)
+{
+    double v;
 
+    if (vf_buf_check_capacity(buf, len) ||
+        _asn1_real_f64_content_decode(buf->data + buf->data_offset, len, &v) < 0) {
+        return f64_result { 0, -1 };
+    }
+    buf->data_offset += len;
     return f64_result { v, 0 };
 }
 
@@ -1190,6 +2164,286 @@ int vf_asn1_der_real_f64_write_byval(vf_buf *buf, asn1_tag _tag, const double va
     return vf_asn1_ber_real_f64_write_byval(buf, hdr._length, value);
 }
 
+static VF_ALWAYS_INLINE int _asn1_real_f32_content_decode(const char *p, size_t len, float *value)
+{
+    asn1_real_parts r;
+    decimal_data d;
+    u64 frac;
+    s64 exp2;
+
+    if (_asn1_real_parse(p, len, &r) < 0) return -1;
+    switch (r.kind) {
+    case _real_kind_special:
+        switch (r.b) {
+        case _real_special_pos_inf:  *value = std::numeric_limits<f32>::infinity();  return 0;
+        case _real_special_neg_inf:  *value = -std::numeric_limits<f32>::infinity(); return 0;
+        case _real_special_neg_zero: *value = -0.0f;    return 0;
+        default:                     *value = std::numeric_limits<f32>::quiet_NaN();  return 0;
+        }
+    case _real_kind_decimal:
+        if (_asn1_real_decimal_parse(p + 1, len - 1, r.b, &d) < 0) return -1;
+        *value = _f32_decimal(d);
+        return 0;
+    default:
+        frac = _asn1_real_frac_u64(r, &exp2);
+        *value = _f32_from_parts(r.sign, frac, exp2);
+        return 0;
+    }
+}
+
+#if defined (VF_HAS_F80)
+static VF_ALWAYS_INLINE int _asn1_real_f80_content_decode(const char *p, size_t len, f80 *value)
+{
+    asn1_real_parts r;
+    decimal_data d;
+
+    if (_asn1_real_parse(p, len, &r) < 0) return -1;
+    switch (r.kind) {
+    case _real_kind_special:
+        switch (r.b) {
+        case _real_special_pos_inf:  *value = std::numeric_limits<f80>::infinity();  return 0;
+        case _real_special_neg_inf:  *value = -std::numeric_limits<f80>::infinity(); return 0;
+        case _real_special_neg_zero: *value = -0.0L;    return 0;
+        default:                     *value = std::numeric_limits<f80>::quiet_NaN();  return 0;
+        }
+    case _real_kind_decimal:
+        if (_asn1_real_decimal_parse(p + 1, len - 1, r.b, &d) < 0) return -1;
+        *value = strtold(_decimal_str(d).c_str(), nullptr);
+        return 0;
+    default:
+        *value = _f80_from_parts(r.sign, ((u128)r.hi << 64) | r.lo, r.exp2);
+        return 0;
+    }
+}
+#endif
+
+#if defined (VF_HAS_F128)
+/*
+ * decimal binary128 needs C library support (glibc strtof128)
+ */
+static VF_ALWAYS_INLINE int _asn1_real_f128_content_decode(const char *p, size_t len, f128 *value)
+{
+    const u128 inf = (u128)f128_exp_mask << f128_mant_size, sign = (u128)1 << 127;
+    asn1_real_parts r;
+    decimal_data d;
+
+    if (_asn1_real_parse(p, len, &r) < 0) return -1;
+    switch (r.kind) {
+    case _real_kind_special:
+        switch (r.b) {
+        case _real_special_pos_inf:  *value = f128_from_bits(inf);        return 0;
+        case _real_special_neg_inf:  *value = f128_from_bits(inf | sign); return 0;
+        case _real_special_neg_zero: *value = f128_from_bits(sign);       return 0;
+        default: *value = f128_from_bits(inf | ((u128)1 << (f128_mant_size - 1))); return 0;
+        }
+    case _real_kind_decimal:
+        if (_asn1_real_decimal_parse(p + 1, len - 1, r.b, &d) < 0) return -1;
+#if defined (__GLIBC__) && defined (__HAVE_FLOAT128) && __HAVE_FLOAT128
+        *value = strtof128(_decimal_str(d).c_str(), nullptr);
+        return 0;
+#else
+        return -1;
+#endif
+    default:
+        *value = _f128_from_parts(r.sign, ((u128)r.hi << 64) | r.lo, r.exp2);
+        return 0;
+    }
+}
+#endif
+
+/*
+ * f32, f80 and f128 REAL codecs. the minimal length comes from each
+ * type's own layout, so narrow types produce shorter contents.
+ */
+#define VF_ASN1_REAL_IMPL(suffix,T,R)                                          \
+size_t vf_asn1_ber_real_##suffix##_length(const T *value)                      \
+{                                                                              \
+    return _asn1_real_content_length(suffix##_asn1_data_get(*value));          \
+}                                                                              \
+                                                                               \
+size_t vf_asn1_ber_real_##suffix##_length_byval(const T value)                 \
+{                                                                              \
+    return _asn1_real_content_length(suffix##_asn1_data_get(value));           \
+}                                                                              \
+                                                                               \
+int vf_asn1_ber_real_##suffix##_read(vf_buf *buf, size_t len, T *value)        \
+{                                                                              \
+    if (vf_buf_check_capacity(buf, len) || _asn1_real_##suffix##_content_decode(\
+        buf->data + buf->data_offset, len, value) < 0) {                       \
+        *value = 0;                                                            \
+        return -1;                                                             \
+    }                                                                          \
+    buf->data_offset += len;                                                   \
+    return 0;                                                                  \
+}                                                                              \
+                                                                               \
+R vf_asn1_ber_real_##suffix##_read_byval(vf_buf *buf, size_t len)              \
+{                                                                              \
+    T v;                                                                       \
+    if (vf_buf_check_capacity(buf, len) || _asn1_real_##suffix##_content_decode(\
+        buf->data + buf->data_offset, len, &v) < 0) {                          \
+        return R { 0, -1 };                                                    \
+    }                                                                          \
+    buf->data_offset += len;                                                   \
+    return R { v, 0 };                                                         \
+}                                                                              \
+                                                                               \
+int vf_asn1_ber_real_##suffix##_write(vf_buf *buf, size_t len, const T *value) \
+{                                                                              \
+    return _asn1_real_data_write(buf, suffix##_asn1_data_get(*value));         \
+}                                                                              \
+                                                                               \
+int vf_asn1_ber_real_##suffix##_write_byval(vf_buf *buf, size_t len, const T value) \
+{                                                                              \
+    return _asn1_real_data_write(buf, suffix##_asn1_data_get(value));          \
+}                                                                              \
+                                                                               \
+int vf_asn1_der_real_##suffix##_read(vf_buf *buf, asn1_tag _tag, T *value)     \
+{                                                                              \
+    asn1_hdr hdr;                                                              \
+    if (vf_asn1_ber_ident_read(buf, &hdr._id) < 0) return -1;                  \
+    if (vf_asn1_ber_length_read(buf, &hdr._length) < 0) return -1;             \
+    return vf_asn1_ber_real_##suffix##_read(buf, hdr._length, value);          \
+}                                                                              \
+                                                                               \
+R vf_asn1_der_real_##suffix##_read_byval(vf_buf *buf, asn1_tag _tag)           \
+{                                                                              \
+    asn1_hdr hdr;                                                              \
+    if (vf_asn1_ber_ident_read(buf, &hdr._id) < 0) return R { 0, -1 };         \
+    if (vf_asn1_ber_length_read(buf, &hdr._length) < 0) return R { 0, -1 };    \
+    return vf_asn1_ber_real_##suffix##_read_byval(buf, hdr._length);           \
+}                                                                              \
+                                                                               \
+int vf_asn1_der_real_##suffix##_write(vf_buf *buf, asn1_tag _tag, const T *value) \
+{                                                                              \
+    return vf_asn1_der_real_##suffix##_write_byval(buf, _tag, *value);         \
+}                                                                              \
+                                                                               \
+int vf_asn1_der_real_##suffix##_write_byval(vf_buf *buf, asn1_tag _tag, const T value) \
+{                                                                              \
+    auto d = suffix##_asn1_data_get(value);                                    \
+    asn1_hdr hdr = {                                                           \
+        { (u64)_tag, 0, asn1_class_universal }, _asn1_real_content_length(d)   \
+    };                                                                         \
+    if (vf_asn1_ber_ident_write(buf, hdr._id) < 0) return -1;                  \
+    if (vf_asn1_ber_length_write(buf, hdr._length) < 0) return -1;             \
+    return _asn1_real_data_write(buf, d);                                      \
+}
+
+VF_ASN1_REAL_IMPL(f32,float,f32_result)
+#if defined (VF_HAS_F80)
+VF_ASN1_REAL_IMPL(f80,f80,f80_result)
+#endif
+#if defined (VF_HAS_F128)
+VF_ASN1_REAL_IMPL(f128,f128,f128_result)
+#endif
+
+/*
+ * ASN.1 SEQUENCE OF REAL
+ *
+ * each element is a REAL with a single byte identifier and a single
+ * byte length (binary contents are at most 11 bytes). when the buffer
+ * has room for the largest sequence, the elements are encoded in place
+ * behind a header sized for that bound and the header is written after,
+ * moving the elements down if the actual length is shorter. otherwise
+ * the length is computed in a sizing pass so capacity is checked once.
+ */
+
+enum : size_t {
+    asn1_real_f64_max_element = 2 + 11
+};
+
+int vf_asn1_der_real_f64_read_array(vf_buf *buf, asn1_tag _tag, double *value, size_t *count)
+{
+    asn1_hdr hdr;
+    size_t n = 0, end;
+
+    if (vf_asn1_ber_ident_read(buf, &hdr._id) < 0) goto err;
+    if (vf_asn1_ber_length_read(buf, &hdr._length) < 0) goto err;
+    if (hdr._id._identifier != asn1_tag_sequence || !hdr._id._constructed) goto err;
+    if (vf_buf_check_capacity(buf, hdr._length)) goto err;
+
+    end = buf->data_offset + hdr._length;
+    while (buf->data_offset < end) {
+        const char *p = buf->data + buf->data_offset;
+        size_t avail = end - buf->data_offset;
+        if (n == *count) goto err;
+
+        /* single byte identifier and short form length */
+        if (avail >= 2 && (u8)p[0] == (u8)_tag && (u8)p[1] < 0x80) {
+            size_t len = (u8)p[1];
+            if (len > avail - 2) goto err;
+            if (_asn1_real_f64_content_decode(p + 2, len, &value[n]) < 0) goto err;
+            buf->data_offset += 2 + len;
+        } else {
+            if (vf_asn1_ber_ident_read(buf, &hdr._id) < 0) goto err;
+            if (vf_asn1_ber_length_read(buf, &hdr._length) < 0) goto err;
+            if (hdr._id._identifier != (u64)_tag || hdr._id._constructed ||
+                hdr._id._class != asn1_class_universal) goto err;
+            if (buf->data_offset > end || hdr._length > end - buf->data_offset) goto err;
+            if (_asn1_real_f64_content_decode(buf->data + buf->data_offset,
+                hdr._length, &value[n]) < 0) goto err;
+            buf->data_offset += hdr._length;
+        }
+        n++;
+    }
+
+    *count = n;
+    return 0;
+err:
+    *count = n;
+    return -1;
+}
+
+int vf_asn1_der_real_f64_write_array(vf_buf *buf, asn1_tag _tag, const double *value, size_t count)
+{
+    asn1_id seq_id = { asn1_tag_sequence, 1, asn1_class_universal };
+    u64 length = 0;
+    char *p;
+
+    if ((u64)_tag >= 0x1f) return -1;
+
+    u64 bound = (u64)count * asn1_real_f64_max_element;
+    size_t reserve = 1 + vf_asn1_ber_length_length(bound);
+    if (count < ((u64)1 << 56) && vf_buf_check_capacity(buf, reserve + bound) == 0) {
+        char *start = buf->data + buf->data_offset + reserve;
+        p = start;
+        for (size_t i = 0; i < count; i++) {
+            size_t len = _asn1_real_content_encode(p + 2, f64_asn1_data_get(value[i]));
+            p[0] = (char)_tag;
+            p[1] = (char)len;
+            p += 2 + len;
+        }
+        length = p - start;
+        size_t hdr_len = 1 + vf_asn1_ber_length_length(length);
+        if (hdr_len < reserve) memmove(start - (reserve - hdr_len), start, length);
+        vf_asn1_ber_ident_write(buf, seq_id);
+        vf_asn1_ber_length_write(buf, length);
+        buf->data_offset += length;
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        length += 2 + _asn1_real_content_length(f64_asn1_data_get(value[i]));
+    }
+
+    if (vf_asn1_ber_ident_write(buf, seq_id) < 0) return -1;
+    if (vf_asn1_ber_length_write(buf, length) < 0) return -1;
+    if (vf_buf_check_capacity(buf, length)) return -1;
+
+    p = buf->data + buf->data_offset;
+    for (size_t i = 0; i < count; i++) {
+        f64_real_data d = f64_asn1_data_get(value[i]);
+        size_t len = _asn1_real_content_encode(p + 2, d);
+        p[0] = (char)_tag;
+        p[1] = (char)len;
+        p += 2 + len;
+    }
+    buf->data_offset = p - buf->data;
+
+    return 0;
+}
+
 /*
  * vf8 compressed float - f64
  */
@@ -1248,7 +2502,81 @@ static void _vf_f64_debug(double v, u8 pre, s64 vp_exp, u64 vp_man, s64 vd_exp,
 }
 #endif
 
-int vf_f64_read(vf_buf *buf, double *value)
+/*
+ * split exponent and mantissa from two 8-byte little-endian words
+ * loaded from the first byte after the header.
+ */
+static VF_ALWAYS_INLINE void _vf_payload_split(u64 lo, u64 hi,
+    size_t vf_exp, size_t vf_man, s64 *vr_exp, u64 *vr_man)
+{
+    size_t esh = vf_exp << 3, msh = vf_man << 3;
+    u64 m = esh ? (lo >> esh) | (hi << (64 - esh)) : lo;
+
+    *vr_exp = esh ? ((s64)(lo << (64 - esh))) >> (64 - esh) : 0;
+    *vr_man = msh < 64 ? m & ~(~0ull << msh) : m;
+}
+
+/*
+ * convert an out-of-line record to IEEE 754 bits. the mantissa holds the
+ * significand with its leading one at the binary point and is scaled by
+ * 2^vr_exp, or for records without an exponent by 2^(-tz-1) where tz is
+ * the count of trailing zeros holding the exponent (see vf_f64_write).
+ * a zero mantissa is a power of two. renormalized subnormals of the type
+ * that was written have exponents at or below sub_exp and are scaled by
+ * one more. excess precision is rounded with mode, exponents beyond the
+ * range of the type give ±Inf and values below it round to a subnormal
+ * or zero.
+ */
+template <typename U, int mant_size, int exp_size, vf_rounding mode>
+static VF_ALWAYS_INLINE U _vf_record_bits(bool sign, int vf_exp, s64 vr_exp, u64 vr_man,
+    s64 sub_exp = -(s64)(((u64)1 << (exp_size - 1)) - 1))
+{
+    const s64 bias = ((s64)1 << (exp_size - 1)) - 1;
+    s64 e = vf_exp ? vr_exp + (vr_exp <= sub_exp) : -(s64)ctz(vr_man) - 1;
+    u64 frac = vr_man ? vr_man : 1;
+    int lz = clz(frac);
+
+    /* normal values that need no rounding are shifted into place */
+    u64 m = (frac << lz) << 1;
+    if (e > -bias && e <= bias && (mode == vf_round_zero || (m << mant_size) == 0)) {
+        return ((U)sign << (mant_size + exp_size)) | ((U)(e + bias) << mant_size)
+            | (U)(m >> (64 - mant_size));
+    }
+    return (U)_ieee_from_parts<u64,mant_size,exp_size,mode>(frac, e - 63 + lz, sign)
+        | ((U)sign << (mant_size + exp_size));
+}
+
+/*
+ * read exponent and mantissa following the header. if the buffer has
+ * 16 readable bytes including tail padding, the payload is loaded with
+ * fixed width loads, otherwise use variable length reads near the end.
+ */
+static VF_ALWAYS_INLINE int _vf_payload_read(vf_buf *buf, int vf_exp,
+    int vf_man, s64 *vr_exp, u64 *vr_man)
+{
+    size_t len = vf_exp + vf_man;
+
+    if (vf_man > 8 || buf->data_offset + len > buf->data_size) {
+        return -1;
+    }
+    if (vf_buf_check_padded(buf, 16)) {
+        u64 lo, hi;
+        memcpy(&lo, buf->data + buf->data_offset, sizeof(lo));
+        memcpy(&hi, buf->data + buf->data_offset + 8, sizeof(hi));
+        _vf_payload_split(le64(lo), le64(hi), vf_exp, vf_man, vr_exp, vr_man);
+        buf->data_offset += len;
+        return 0;
+    }
+    if (vf_exp && vf_le_ber_integer_s64_read(buf, vf_exp, vr_exp) < 0) {
+        return -1;
+    }
+    if (vf_man && vf_le_ber_integer_u64_read(buf, vf_man, vr_man) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static VF_ALWAYS_INLINE int _vf_f64_read(vf_buf *buf, double *value)
 {
     s8 pre;
     double v = 0;
@@ -1271,10 +2599,7 @@ int vf_f64_read(vf_buf *buf, double *value)
     vf_man =     pre       & 15;
 
     if (!vf_inl) {
-        if (vf_exp && vf_le_ber_integer_s64_read(buf, vf_exp, &vr_exp) < 0) {
-            goto err;
-        }
-        if (vf_man && vf_le_ber_integer_u64_read(buf, vf_man, &vr_man) < 0) {
+        if (_vf_payload_read(buf, vf_exp, vf_man, &vr_exp, &vr_man) < 0) {
             goto err;
         }
     }
@@ -1289,7 +2614,7 @@ int vf_f64_read(vf_buf *buf, double *value)
                  * of the point hence 59 = (63 - 4) then left-justify
                  * the mantissa and truncate the leading 1. */
                 vp_exp = f64_exp_bias + 59 - lz;
-                vp_man = ((u64)vf_man << (lz + 1)) >> (f64_exp_size + 1);
+                vp_man = ((u64)vf_man << lz << 1) >> (f64_exp_size + 1);
             } else {
                 /* Zero */
                 vp_exp = 0;
@@ -1309,23 +2634,14 @@ int vf_f64_read(vf_buf *buf, double *value)
             vp_man = (u64)vf_man << (f64_mant_size - 4);
         }
     }
-    /* out-of-line little-endian exponent and mantissa */
+    /* out-of-line little-endian exponent and mantissa - normal or
+     * subnormal, truncating mantissas wider than the double and reading
+     * exponents beyond its range as ±Inf. */
     else {
-        size_t lz = clz(vr_man), tz = ctz(vr_man);
-        if (vr_exp <= -(s64)f64_exp_bias) {
-            /* normal to subnormal - calculate shift using exponent delta
-             * then left-justify the mantissa preserving the leading 1. */
-            assert(vr_exp >= -(s64)f64_exp_bias - f64_mant_size);
-            size_t sh = f64_exp_bias + vr_exp + lz - f64_exp_size;
-            vp_exp = 0;
-            vp_man = (u64)vr_man << sh;
-        } else {
-            /* normal - if no exponent, mantissa is a fraction in the range
-             * +/-0.9900.. with a unary prefix containing the exponent. */
-            if (vf_exp == 0) vr_exp = -tz - 1;
-            vp_exp = f64_exp_bias + vr_exp;
-            vp_man = (u64)vr_man << (lz + 1) >> (f64_exp_size + 1);
-        }
+        u64 bits = _vf_record_bits<u64,f64_mant_size,f64_exp_size,vf_round_zero>(
+            vf_sgn, vf_exp, vr_exp, vr_man);
+        vp_exp = (s64)((bits >> f64_mant_size) & f64_exp_mask);
+        vp_man = bits & f64_mant_mask;
     }
 
     v = f64_pack_float(f64_struct{vp_man, (u64)vp_exp, vf_sgn});
@@ -1341,12 +2657,17 @@ err:
     return -1;
 }
 
+int vf_f64_read(vf_buf *buf, double *value)
+{
+    return _vf_stats_record(buf, -(s64)f64_exp_bias, [&] { return _vf_f64_read(buf, value); });
+}
+
 enum : u64 {
     u64_msb = 0x8000000000000000ull,
     u64_msn = 0xf000000000000000ull
 };
 
-f64_result vf_f64_read_byval(vf_buf *buf)
+static VF_ALWAYS_INLINE f64_result _vf_f64_read_byval(vf_buf *buf)
 {
     s8 pre;
     double v = 0;
@@ -1369,15 +2690,8 @@ f64_result vf_f64_read_byval(vf_buf *buf)
     vf_man =     pre       & 15;
 
     if (!vf_inl) {
-        if (vf_exp) {
-            s64_result r = vf_le_ber_integer_s64_read_byval(buf, vf_exp);
-            if (r.error < 0) return f64_result { 0, r.error };
-            vr_exp = r.value;
-        }
-        if (vf_man) {
-            u64_result r = vf_le_ber_integer_u64_read_byval(buf, vf_man);
-            if (r.error < 0) return f64_result { 0, r.error };
-            vr_man = r.value;
+        if (_vf_payload_read(buf, vf_exp, vf_man, &vr_exp, &vr_man) < 0) {
+            return f64_result { 0, -1 };
         }
     }
 
@@ -1391,7 +2705,7 @@ f64_result vf_f64_read_byval(vf_buf *buf)
                  * of the point hence 59 = (63 - 4) then left-justify
                  * the mantissa and truncate the leading 1. */
                 vp_exp = f64_exp_bias + 59 - lz;
-                vp_man = ((u64)vf_man << (lz + 1)) >> (f64_exp_size + 1);
+                vp_man = ((u64)vf_man << lz << 1) >> (f64_exp_size + 1);
             } else {
                 /* Zero */
                 vp_exp = 0;
@@ -1411,23 +2725,14 @@ f64_result vf_f64_read_byval(vf_buf *buf)
             vp_man = (u64)vf_man << (f64_mant_size - 4);
         }
     }
-    /* out-of-line little-endian exponent and mantissa */
+    /* out-of-line little-endian exponent and mantissa - normal or
+     * subnormal, truncating mantissas wider than the double and reading
+     * exponents beyond its range as ±Inf. */
     else {
-        size_t lz = clz(vr_man), tz = ctz(vr_man);
-        if (vr_exp <= -(s64)f64_exp_bias) {
-            /* normal to subnormal - calculate shift using exponent delta
-             * then left-justify the mantissa preserving the leading 1. */
-            assert(vr_exp >= -(s64)f64_exp_bias - f64_mant_size);
-            size_t sh = f64_exp_bias + vr_exp + lz - f64_exp_size;
-            vp_exp = 0;
-            vp_man = (u64)vr_man << sh;
-        } else {
-            /* normal - if no exponent, mantissa is a fraction in the range
-             * +/-0.9900.. with a unary prefix containing the exponent. */
-            if (vf_exp == 0) vr_exp = -tz - 1;
-            vp_exp = f64_exp_bias + vr_exp;
-            vp_man = (u64)vr_man << (lz + 1) >> (f64_exp_size + 1);
-        }
+        u64 bits = _vf_record_bits<u64,f64_mant_size,f64_exp_size,vf_round_zero>(
+            vf_sgn, vf_exp, vr_exp, vr_man);
+        vp_exp = (s64)((bits >> f64_mant_size) & f64_exp_mask);
+        vp_man = bits & f64_mant_mask;
     }
 
     v = f64_pack_float(f64_struct{vp_man, (u64)vp_exp, vf_sgn});
@@ -1439,11 +2744,25 @@ f64_result vf_f64_read_byval(vf_buf *buf)
     return f64_result { v, 0 };
 }
 
-int vf_f64_write(vf_buf *buf, const double *value)
+f64_result vf_f64_read_byval(vf_buf *buf)
 {
-    s8 pre;
-    double v = *value;
-    vf_f64_data d = vf_f64_data_get(v);
+    return _vf_stats_record(buf, -(s64)f64_exp_bias, [&] { return _vf_f64_read_byval(buf); });
+}
+
+/* worst-case record lengths: header, exponent and mantissa */
+enum : size_t {
+    vf_f64_max_size = 11,
+    vf_f32_max_size = 7
+};
+
+/*
+ * encode one record at p from exponent and left-justified fraction.
+ * p must have vf_f64_max_size bytes available as the exponent and
+ * mantissa are stored with fixed width stores.
+ */
+static VF_ALWAYS_INLINE size_t _vf_f64_encode(char *p, vf_f64_data d)
+{
+    u8 pre;
     int vf_exp = 0;
     int vf_man = 0;
     u64 vw_man = 0;
@@ -1472,33 +2791,17 @@ int vf_f64_write(vf_buf *buf, const double *value)
     // Out-of-line
     else {
         size_t tz = ctz(d.frac), lz = clz(d.frac);
-        /*
-         * 1. renormalize subnormal fraction (leading one preserved)
-         * 2. omit fraction for powers of two (fraction is zero).
-         * 3. omit exponent for some normal values (exponent unary prefix)
-         * 4. otherwise encode both exponent and fraction
-         */
         if (d.sexp == -(s64)f64_exp_bias) {
             vw_man = d.frac >> tz;
             vw_exp = d.sexp - lz - 1;
             vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
             vf_man = (u8)vf_le_ber_integer_u64_length_byval(vw_man);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
         }
         else if (d.frac == 0) {
             vw_exp = d.sexp;
             vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4);
         }
         else if (d.sexp < 0 && d.sexp >= -8) {
-            /*
-             * - compressing -0.99999.. - 0.99999.. excluding +/-0.
-             * - fixed point fraction with implied exponent of e0 relative
-             *   to the most significant bit in the encoded mantissa.
-             * - bit 7 of the left-most byte of the fraction is 0.5.
-             * - prepend exponent as a unary code in the mantissa lsb.
-             * - compare/choose compressed or normal representation.
-             */
             size_t sh = -d.sexp - 1;
             u64 vw_man_a = (d.frac >> tz) | (u64_msb >> (tz - 1));
             u64 vw_man_b = ((d.frac >> tz) << sh) | ((u64_msb >> (tz - 1)) << sh);
@@ -1514,143 +2817,66 @@ int vf_f64_write(vf_buf *buf, const double *value)
                 vw_man = vw_man_b;
                 vf_man = vf_man_b;
             }
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
         }
         else {
             vw_man = (d.frac >> tz) | (u64_msb >> (tz - 1));
             vw_exp = d.sexp;
             vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
             vf_man = (u8)vf_le_ber_integer_u64_length_byval(vw_man);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
         }
-        /* vf_exp and vf_man contain length of exponent and fraction in bytes */
+        pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
     }
 
-    if (vf_buf_write_i8(buf, pre) != 1) {
-        return -1;
-    }
+#if DEBUG_ENCODING
+    _vf_f64_debug(f64_pack_float(f64_struct{d.frac >> 12, (u64)(d.sexp + f64_exp_bias), d.sign}),
+        pre, d.sexp, d.frac, vw_exp, vw_man);
+#endif
 
-    if ((pre & 0x80)) {
-        if (vf_exp && vf_le_ber_integer_s64_write_byval(buf, vf_exp, vw_exp) < 0) {
-            return -1;
-        }
-        if (vf_man && vf_le_ber_integer_u64_write_byval(buf, vf_man, vw_man) < 0) {
-            return -1;
-        }
+    p[0] = (char)pre;
+    if (!(pre & 0x80)) {
+        return 1;
     }
 
-#if DEBUG_ENCODING
-    _vf_f64_debug(v, pre, d.sexp, d.frac, vw_exp, vw_man);
-#endif
+    /* exponent and mantissa stores are fixed width, the lengths in the
+     * header determine how far the pointer advances. */
+    u32 e = le32((u32)vw_exp);
+    u64 m = le64(vw_man);
+    memcpy(p + 1, &e, sizeof(e));
+    memcpy(p + 1 + vf_exp, &m, sizeof(m));
 
-    return 0;
+    return 1 + vf_exp + vf_man;
 }
 
-int vf_f64_write_byval(vf_buf *buf, const double value)
+/* encode d at the buffer offset, a record that does not fit is not written */
+static VF_ALWAYS_INLINE int _vf_f64_write_data(vf_buf *buf, vf_f64_data d)
 {
-    s8 pre;
-    const double v = value;
-    vf_f64_data d = vf_f64_data_get(v);
-    int vf_exp = 0;
-    int vf_man = 0;
-    u64 vw_man = 0;
-    s64 vw_exp = 0;
-
-    // Inf/NaN
-    if (d.sexp == f64_exp_bias + 1) {
-        vf_exp = 3;
-        vf_man = (d.frac != 0) << 3;
-        pre = (d.sign << 6) | (vf_exp << 4) | vf_man;
-    }
-    // Zero
-    else if (d.sexp == -(s64)f64_exp_bias && d.frac == 0) {
-        pre = (d.sign << 6);
-    }
-    // Inline (normal)
-    else if (d.sexp <= 1 && d.sexp >= 0 &&
-             (d.frac & u64_msn) == d.frac) {
-        pre = (d.sign << 6) | (u8)((d.sexp+1) << 4) | (u8)(d.frac >> 60);
-    }
-    // Inline (subnormal)
-    else if (d.sexp <= -1 && d.sexp >= -4 &&
-             ((d.frac >> -d.sexp) & u64_msn) == (d.frac >> -d.sexp)) {
-        pre = (d.sign << 6) | (u8)((0x10 | (d.frac >> 60)) >> -d.sexp);
-    }
-    // Out-of-line
-    else {
-        size_t tz = ctz(d.frac), lz = clz(d.frac);
-        /*
-         * 1. renormalize subnormal fraction (leading one preserved)
-         * 2. omit fraction for powers of two (fraction is zero).
-         * 3. omit exponent for some normal values (exponent unary prefix)
-         * 4. otherwise encode both exponent and fraction
-         */
-        if (d.sexp == -(s64)f64_exp_bias) {
-            vw_man = d.frac >> tz;
-            vw_exp = d.sexp - lz - 1;
-            vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
-            vf_man = (u8)vf_le_ber_integer_u64_length_byval(vw_man);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
-        }
-        else if (d.frac == 0) {
-            vw_exp = d.sexp;
-            vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4);
-        }
-        else if (d.sexp < 0 && d.sexp >= -8) {
-            /*
-             * - compressing -0.99999.. - 0.99999.. excluding +/-0.
-             * - fixed point fraction with implied exponent of e0 relative
-             *   to the most significant bit in the encoded mantissa.
-             * - bit 7 of the left-most byte of the fraction is 0.5.
-             * - prepend exponent as a unary code in the mantissa lsb.
-             * - compare/choose compressed or normal representation.
-             */
-            size_t sh = -d.sexp - 1;
-            u64 vw_man_a = (d.frac >> tz) | (u64_msb >> (tz - 1));
-            u64 vw_man_b = ((d.frac >> tz) << sh) | ((u64_msb >> (tz - 1)) << sh);
-            int vf_exp_a = (u8)vf_le_ber_integer_s64_length_byval(d.sexp);
-            int vf_man_a = (u8)vf_le_ber_integer_u64_length_byval(vw_man_a);
-            int vf_man_b = (u8)vf_le_ber_integer_u64_length_byval(vw_man_b);
-            if (vf_man_a + vf_exp_a < vf_man_b) {
-                vw_man = vw_man_a;
-                vw_exp = d.sexp;
-                vf_exp = vf_exp_a;
-                vf_man = vf_man_a;
-            } else {
-                vw_man = vw_man_b;
-                vf_man = vf_man_b;
-            }
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
-        }
-        else {
-            vw_man = (d.frac >> tz) | (u64_msb >> (tz - 1));
-            vw_exp = d.sexp;
-            vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
-            vf_man = (u8)vf_le_ber_integer_u64_length_byval(vw_man);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
-        }
-        /* vf_exp and vf_man contain length of exponent and fraction in bytes */
-    }
-
-    if (vf_buf_write_i8(buf, pre) != 1) {
-        return -1;
+    char tmp[vf_f64_max_size + 8];
+    char *p = buf->data + buf->data_offset;
+    size_t len;
+
+    /* encode in place when the worst case fits, otherwise encode into
+     * a scratch record and copy it out if its real length fits. */
+    if (!vf_buf_check_capacity(buf, vf_f64_max_size)) {
+        len = _vf_f64_encode(p, d);
+    } else {
+        len = _vf_f64_encode(tmp, d);
+        if (vf_buf_check_capacity(buf, len)) return -1;
+        memcpy(p, tmp, len);
     }
 
-    if ((pre & 0x80)) {
-        if (vf_exp && vf_le_ber_integer_s64_write_byval(buf, vf_exp, vw_exp) < 0) {
-            return -1;
-        }
-        if (vf_man && vf_le_ber_integer_u64_write_byval(buf, vf_man, vw_man) < 0) {
-            return -1;
-        }
-    }
+    buf->data_offset += len;
+    return 0;
+}
 
-#if DEBUG_ENCODING
-    _vf_f64_debug(v, pre, d.sexp, d.frac, vw_exp, vw_man);
-#endif
+int vf_f64_write_byval(vf_buf *buf, const double value)
+{
+    return _vf_stats_record(buf, -(s64)f64_exp_bias,
+        [&] { return _vf_f64_write_data(buf, vf_f64_data_get(value)); });
+}
 
-    return 0;
+int vf_f64_write(vf_buf *buf, const double *value)
+{
+    return vf_f64_write_byval(buf, *value);
 }
 
 /*
@@ -1711,7 +2937,7 @@ static void _vf_f32_debug(float v, u8 pre, s32 vp_exp, u32 vp_man, s32 vd_exp, u
 }
 #endif
 
-int vf_f32_read(vf_buf *buf, float *value)
+static VF_ALWAYS_INLINE int _vf_f32_read(vf_buf *buf, float *value)
 {
     s8 pre;
     float v = 0;
@@ -1719,8 +2945,8 @@ int vf_f32_read(vf_buf *buf, float *value)
     bool vf_sgn;
     int vf_exp;
     int vf_man;
-    u32 vr_man = 0;
-    s32 vr_exp = 0;
+    u64 vr_man = 0;
+    s64 vr_exp = 0;
     u32 vp_man = 0;
     s32 vp_exp = 0;
 
@@ -1734,20 +2960,8 @@ int vf_f32_read(vf_buf *buf, float *value)
     vf_man =     pre       & 15;
 
     if (!vf_inl) {
-        if (vf_exp) {
-            s64_result r = vf_le_ber_integer_s64_read_byval(buf, vf_exp);
-            if (r.error < 0) goto err;
-            vr_exp = (s32)r.value;
-        }
-        if (vf_man) {
-            u64_result r = vf_le_ber_integer_u64_read_byval(buf, vf_man);
-            if (r.error < 0) goto err;
-
-            /* if there are less than 32 leading zeros, then we must
-             * truncate some precision from the right-most bits. */
-            size_t lz = clz(r.value);
-            size_t sh = lz < 32 ? 32 - lz : 0;
-            vr_man = (u32)(r.value >> sh);
+        if (_vf_payload_read(buf, vf_exp, vf_man, &vr_exp, &vr_man) < 0) {
+            goto err;
         }
     }
 
@@ -1761,7 +2975,7 @@ int vf_f32_read(vf_buf *buf, float *value)
                  * of the point hence 27 = (31 - 4) then left-justify
                  * the mantissa and truncate the leading 1. */
                 vp_exp = f32_exp_bias + 27 - (u32)lz;
-                vp_man = ((u32)vf_man << (lz + 1)) >> (f32_exp_size + 1);
+                vp_man = ((u32)vf_man << lz << 1) >> (f32_exp_size + 1);
             } else {
                 /* Zero */
                 vp_exp = 0;
@@ -1781,23 +2995,14 @@ int vf_f32_read(vf_buf *buf, float *value)
             vp_man = (u32)vf_man << (f32_mant_size - 4);
         }
     }
-    /* out-of-line little-endian exponent and mantissa */
+    /* out-of-line little-endian exponent and mantissa - normal or
+     * subnormal, truncating mantissas wider than the float and reading
+     * exponents beyond its range as ±Inf. */
     else {
-        size_t lz = clz(vr_man), tz = ctz(vr_man);
-        if (vr_exp <= -(s32)f32_exp_bias) {
-            /* normal to subnormal - calculate shift using exponent delta
-             * then left-justify the mantissa preserving the leading 1. */
-            assert(vr_exp >= -(s32)f32_exp_bias - f32_mant_size);
-            size_t sh = f32_exp_bias + vr_exp + (u32)lz - f32_exp_size;
-            vp_exp = 0;
-            vp_man = (u32)vr_man << sh;
-        } else {
-            /* normal - if no exponent, mantissa is a fraction in the range
-             * +/-0.9900.. with a unary prefix containing the exponent. */
-            if (vf_exp == 0) vr_exp = -(s32)tz - 1;
-            vp_exp = f32_exp_bias + vr_exp;
-            vp_man = (u32)vr_man << (lz + 1) >> (f32_exp_size + 1);
-        }
+        u32 bits = _vf_record_bits<u32,f32_mant_size,f32_exp_size,vf_round_zero>(
+            vf_sgn, vf_exp, vr_exp, vr_man);
+        vp_exp = (s32)((bits >> f32_mant_size) & f32_exp_mask);
+        vp_man = bits & f32_mant_mask;
     }
 
     v = f32_pack_float(f32_struct{vp_man, (u32)vp_exp, vf_sgn});
@@ -1813,12 +3018,17 @@ err:
     return -1;
 }
 
+int vf_f32_read(vf_buf *buf, float *value)
+{
+    return _vf_stats_record(buf, -(s64)f32_exp_bias, [&] { return _vf_f32_read(buf, value); });
+}
+
 enum : u32 {
     u32_msb = 0x80000000u,
     u32_msn = 0xf0000000u
 };
 
-f32_result vf_f32_read_byval(vf_buf *buf)
+static VF_ALWAYS_INLINE f32_result _vf_f32_read_byval(vf_buf *buf)
 {
     s8 pre;
     float v = 0;
@@ -1826,8 +3036,8 @@ f32_result vf_f32_read_byval(vf_buf *buf)
     bool vf_sgn;
     int vf_exp;
     int vf_man;
-    u32 vr_man = 0;
-    s32 vr_exp = 0;
+    u64 vr_man = 0;
+    s64 vr_exp = 0;
     u32 vp_man = 0;
     s32 vp_exp = 0;
 
@@ -1841,20 +3051,8 @@ f32_result vf_f32_read_byval(vf_buf *buf)
     vf_man =     pre       & 15;
 
     if (!vf_inl) {
-        if (vf_exp) {
-            s64_result r = vf_le_ber_integer_s64_read_byval(buf, vf_exp);
-            if (r.error < 0) return f32_result { 0, (s32)r.error };
-            vr_exp = (s32)r.value;
-        }
-        if (vf_man) {
-            u64_result r = vf_le_ber_integer_u64_read_byval(buf, vf_man);
-            if (r.error < 0) return f32_result { 0, (s32)r.error };
-
-            /* if there are less than 32 leading zeros, then we must
-             * truncate some precision from the right-most bits. */
-            size_t lz = clz(r.value);
-            size_t sh = lz < 32 ? 32 - lz : 0;
-            vr_man = (u32)(r.value >> sh);
+        if (_vf_payload_read(buf, vf_exp, vf_man, &vr_exp, &vr_man) < 0) {
+            return f32_result { 0, -1 };
         }
     }
 
@@ -1868,7 +3066,7 @@ f32_result vf_f32_read_byval(vf_buf *buf)
                  * of the point hence 27 = (31 - 4) then left-justify
                  * the mantissa and truncate the leading 1. */
                 vp_exp = f32_exp_bias + 27 - (u32)lz;
-                vp_man = ((u32)vf_man << (lz + 1)) >> (f32_exp_size + 1);
+                vp_man = ((u32)vf_man << lz << 1) >> (f32_exp_size + 1);
             } else {
                 /* Zero */
                 vp_exp = 0;
@@ -1888,23 +3086,14 @@ f32_result vf_f32_read_byval(vf_buf *buf)
             vp_man = (u32)vf_man << (f32_mant_size - 4);
         }
     }
-    /* out-of-line little-endian exponent and mantissa */
+    /* out-of-line little-endian exponent and mantissa - normal or
+     * subnormal, truncating mantissas wider than the float and reading
+     * exponents beyond its range as ±Inf. */
     else {
-        size_t lz = clz(vr_man), tz = ctz(vr_man);
-        if (vr_exp <= -(s32)f32_exp_bias) {
-            /* normal to subnormal - calculate shift using exponent delta
-             * then left-justify the mantissa preserving the leading 1. */
-            assert(vr_exp >= -(s32)f32_exp_bias - f32_mant_size);
-            size_t sh = f32_exp_bias + vr_exp + (u32)lz - f32_exp_size;
-            vp_exp = 0;
-            vp_man = (u32)vr_man << sh;
-        } else {
-            /* normal - if no exponent, mantissa is a fraction in the range
-             * +/-0.9900.. with a unary prefix containing the exponent. */
-            if (vf_exp == 0) vr_exp = -(s32)tz - 1;
-            vp_exp = f32_exp_bias + vr_exp;
-            vp_man = (u32)vr_man << (lz + 1) >> (f32_exp_size + 1);
-        }
+        u32 bits = _vf_record_bits<u32,f32_mant_size,f32_exp_size,vf_round_zero>(
+            vf_sgn, vf_exp, vr_exp, vr_man);
+        vp_exp = (s32)((bits >> f32_mant_size) & f32_exp_mask);
+        vp_man = bits & f32_mant_mask;
     }
 
     v = f32_pack_float(f32_struct{vp_man, (u32)vp_exp, vf_sgn});
@@ -1916,11 +3105,14 @@ f32_result vf_f32_read_byval(vf_buf *buf)
     return f32_result { v, 0 };
 }
 
-int vf_f32_write(vf_buf *buf, const float *value)
+f32_result vf_f32_read_byval(vf_buf *buf)
 {
-    s8 pre;
-    float v = *value;
-    vf_f32_data d = vf_f32_data_get(v);
+    return _vf_stats_record(buf, -(s64)f32_exp_bias, [&] { return _vf_f32_read_byval(buf); });
+}
+
+static VF_ALWAYS_INLINE size_t _vf_f32_encode(char *p, vf_f32_data d)
+{
+    u8 pre;
     int vf_exp = 0;
     int vf_man = 0;
     u32 vw_man = 0;
@@ -1949,33 +3141,17 @@ int vf_f32_write(vf_buf *buf, const float *value)
     // Out-of-line
     else {
         size_t tz = ctz(d.frac), lz = clz(d.frac);
-        /*
-         * 1. renormalize subnormal fraction (leading one preserved)
-         * 2. omit fraction for powers of two (fraction is zero).
-         * 3. omit exponent for some normal values (exponent unary prefix)
-         * 4. otherwise encode both exponent and fraction
-         */
         if (d.sexp == -(s32)f32_exp_bias) {
             vw_man = d.frac >> tz;
             vw_exp = d.sexp - (u32)lz - 1;
             vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
             vf_man = (u8)vf_le_ber_integer_u64_length_byval(vw_man);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
         }
         else if (d.frac == 0) {
             vw_exp = d.sexp;
             vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4);
         }
         else if (d.sexp < 0 && d.sexp >= -8) {
-            /*
-             * - compressing -0.99999.. - 0.99999.. excluding +/-0.
-             * - fixed point fraction with implied exponent of e0 relative
-             *   to the most significant bit in the encoded mantissa.
-             * - bit 7 of the left-most byte of the fraction is 0.5.
-             * - prepend exponent as a unary code in the mantissa lsb.
-             * - compare/choose compressed or normal representation.
-             */
             size_t sh = -d.sexp - 1;
             u32 vw_man_a = (d.frac >> tz) | (u32_msb >> (tz - 1));
             u32 vw_man_b = ((d.frac >> tz) << sh) | ((u32_msb >> (tz - 1)) << sh);
@@ -1991,143 +3167,64 @@ int vf_f32_write(vf_buf *buf, const float *value)
                 vw_man = vw_man_b;
                 vf_man = vf_man_b;
             }
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
         }
         else {
             vw_man = (d.frac >> tz) | (u32_msb >> (tz - 1));
             vw_exp = d.sexp;
             vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
             vf_man = (u8)vf_le_ber_integer_u64_length_byval(vw_man);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
         }
-        /* vf_exp and vf_man contain length of exponent and fraction in bytes */
+        pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
     }
 
-    if (vf_buf_write_i8(buf, pre) != 1) {
-        return -1;
-    }
+#if DEBUG_ENCODING
+    _vf_f32_debug(f32_pack_float(f32_struct{d.frac >> 9, (u32)(d.sexp + f32_exp_bias), d.sign}),
+        pre, d.sexp, d.frac, vw_exp, vw_man);
+#endif
 
-    if ((pre & 0x80)) {
-        if (vf_exp && vf_le_ber_integer_s64_write_byval(buf, vf_exp, vw_exp) < 0) {
-            return -1;
-        }
-        if (vf_man && vf_le_ber_integer_u64_write_byval(buf, vf_man, vw_man) < 0) {
-            return -1;
-        }
+    p[0] = (char)pre;
+    if (!(pre & 0x80)) {
+        return 1;
     }
 
-#if DEBUG_ENCODING
-    _vf_f32_debug(v, pre, d.sexp, d.frac, vw_exp, vw_man);
-#endif
+    u16 e = le16((u16)vw_exp);
+    u32 m = le32(vw_man);
+    memcpy(p + 1, &e, sizeof(e));
+    memcpy(p + 1 + vf_exp, &m, sizeof(m));
 
-    return 0;
+    return 1 + vf_exp + vf_man;
 }
 
-int vf_f32_write_byval(vf_buf *buf, const float value)
+/* encode d at the buffer offset, a record that does not fit is not written */
+static VF_ALWAYS_INLINE int _vf_f32_write_data(vf_buf *buf, vf_f32_data d)
 {
-    s8 pre;
-    const float v = value;
-    vf_f32_data d = vf_f32_data_get(v);
-    int vf_exp = 0;
-    int vf_man = 0;
-    u32 vw_man = 0;
-    s32 vw_exp = 0;
-
-    // Inf/NaN
-    if (d.sexp == f32_exp_bias + 1) {
-        vf_exp = 3;
-        vf_man = (d.frac != 0) << 3;
-        pre = (d.sign << 6) | (vf_exp << 4) | vf_man;
-    }
-    // Zero
-    else if (d.sexp == -(s32)f32_exp_bias && d.frac == 0) {
-        pre = (d.sign << 6);
-    }
-    // Inline (normal)
-    else if (d.sexp <= 1 && d.sexp >= 0 &&
-             (d.frac & u32_msn) == d.frac) {
-        pre = (d.sign << 6) | (u8)((d.sexp+1) << 4) | (u8)(d.frac >> 28);
-    }
-    // Inline (subnormal)
-    else if (d.sexp <= -1 && d.sexp >= -4 &&
-             ((d.frac >> -d.sexp) & u32_msn) == (d.frac >> -d.sexp)) {
-        pre = (d.sign << 6) | (u8)((0x10 | (d.frac >> 28)) >> -d.sexp);
-    }
-    // Out-of-line
-    else {
-        size_t tz = ctz(d.frac), lz = clz(d.frac);
-        /*
-         * 1. renormalize subnormal fraction (leading one preserved)
-         * 2. omit fraction for powers of two (fraction is zero).
-         * 3. omit exponent for some normal values (exponent unary prefix)
-         * 4. otherwise encode both exponent and fraction
-         */
-        if (d.sexp == -(s32)f32_exp_bias) {
-            vw_man = d.frac >> tz;
-            vw_exp = d.sexp - (u32)lz - 1;
-            vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
-            vf_man = (u8)vf_le_ber_integer_u64_length_byval(vw_man);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
-        }
-        else if (d.frac == 0) {
-            vw_exp = d.sexp;
-            vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4);
-        }
-        else if (d.sexp < 0 && d.sexp >= -8) {
-            /*
-             * - compressing -0.99999.. - 0.99999.. excluding +/-0.
-             * - fixed point fraction with implied exponent of e0 relative
-             *   to the most significant bit in the encoded mantissa.
-             * - bit 7 of the left-most byte of the fraction is 0.5.
-             * - prepend exponent as a unary code in the mantissa lsb.
-             * - compare/choose compressed or normal representation.
-             */
-            size_t sh = -d.sexp - 1;
-            u32 vw_man_a = (d.frac >> tz) | (u32_msb >> (tz - 1));
-            u32 vw_man_b = ((d.frac >> tz) << sh) | ((u32_msb >> (tz - 1)) << sh);
-            int vf_exp_a = (u8)vf_le_ber_integer_s64_length_byval(d.sexp);
-            int vf_man_a = (u8)vf_le_ber_integer_u64_length_byval(vw_man_a);
-            int vf_man_b = (u8)vf_le_ber_integer_u64_length_byval(vw_man_b);
-            if (vf_man_a + vf_exp_a < vf_man_b) {
-                vw_man = vw_man_a;
-                vw_exp = d.sexp;
-                vf_exp = vf_exp_a;
-                vf_man = vf_man_a;
-            } else {
-                vw_man = vw_man_b;
-                vf_man = vf_man_b;
-            }
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
-        }
-        else {
-            vw_man = (d.frac >> tz) | (u32_msb >> (tz - 1));
-            vw_exp = d.sexp;
-            vf_exp = (u8)vf_le_ber_integer_s64_length_byval(vw_exp);
-            vf_man = (u8)vf_le_ber_integer_u64_length_byval(vw_man);
-            pre = 0x80 | (d.sign << 6) | (vf_exp << 4) | vf_man;
-        }
-        /* vf_exp and vf_man contain length of exponent and fraction in bytes */
-    }
-
-    if (vf_buf_write_i8(buf, pre) != 1) {
-        return -1;
+    char tmp[vf_f32_max_size + 8];
+    char *p = buf->data + buf->data_offset;
+    size_t len;
+
+    /* encode in place when the worst case fits, otherwise encode into
+     * a scratch record and copy it out if its real length fits. */
+    if (!vf_buf_check_capacity(buf, vf_f32_max_size)) {
+        len = _vf_f32_encode(p, d);
+    } else {
+        len = _vf_f32_encode(tmp, d);
+        if (vf_buf_check_capacity(buf, len)) return -1;
+        memcpy(p, tmp, len);
     }
 
-    if ((pre & 0x80)) {
-        if (vf_exp && vf_le_ber_integer_s64_write_byval(buf, vf_exp, vw_exp) < 0) {
-            return -1;
-        }
-        if (vf_man && vf_le_ber_integer_u64_write_byval(buf, vf_man, vw_man) < 0) {
-            return -1;
-        }
-    }
+    buf->data_offset += len;
+    return 0;
+}
 
-#if DEBUG_ENCODING
-    _vf_f32_debug(v, pre, d.sexp, d.frac, vw_exp, vw_man);
-#endif
+int vf_f32_write_byval(vf_buf *buf, const float value)
+{
+    return _vf_stats_record(buf, -(s64)f32_exp_bias,
+        [&] { return _vf_f32_write_data(buf, vf_f32_data_get(value)); });
+}
 
-    return 0;
+int vf_f32_write(vf_buf *buf, const float *value)
+{
+    return vf_f32_write_byval(buf, *value);
 }
 
 /*
@@ -2199,3 +3296,3256 @@ int ieee754_f32_write_byval(vf_buf *buf, const float value)
     }
     return 0;
 }
+
+/*
+ * vf8 compressed float - arrays
+ *
+ * the array codecs encode into and decode from a pointer to the buffer
+ * data. writes reserve the worst-case record length so that the bounds
+ * check is hoisted out of the per-value path, and fall back to checked
+ * writes near the end of the buffer.
+ */
+
+enum : size_t { vf_array_block = 16 };
+
+/*
+ * convert header, exponent and mantissa to IEEE 754 (see vf_f64_read).
+ * out-of-line records are rounded with mode, truncating by default, and
+ * sub_exp is the subnormal exponent of the type that was written.
+ */
+template <vf_rounding mode = vf_round_zero>
+static VF_ALWAYS_INLINE double _vf_f64_unpack(u8 pre, s64 vr_exp, u64 vr_man,
+    s64 sub_exp = -(s64)f64_exp_bias)
+{
+    bool vf_inl = ! ((pre >> 7) & 1);
+    bool vf_sgn =    (pre >> 6) & 1;
+    int  vf_exp =    (pre >> 4) & 3;
+    int  vf_man =     pre       & 15;
+    u64 vp_man = 0;
+    s64 vp_exp = 0;
+
+    if (!vf_inl) {
+        return f64_from_bits(_vf_record_bits<u64,f64_mant_size,f64_exp_size,mode>(
+            vf_sgn, vf_exp, vr_exp, vr_man, sub_exp));
+    }
+    if (vf_exp == 0) {
+        if (vf_man > 0) {
+            size_t lz = clz((u64)vf_man);
+            vp_exp = f64_exp_bias + 59 - lz;
+            vp_man = ((u64)vf_man << lz << 1) >> (f64_exp_size + 1);
+        }
+    }
+    else if (vf_exp == 3) {
+        vp_exp = f64_exp_mask;
+        vp_man = (u64)vf_man << (f64_mant_size - 4);
+    }
+    else {
+        vp_exp = f64_exp_bias + vf_exp - 1;
+        vp_man = (u64)vf_man << (f64_mant_size - 4);
+    }
+
+    return f64_pack_float(f64_struct{vp_man, (u64)vp_exp, vf_sgn});
+}
+
+/*
+ * convert header, exponent and mantissa to IEEE 754 (see vf_f32_read).
+ * out-of-line records are rounded with mode, truncating by default, and
+ * sub_exp is the subnormal exponent of the type that was written.
+ */
+template <vf_rounding mode = vf_round_zero>
+static VF_ALWAYS_INLINE float _vf_f32_unpack(u8 pre, s64 vr_exp, u64 vr_man,
+    s64 sub_exp = -(s64)f32_exp_bias)
+{
+    bool vf_inl = ! ((pre >> 7) & 1);
+    bool vf_sgn =    (pre >> 6) & 1;
+    int  vf_exp =    (pre >> 4) & 3;
+    int  vf_man =     pre       & 15;
+    u32 vp_man = 0;
+    s32 vp_exp = 0;
+
+    if (!vf_inl) {
+        return f32_from_bits(_vf_record_bits<u32,f32_mant_size,f32_exp_size,mode>(
+            vf_sgn, vf_exp, vr_exp, vr_man, sub_exp));
+    }
+    if (vf_exp == 0) {
+        if (vf_man > 0) {
+            size_t lz = clz((u32)vf_man);
+            vp_exp = f32_exp_bias + 27 - (u32)lz;
+            vp_man = ((u32)vf_man << lz << 1) >> (f32_exp_size + 1);
+        }
+    }
+    else if (vf_exp == 3) {
+        vp_exp = f32_exp_mask;
+        vp_man = (u32)vf_man << (f32_mant_size - 4);
+    }
+    else {
+        vp_exp = f32_exp_bias + vf_exp - 1;
+        vp_man = (u32)vf_man << (f32_mant_size - 4);
+    }
+
+    return f32_pack_float(f32_struct{vp_man, (u32)vp_exp, vf_sgn});
+}
+
+/*
+ * decode the exponent and mantissa of an out-of-line record from the
+ * payload at p, which need not follow its header. returns the payload
+ * length or -1 if it is invalid or does not fit in avail.
+ */
+static VF_ALWAYS_INLINE int _vf_payload_decode(const char *p, size_t avail,
+    size_t pad, u8 pre, s64 *vr_exp, u64 *vr_man)
+{
+    size_t vf_exp = (pre >> 4) & 3, vf_man = pre & 15;
+
+    if (vf_man > 8 || vf_exp + vf_man > avail) return -1;
+
+    if (avail + pad >= 16) {
+        u64 lo, hi;
+        memcpy(&lo, p, sizeof(lo));
+        memcpy(&hi, p + 8, sizeof(hi));
+        _vf_payload_split(le64(lo), le64(hi), vf_exp, vf_man, vr_exp, vr_man);
+    } else {
+        u64 e = 0, m = 0;
+        memcpy(&e, p, vf_exp);
+        memcpy(&m, p + vf_exp, vf_man);
+        *vr_exp = vf_exp ? _sign_extend_s64((s64)le64(e), 64 - (vf_exp << 3)) : 0;
+        *vr_man = le64(m);
+    }
+
+    return (int)(vf_exp + vf_man);
+}
+
+/*
+ * decode the header, exponent and mantissa of one record from p,
+ * returning the record length or zero if the record is truncated
+ * or if the mantissa is wider than 64 bits. pad is the number of
+ * readable bytes following avail.
+ */
+static VF_ALWAYS_INLINE size_t _vf_record_decode(const char *p, size_t avail,
+    size_t pad, u8 *pre, s64 *vr_exp, u64 *vr_man)
+{
+    if (avail < 1) return 0;
+
+    *pre = (u8)p[0];
+    *vr_exp = 0;
+    *vr_man = 0;
+    if (!(*pre & 0x80)) return 1;
+
+    int len = _vf_payload_decode(p + 1, avail - 1, pad, *pre, vr_exp, vr_man);
+    return len < 0 ? 0 : 1 + (size_t)len;
+}
+
+static VF_ALWAYS_INLINE int _vf_f64_write_array_impl(vf_buf *buf,
+    const double *value, size_t count)
+{
+    u8 sign[vf_array_block];
+    s64 sexp[vf_array_block];
+    u64 frac[vf_array_block];
+
+    while (count > 0) {
+        size_t room = buf->data_offset < buf->data_size ?
+            (buf->data_size - buf->data_offset) / vf_f64_max_size : 0;
+        size_t n = count < vf_array_block ? count : vf_array_block;
+        n = n < room ? n : room;
+
+        /* near the end of the buffer, fall back to checked writes */
+        if (n == 0) {
+            if (vf_f64_write_byval(buf, *value) < 0) return -1;
+            value++;
+            count--;
+            continue;
+        }
+
+        /* split fields, vectorized on the SIMD kernels */
+        for (size_t i = 0; i < n; i++) {
+            u64 x = f64_to_bits(value[i]);
+            sign[i] = (u8)((x >> f64_sign_shift) & f64_sign_mask);
+            sexp[i] = (s64)((x >> f64_exp_shift) & f64_exp_mask) - (s64)f64_exp_bias;
+            frac[i] = ((x >> f64_mant_shift) & f64_mant_mask) << (f64_exp_size + 1);
+        }
+
+        char *p = buf->data + buf->data_offset;
+        for (size_t i = 0; i < n; i++) {
+            p += _vf_f64_encode(p, vf_f64_data { !!sign[i], sexp[i], frac[i] });
+        }
+        if (buf->stats) {
+            _vf_stats_add_range(buf->stats, buf->data + buf->data_offset, p, -(s64)f64_exp_bias);
+        }
+        buf->data_offset = p - buf->data;
+
+        value += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
+static VF_ALWAYS_INLINE int _vf_f32_write_array_impl(vf_buf *buf,
+    const float *value, size_t count)
+{
+    u8 sign[vf_array_block];
+    s32 sexp[vf_array_block];
+    u32 frac[vf_array_block];
+
+    while (count > 0) {
+        size_t room = buf->data_offset < buf->data_size ?
+            (buf->data_size - buf->data_offset) / vf_f32_max_size : 0;
+        size_t n = count < vf_array_block ? count : vf_array_block;
+        n = n < room ? n : room;
+
+        if (n == 0) {
+            if (vf_f32_write_byval(buf, *value) < 0) return -1;
+            value++;
+            count--;
+            continue;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            u32 x = f32_to_bits(value[i]);
+            sign[i] = (u8)((x >> f32_sign_shift) & f32_sign_mask);
+            sexp[i] = (s32)((x >> f32_exp_shift) & f32_exp_mask) - (s32)f32_exp_bias;
+            frac[i] = ((x >> f32_mant_shift) & f32_mant_mask) << (f32_exp_size + 1);
+        }
+
+        char *p = buf->data + buf->data_offset;
+        for (size_t i = 0; i < n; i++) {
+            p += _vf_f32_encode(p, vf_f32_data { !!sign[i], sexp[i], frac[i] });
+        }
+        if (buf->stats) {
+            _vf_stats_add_range(buf->stats, buf->data + buf->data_offset, p, -(s64)f32_exp_bias);
+        }
+        buf->data_offset = p - buf->data;
+
+        value += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
+static VF_ALWAYS_INLINE int _vf_f64_read_array_impl(vf_buf *buf,
+    double *value, size_t count)
+{
+    const char *p = buf->data + buf->data_offset;
+    const char *end = buf->data + buf->data_size;
+    u8 pre;
+    s64 vr_exp;
+    u64 vr_man;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t len = _vf_record_decode(p, end - p, buf->data_pad, &pre, &vr_exp, &vr_man);
+        if (len == 0) {
+            buf->data_offset = p - buf->data;
+            value[i] = 0;
+            return -1;
+        }
+        value[i] = _vf_f64_unpack(pre, vr_exp, vr_man);
+        p += len;
+    }
+    if (buf->stats) {
+        _vf_stats_add_range(buf->stats, buf->data + buf->data_offset, p, -(s64)f64_exp_bias);
+    }
+    buf->data_offset = p - buf->data;
+
+    return 0;
+}
+
+static VF_ALWAYS_INLINE int _vf_f32_read_array_impl(vf_buf *buf,
+    float *value, size_t count)
+{
+    const char *p = buf->data + buf->data_offset;
+    const char *end = buf->data + buf->data_size;
+    u8 pre;
+    s64 vr_exp;
+    u64 vr_man;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t len = _vf_record_decode(p, end - p, buf->data_pad, &pre, &vr_exp, &vr_man);
+        if (len == 0) {
+            buf->data_offset = p - buf->data;
+            value[i] = 0;
+            return -1;
+        }
+        value[i] = _vf_f32_unpack(pre, vr_exp, vr_man);
+        p += len;
+    }
+    if (buf->stats) {
+        _vf_stats_add_range(buf->stats, buf->data + buf->data_offset, p, -(s64)f32_exp_bias);
+    }
+    buf->data_offset = p - buf->data;
+
+    return 0;
+}
+
+static VF_ALWAYS_INLINE void _vf_upto_unpack(double *value, u8 pre, s64 vr_exp, u64 vr_man)
+{
+    *value = _vf_f64_unpack(pre, vr_exp, vr_man);
+}
+
+static VF_ALWAYS_INLINE void _vf_upto_unpack(float *value, u8 pre, s64 vr_exp, u64 vr_man)
+{
+    *value = _vf_f32_unpack(pre, vr_exp, vr_man);
+}
+
+/*
+ * decode at most *count records, stopping at the end of the buffer. the
+ * records before a truncated or invalid record are kept and counted.
+ */
+template <typename T>
+static VF_ALWAYS_INLINE int _vf_read_upto_impl(vf_buf *buf, T *value,
+    size_t *count, s64 sub_exp)
+{
+    const char *p = buf->data + buf->data_offset;
+    const char *end = buf->data + buf->data_size;
+    size_t i = 0;
+    int ret = 0;
+    u8 pre;
+    s64 vr_exp;
+    u64 vr_man;
+
+    for (; i < *count && p < end; i++) {
+        size_t len = _vf_record_decode(p, end - p, buf->data_pad, &pre, &vr_exp, &vr_man);
+        if (len == 0) {
+            ret = -1;
+            break;
+        }
+        _vf_upto_unpack(&value[i], pre, vr_exp, vr_man);
+        p += len;
+    }
+    if (buf->stats) {
+        _vf_stats_add_range(buf->stats, buf->data + buf->data_offset, p, sub_exp);
+    }
+    buf->data_offset = p - buf->data;
+    *count = i;
+
+    return ret;
+}
+
+template <vf_rounding mode>
+static VF_ALWAYS_INLINE void _vf_any_unpack(double *value, u8 pre, s64 vr_exp, u64 vr_man,
+    s64 sub_exp)
+{
+    *value = _vf_f64_unpack<mode>(pre, vr_exp, vr_man, sub_exp);
+}
+
+template <vf_rounding mode>
+static VF_ALWAYS_INLINE void _vf_any_unpack(float *value, u8 pre, s64 vr_exp, u64 vr_man,
+    s64 sub_exp)
+{
+    *value = _vf_f32_unpack<mode>(pre, vr_exp, vr_man, sub_exp);
+}
+
+/*
+ * decode records written from another precision. inline records are
+ * exact in both types, out-of-line records are rounded once from their
+ * full mantissa. sub_exp is the subnormal exponent of the written type.
+ */
+template <typename T, vf_rounding mode>
+static VF_ALWAYS_INLINE int _vf_read_from_any_impl(vf_buf *buf, T *value,
+    size_t count, s64 sub_exp)
+{
+    const char *p = buf->data + buf->data_offset;
+    const char *end = buf->data + buf->data_size;
+    u8 pre;
+    s64 vr_exp;
+    u64 vr_man;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t len = _vf_record_decode(p, end - p, buf->data_pad, &pre, &vr_exp, &vr_man);
+        if (len == 0) {
+            buf->data_offset = p - buf->data;
+            value[i] = 0;
+            return -1;
+        }
+        _vf_any_unpack<mode>(&value[i], pre, vr_exp, vr_man, sub_exp);
+        p += len;
+    }
+    if (buf->stats) {
+        _vf_stats_add_range(buf->stats, buf->data + buf->data_offset, p, sub_exp);
+    }
+    buf->data_offset = p - buf->data;
+
+    return 0;
+}
+
+/* instantiate the loop per mode so the rounding is resolved outside it */
+template <typename T>
+static VF_ALWAYS_INLINE int _vf_read_from_any_mode(vf_buf *buf, T *value,
+    size_t count, s64 sub_exp, vf_rounding mode)
+{
+    switch (mode) {
+    case vf_round_nearest: return _vf_read_from_any_impl<T,vf_round_nearest>(buf, value, count, sub_exp);
+    case vf_round_zero: return _vf_read_from_any_impl<T,vf_round_zero>(buf, value, count, sub_exp);
+    case vf_round_up: return _vf_read_from_any_impl<T,vf_round_up>(buf, value, count, sub_exp);
+    case vf_round_down: return _vf_read_from_any_impl<T,vf_round_down>(buf, value, count, sub_exp);
+    default: return -1;
+    }
+}
+
+/*
+ * LEB128 and VLU variable length integers
+ *
+ * LEB128 stores 7 bits per byte, least significant group first, with the
+ * high bit set on every byte except the last. signed values are sign
+ * extended from bit 6 of the last byte (SLEB128). 64-bit values take up
+ * to 10 bytes.
+ *
+ * VLU stores the record length in unary in the low bits of the first
+ * byte, so the length is known after one load. an n-byte record for
+ * n <= 8 has n-1 one bits and a zero bit followed by a 7n-bit value,
+ * little-endian. 0xff is followed by the full 8-byte value. signed values
+ * are two's complement, sign extended from the top bit of the value.
+ *
+ * - 0x0000000000000000 -> LEB 00, VLU 00
+ * - 0x000000000000007f -> LEB 7f, VLU fe
+ * - 0x0000000000000080 -> LEB 80 01, VLU 01 02
+ * - 0x0040000000000000 -> LEB 80 80 80 80 80 80 80 20,
+ *                         VLU 7f 00 00 00 00 00 00 40
+ */
+
+enum : size_t { vf_leb128_max_size = 10, vf_vlu_max_size = 9 };
+
+static VF_ALWAYS_INLINE size_t _int_u64_bits(u64 v)
+{
+    return v ? 64 - clz(v) : 1;
+}
+
+static VF_ALWAYS_INLINE size_t _int_s64_bits(s64 v)
+{
+    u64 t = (u64)(v ^ (v >> 63));
+    return t ? 65 - clz(t) : 1;
+}
+
+static VF_ALWAYS_INLINE size_t _leb128_length(size_t bits)
+{
+    return (bits + 6) / 7;
+}
+
+static VF_ALWAYS_INLINE size_t _vlu_length(size_t bits)
+{
+    return bits > 56 ? 9 : (bits + 6) / 7;
+}
+
+static VF_ALWAYS_INLINE void _int_le_store(char *p, u64 x, size_t len)
+{
+    x = le64(x);
+    memcpy(p, &x, len);
+}
+
+/* signed values shift arithmetically so the tenth byte is 0x00 or 0x7f */
+template <typename T>
+static VF_ALWAYS_INLINE size_t _leb128_encode(char *p, T v, size_t len)
+{
+    for (size_t i = 0; i < len - 1; i++) {
+        p[i] = (char)((v & 0x7f) | 0x80);
+        v >>= 7;
+    }
+    p[len - 1] = (char)(v & 0x7f);
+    return len;
+}
+
+static VF_ALWAYS_INLINE size_t _vlu_encode(char *p, u64 v, size_t len)
+{
+    if (len == 9) {
+        p[0] = (char)0xff;
+        _int_le_store(p + 1, v, 8);
+    } else {
+        _int_le_store(p, (v << len) | ((1ull << (len - 1)) - 1), len);
+    }
+    return len;
+}
+
+/*
+ * compact the 7-bit groups of up to 8 LEB128 bytes. the BMI2 kernel uses
+ * pext, inline asm because the intrinsic cannot inline into the shared
+ * kernel source without a target attribute.
+ */
+template <bool pext>
+static VF_ALWAYS_INLINE u64 _leb128_compact(u64 x)
+{
+#if VF_KERNEL_X86 && defined (__x86_64__)
+    if (pext) {
+        u64 r;
+        __asm__ ("pextq %2, %1, %0" : "=r" (r) : "r" (x), "r" (0x7f7f7f7f7f7f7f7full));
+        return r;
+    }
+#endif
+    x = (x & 0x007f007f007f007full) | ((x & 0x7f007f007f007f00ull) >> 1);
+    x = (x & 0x00003fff00003fffull) | ((x & 0x3fff00003fff0000ull) >> 2);
+    x = (x & 0x000000000fffffffull) | ((x & 0x0fffffff00000000ull) >> 4);
+    return x;
+}
+
+/*
+ * decode to the raw 7n-bit value, returns the length or 0 if truncated.
+ * with 8 readable bytes the terminator is found with one mask.
+ */
+template <bool pext>
+static VF_ALWAYS_INLINE size_t _leb128_decode(const char *p, size_t avail,
+    size_t pad, u64 *value)
+{
+    if (avail >= 1 && avail + pad >= 8) {
+        u64 x;
+        memcpy(&x, p, sizeof(x));
+        x = le64(x);
+        u64 stop = ~x & 0x8080808080808080ull;
+        if (stop) {
+            size_t len = (ctz(stop) >> 3) + 1;
+            if (len > avail) return 0;
+            *value = _leb128_compact<pext>(x & (~0ull >> (64 - (len << 3))));
+            return len;
+        }
+    }
+
+    u64 v = 0;
+    for (size_t i = 0; i < vf_leb128_max_size && i < avail; i++) {
+        u8 b = (u8)p[i];
+        v |= (u64)(b & 0x7f) << (7 * i);
+        if (!(b & 0x80)) {
+            *value = v;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/* 10-byte values must not carry bits past bit 63 */
+static VF_ALWAYS_INLINE int _leb128_u64_fixup(const char *p, size_t len, u64 *)
+{
+    return len == vf_leb128_max_size && (u8)p[9] > 1 ? -1 : 0;
+}
+
+static VF_ALWAYS_INLINE int _leb128_s64_fixup(const char *p, size_t len, u64 *value)
+{
+    if (len < vf_leb128_max_size) {
+        *value = (u64)_sign_extend_s64((s64)*value, 64 - 7 * len);
+        return 0;
+    }
+    return (u8)p[9] == 0 || (u8)p[9] == 0x7f ? 0 : -1;
+}
+
+static VF_ALWAYS_INLINE size_t _vlu_decode(const char *p, size_t avail,
+    size_t pad, u64 *value)
+{
+    u64 x = 0;
+    size_t len;
+
+    if (avail < 1) return 0;
+    len = ctz(~(u64)(u8)p[0]) + 1;
+    if (len > avail) return 0;
+
+    if (len == 9) {
+        memcpy(&x, p + 1, 8);
+        *value = le64(x);
+    } else if (avail + pad >= 8) {
+        memcpy(&x, p, 8);
+        x = le64(x);
+        *value = (len < 8 ? x & ~(~0ull << (len << 3)) : x) >> len;
+    } else {
+        memcpy(&x, p, len);
+        *value = le64(x) >> len;
+    }
+    return len;
+}
+
+static VF_ALWAYS_INLINE int _vlu_u64_fixup(const char *, size_t, u64 *)
+{
+    return 0;
+}
+
+static VF_ALWAYS_INLINE int _vlu_s64_fixup(const char *, size_t len, u64 *value)
+{
+    if (len < 9) {
+        *value = (u64)_sign_extend_s64((s64)*value, 64 - 7 * len);
+    }
+    return 0;
+}
+
+#define VF_VARINT_IMPL(codec,suffix,T,R,bits,decode)                                \
+int vf_##codec##_##suffix##_read(vf_buf *buf, T *value)                        \
+{                                                                              \
+    const char *p = buf->data + buf->data_offset;                              \
+    u64 v;                                                                     \
+    size_t len = decode(p, buf->data_size - buf->data_offset,                  \
+        buf->data_pad, &v);                                                    \
+    if (len == 0 || _##codec##_##suffix##_fixup(p, len, &v) < 0) {             \
+        *value = 0;                                                            \
+        return -1;                                                             \
+    }                                                                          \
+    buf->data_offset += len;                                                   \
+    *value = (T)v;                                                             \
+    return 0;                                                                  \
+}                                                                              \
+R vf_##codec##_##suffix##_read_byval(vf_buf *buf)                              \
+{                                                                              \
+    T v;                                                                       \
+    if (vf_##codec##_##suffix##_read(buf, &v) < 0) return R { 0, -1 };        \
+    return R { v, 0 };                                                         \
+}                                                                              \
+int vf_##codec##_##suffix##_write(vf_buf *buf, const T *value)                 \
+{                                                                              \
+    return vf_##codec##_##suffix##_write_byval(buf, *value);                   \
+}                                                                              \
+int vf_##codec##_##suffix##_write_byval(vf_buf *buf, const T value)            \
+{                                                                              \
+    size_t len = _##codec##_length(bits(value));                               \
+    if (vf_buf_check_capacity(buf, len)) return -1;                            \
+    buf->data_offset += _##codec##_encode(buf->data + buf->data_offset,        \
+        value, len);                                                           \
+    return 0;                                                                  \
+}
+
+VF_VARINT_IMPL(leb128,u64,u64,u64_result,_int_u64_bits,_leb128_decode<false>)
+VF_VARINT_IMPL(leb128,s64,s64,s64_result,_int_s64_bits,_leb128_decode<false>)
+VF_VARINT_IMPL(vlu,u64,u64,u64_result,_int_u64_bits,_vlu_decode)
+VF_VARINT_IMPL(vlu,s64,s64,s64_result,_int_s64_bits,_vlu_decode)
+
+static_assert((size_t)vf_f64_max_length == vf_f64_max_size, "vf_f64_max_length");
+static_assert((size_t)vf_f32_max_length == vf_f32_max_size, "vf_f32_max_length");
+static_assert((size_t)vf_vlu_max_length == vf_vlu_max_size, "vf_vlu_max_length");
+
+/* the caller has checked for the maximum record length */
+size_t vf_f64_write_unchecked(vf_buf *buf, const double value)
+{
+    return _vf_stats_record(buf, -(s64)f64_exp_bias, [&] {
+        size_t len = _vf_f64_encode(buf->data + buf->data_offset, vf_f64_data_get(value));
+        buf->data_offset += len;
+        return len;
+    });
+}
+
+size_t vf_f32_write_unchecked(vf_buf *buf, const float value)
+{
+    return _vf_stats_record(buf, -(s64)f32_exp_bias, [&] {
+        size_t len = _vf_f32_encode(buf->data + buf->data_offset, vf_f32_data_get(value));
+        buf->data_offset += len;
+        return len;
+    });
+}
+
+size_t vf_vlu_u64_write_unchecked(vf_buf *buf, const u64 value)
+{
+    size_t len = _vlu_encode(buf->data + buf->data_offset, value,
+        _vlu_length(_int_u64_bits(value)));
+    buf->data_offset += len;
+    return len;
+}
+
+size_t vf_vlu_s64_write_unchecked(vf_buf *buf, const s64 value)
+{
+    size_t len = _vlu_encode(buf->data + buf->data_offset, (u64)value,
+        _vlu_length(_int_s64_bits(value)));
+    buf->data_offset += len;
+    return len;
+}
+
+/*
+ * bulk varint decode
+ *
+ * in the style of Masked VByte, eight bytes are loaded per step and the
+ * terminator mask gives the record length. a load with eight single byte
+ * records is unpacked at once. records that cross the 8-byte window or the
+ * end of the buffer use the scalar decoder.
+ */
+template <bool pext, bool sign>
+static VF_ALWAYS_INLINE int _vf_leb128_read_array_impl(vf_buf *buf,
+    u64 *value, size_t count)
+{
+    const char *p = buf->data + buf->data_offset;
+    const char *end = buf->data + buf->data_size;
+    size_t i = 0, len;
+
+    while (i < count) {
+        size_t avail = end - p;
+        if (avail >= 8 && count - i >= 8) {
+            u64 x;
+            memcpy(&x, p, sizeof(x));
+            x = le64(x);
+            if (!(x & 0x8080808080808080ull)) {
+                for (size_t j = 0; j < 8; j++) {
+                    u64 b = (x >> (j << 3)) & 0x7f;
+                    value[i + j] = sign ? (u64)_sign_extend_s64((s64)b, 57) : b;
+                }
+                p += 8;
+                i += 8;
+                continue;
+            }
+        }
+        len = _leb128_decode<pext>(p, avail, buf->data_pad, &value[i]);
+        if (len == 0 || (sign ? _leb128_s64_fixup(p, len, &value[i]) :
+                                _leb128_u64_fixup(p, len, &value[i])) < 0) {
+            buf->data_offset = p - buf->data;
+            value[i] = 0;
+            return -1;
+        }
+        p += len;
+        i++;
+    }
+    buf->data_offset = p - buf->data;
+
+    return 0;
+}
+
+template <bool sign>
+static VF_ALWAYS_INLINE int _vf_vlu_read_array_impl(vf_buf *buf,
+    u64 *value, size_t count)
+{
+    const char *p = buf->data + buf->data_offset;
+    const char *end = buf->data + buf->data_size;
+    size_t i = 0, len;
+
+    while (i < count) {
+        size_t avail = end - p;
+        if (avail >= 8 && count - i >= 8) {
+            u64 x;
+            memcpy(&x, p, sizeof(x));
+            x = le64(x);
+            if (!(x & 0x0101010101010101ull)) {
+                for (size_t j = 0; j < 8; j++) {
+                    u64 b = (x >> ((j << 3) + 1)) & 0x7f;
+                    value[i + j] = sign ? (u64)_sign_extend_s64((s64)b, 57) : b;
+                }
+                p += 8;
+                i += 8;
+                continue;
+            }
+        }
+        if (avail >= 8) {
+            u64 x;
+            memcpy(&x, p, sizeof(x));
+            x = le64(x);
+            len = ctz(~x) + 1;
+            if (len <= 8) {
+                value[i] = (len < 8 ? x & ~(~0ull << (len << 3)) : x) >> len;
+                if (sign) _vlu_s64_fixup(p, len, &value[i]);
+                p += len;
+                i++;
+                continue;
+            }
+        }
+        len = _vlu_decode(p, avail, buf->data_pad, &value[i]);
+        if (len == 0) {
+            buf->data_offset = p - buf->data;
+            value[i] = 0;
+            return -1;
+        }
+        if (sign) _vlu_s64_fixup(p, len, &value[i]);
+        p += len;
+        i++;
+    }
+    buf->data_offset = p - buf->data;
+
+    return 0;
+}
+
+/*
+ * packed blocks
+ *
+ * vf_f64_write_packed stores blocks of up to 64 values as fixed width
+ * fields, so the reader unpacks them at constant stride. each block
+ * starts with a header:
+ *
+ *   u8 flags      0x80 plain, 0x40 patches, 0x20 sign field, 0x10 sign
+ *   u8 exp_width  0-11 bits of biased exponent offset
+ *   u8 man_width  0-52 leading fraction bits
+ *   u16 exp_base  biased exponent of offset zero, little-endian
+ *
+ * followed by a u64 patch bitmap when 0x40 is set, then the fields and
+ * then one vf128 record for each patched value. a field holds, from
+ * the least significant bit, the top man_width bits of the fraction,
+ * the exponent offset and the sign if 0x20 is set. values whose
+ * exponent or fraction does not fit are patched. a plain block has
+ * only the flags byte followed by a vf128 record for every value.
+ */
+
+enum : size_t {
+    vf_packed_block = 64,
+    vf_packed_header_size = 5,
+    vf_packed_max_bytes = vf_packed_block * 8
+};
+
+enum : u8 {
+    vf_packed_plain = 0x80,
+    vf_packed_patch = 0x40,
+    vf_packed_sign_field = 0x20,
+    vf_packed_sign = 0x10
+};
+
+struct vf_packed_layout
+{
+    u8 flags, exp_width, man_width;
+    u16 exp_base;
+    u64 patch;
+};
+
+/* estimated size in bits of a value written as a vf128 record */
+static size_t _vf_packed_record_bits(u64 x)
+{
+    u64 frac = x & f64_mant_mask;
+    size_t man = frac ? f64_mant_size - ctz(frac) : 0;
+    return (x << 1) == 0 ? 8 : 24 + ((man + 8) & ~(size_t)7);
+}
+
+/*
+ * two pass radix sort of 11-bit exponents, branch free unlike a
+ * comparison sort. the low 6 bits of each key hold the value index.
+ */
+static void _vf_packed_sort_exps(const u16 *exps, u32 *out, size_t n)
+{
+    u32 tmp[vf_packed_block];
+    u8 lo[64] = { 0 }, hi[32] = { 0 };
+
+    for (size_t i = 0; i < n; i++) {
+        lo[exps[i] & 63]++;
+        hi[exps[i] >> 6]++;
+    }
+    for (size_t i = 0, sum = 0; i < 64; i++) {
+        size_t c = lo[i];
+        lo[i] = (u8)sum;
+        sum += c;
+    }
+    for (size_t i = 0, sum = 0; i < 32; i++) {
+        size_t c = hi[i];
+        hi[i] = (u8)sum;
+        sum += c;
+    }
+    for (size_t i = 0; i < n; i++) tmp[lo[exps[i] & 63]++] = ((u32)exps[i] << 6) | (u32)i;
+    for (size_t i = 0; i < n; i++) out[hi[tmp[i] >> 12]++] = tmp[i];
+}
+
+/*
+ * choose the exponent window and then the mantissa width for the values
+ * it covers with the smallest estimated size, counting patched values at
+ * their vf128 size. the window for each width is the one holding the
+ * most exponents, found from the sorted exponents.
+ */
+static vf_packed_layout _vf_packed_plan(const u64 *x, size_t n)
+{
+    u16 exps[vf_packed_block];
+    u32 sorted[vf_packed_block];
+    u8 need[vf_packed_block];
+    size_t rec[vf_packed_block], sum[vf_packed_block + 1];
+    size_t hist[f64_mant_size + 1] = { 0 }, cnt[f64_mant_size + 1] = { 0 };
+    size_t plain = 8, max_need = 0, sign_bits = 0;
+    vf_packed_layout best = { vf_packed_plain, 0, 0, 0, 0 };
+
+    for (size_t i = 0; i < n; i++) {
+        u64 frac = x[i] & f64_mant_mask;
+        exps[i] = (u16)((x[i] >> f64_exp_shift) & f64_exp_mask);
+        need[i] = (u8)(frac ? f64_mant_size - ctz(frac) : 0);
+        rec[i] = _vf_packed_record_bits(x[i]);
+        plain += rec[i];
+        max_need = need[i] > max_need ? need[i] : max_need;
+        sign_bits |= (x[i] ^ x[0]) >> f64_sign_shift;
+    }
+
+    /* record bits of values outside a window from sums in exponent order */
+    _vf_packed_sort_exps(exps, sorted, n);
+    sum[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum[i + 1] = sum[i] + rec[sorted[i] & 63];
+        sorted[i] >>= 6;
+    }
+
+    /* exponent window, wider than the one covering all never helps */
+    u32 range = sorted[n - 1] - sorted[0];
+    int ew_all = range ? 32 - clz(range) : 0;
+    size_t exp_bits = ~(size_t)0, out_cnt = 0;
+    for (int ew = 0; ew <= ew_all; ew++) {
+        size_t span = (size_t)1 << ew, lo = 0, best_lo = 0, best_hi = 0;
+        for (size_t hi = 0; hi < n; hi++) {
+            while (sorted[hi] - sorted[lo] >= span) lo++;
+            if (hi - lo > best_hi - best_lo) {
+                best_lo = lo;
+                best_hi = hi;
+            }
+        }
+        u16 base = (u16)sorted[best_lo];
+        if (base + span > f64_exp_mask + 1) base = (u16)(f64_exp_mask + 1 - span);
+        size_t bits = n * ew + sum[n] - (sum[best_hi + 1] - sum[best_lo]);
+        if (bits < exp_bits) {
+            exp_bits = bits;
+            out_cnt = n - (best_hi - best_lo + 1);
+            best.exp_width = (u8)ew;
+            best.exp_base = base;
+        }
+    }
+
+    /* mantissa width for the covered values, longer ones are patched */
+    for (size_t i = 0; i < n; i++) {
+        bool in = (u32)(exps[i] - best.exp_base) < (1u << best.exp_width);
+        hist[need[i]] += in ? rec[i] : 0;
+        cnt[need[i]] += in;
+    }
+    size_t above_bits = 0, above_cnt = 0, man_bits = ~(size_t)0, man_cnt = 0;
+    for (size_t m = 1; m <= max_need; m++) {
+        above_bits += hist[m];
+        above_cnt += cnt[m];
+    }
+    for (size_t mw = 0; mw <= max_need; mw++) {
+        above_bits -= mw ? hist[mw] : 0;
+        above_cnt -= mw ? cnt[mw] : 0;
+        if (n * mw + above_bits < man_bits) {
+            man_bits = n * mw + above_bits;
+            man_cnt = above_cnt;
+            best.man_width = (u8)mw;
+        }
+    }
+
+    size_t bits = vf_packed_header_size * 8 + n * sign_bits + exp_bits + man_bits +
+        (out_cnt + man_cnt ? 64 : 0);
+    if (bits < plain) best.flags = 0;
+
+    if (best.flags & vf_packed_plain) return best;
+
+    best.flags = sign_bits ? (u8)vf_packed_sign_field :
+        (u8)((x[0] >> f64_sign_shift) ? vf_packed_sign : 0);
+    for (size_t i = 0; i < n; i++) {
+        if ((u32)(exps[i] - best.exp_base) >= (1u << best.exp_width) ||
+            need[i] > best.man_width) {
+            best.patch |= 1ull << i;
+        }
+    }
+    if (best.patch) best.flags |= vf_packed_patch;
+    return best;
+}
+
+static int _vf_packed_write_block(vf_buf *buf, const double *value, size_t n)
+{
+    u64 x[vf_packed_block];
+    for (size_t i = 0; i < n; i++) x[i] = f64_to_bits(value[i]);
+
+    vf_packed_layout l = _vf_packed_plan(x, n);
+    if (l.flags & vf_packed_plain) {
+        if (vf_buf_check_capacity(buf, 1)) return -1;
+        buf->data[buf->data_offset++] = (char)vf_packed_plain;
+        for (size_t i = 0; i < n; i++) {
+            if (vf_f64_write_byval(buf, value[i]) < 0) return -1;
+        }
+        return 0;
+    }
+
+    size_t sw = (l.flags & vf_packed_sign_field) ? 1 : 0;
+    size_t w = sw + l.exp_width + l.man_width;
+    size_t len = vf_packed_header_size + ((l.flags & vf_packed_patch) ? 8 : 0) + (n * w + 7) / 8;
+    if (vf_buf_check_capacity(buf, len)) return -1;
+
+    u8 *p = (u8*)buf->data + buf->data_offset;
+    p[0] = l.flags;
+    p[1] = l.exp_width;
+    p[2] = l.man_width;
+    p[3] = (u8)l.exp_base;
+    p[4] = (u8)(l.exp_base >> 8);
+    p += vf_packed_header_size;
+    if (l.flags & vf_packed_patch) {
+        u64 patch = le64(l.patch);
+        memcpy(p, &patch, 8);
+        p += 8;
+    }
+
+    /* fields are or'ed into a zeroed scratch block at constant stride */
+    u8 tmp[vf_packed_max_bytes + 16];
+    size_t bytes = (n * w + 7) / 8;
+    memset(tmp, 0, bytes + 9);
+    for (size_t i = 0; i < n; i++) {
+        u64 f = 0, lo;
+        if (!(l.patch >> i & 1)) {
+            u64 e = ((x[i] >> f64_exp_shift) & f64_exp_mask) - l.exp_base;
+            u64 m = l.man_width ? (x[i] & f64_mant_mask) >> (f64_mant_size - l.man_width) : 0;
+            f = m | (e << l.man_width) | ((x[i] >> f64_sign_shift) * sw << (l.man_width + l.exp_width));
+        }
+        size_t off = i * w, sh = off & 7;
+        memcpy(&lo, tmp + (off >> 3), 8);
+        lo = le64(le64(lo) | (f << sh));
+        memcpy(tmp + (off >> 3), &lo, 8);
+        if (sh) tmp[(off >> 3) + 8] |= (u8)(f >> (64 - sh));
+    }
+    memcpy(p, tmp, bytes);
+    buf->data_offset = (char*)p + bytes - buf->data;
+
+    for (u64 patch = l.patch; patch; patch &= patch - 1) {
+        if (vf_f64_write_byval(buf, value[ctz(patch)]) < 0) return -1;
+    }
+    return 0;
+}
+
+/*
+ * unpack n fields of width w at constant stride. fields of up to 57 bits
+ * are extracted from one unaligned 64-bit load, wider fields need one
+ * more byte. q must have 8 readable bytes past the last field.
+ */
+template <bool wide>
+static VF_ALWAYS_INLINE void _vf_packed_unpack(const u8 *q, double *value,
+    size_t n, const vf_packed_layout &l, size_t w)
+{
+    u64 mask = ~0ull >> (64 - w);
+    u64 sign = l.flags & vf_packed_sign ? 1ull << f64_sign_shift : 0;
+    size_t mw = l.man_width, ms = f64_mant_size - mw, es = mw + l.exp_width;
+    u64 mmask = (1ull << mw) - 1, emask = (1ull << l.exp_width) - 1;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t off = i * w, sh = off & 7;
+        u64 lo;
+        memcpy(&lo, q + (off >> 3), 8);
+        u64 f = le64(lo) >> sh;
+        if (wide && sh) f |= (u64)q[(off >> 3) + 8] << (64 - sh);
+        f &= mask;
+        u64 s = (l.flags & vf_packed_sign_field) ? (f >> es) << f64_sign_shift : sign;
+        u64 e = ((f >> mw) & emask) + l.exp_base;
+        u64 m = (f & mmask) << ms;
+        value[i] = f64_from_bits(s | (e << f64_exp_shift) | m);
+    }
+}
+
+static VF_ALWAYS_INLINE int _vf_f64_read_packed_impl(vf_buf *buf,
+    double *value, size_t count)
+{
+    while (count > 0) {
+        size_t n = count < vf_packed_block ? count : vf_packed_block;
+        if (vf_buf_check_capacity(buf, 1)) return -1;
+
+        const u8 *p = (const u8*)buf->data + buf->data_offset;
+        vf_packed_layout l = { p[0], 0, 0, 0, 0 };
+        if (l.flags & vf_packed_plain) {
+            buf->data_offset++;
+            for (size_t i = 0; i < n; i++) {
+                if (vf_f64_read(buf, &value[i]) < 0) return -1;
+            }
+            value += n;
+            count -= n;
+            continue;
+        }
+
+        if (vf_buf_check_capacity(buf, vf_packed_header_size)) return -1;
+        l.exp_width = p[1];
+        l.man_width = p[2];
+        l.exp_base = (u16)(p[3] | (p[4] << 8));
+        size_t hdr = vf_packed_header_size;
+        if (l.exp_width > f64_exp_size || l.man_width > f64_mant_size ||
+            l.exp_base + (1u << l.exp_width) > f64_exp_mask + 1) return -1;
+        if (l.flags & vf_packed_patch) {
+            if (vf_buf_check_capacity(buf, hdr + 8)) return -1;
+            memcpy(&l.patch, p + hdr, 8);
+            l.patch = le64(l.patch);
+            hdr += 8;
+            if (n < 64 && (l.patch >> n)) return -1;
+        }
+
+        size_t w = ((l.flags & vf_packed_sign_field) ? 1 : 0) + l.exp_width + l.man_width;
+        size_t len = hdr + (n * w + 7) / 8;
+        if (vf_buf_check_capacity(buf, len)) return -1;
+
+        /* copy the fields when the buffer padding does not cover the loads */
+        const u8 *q = p + hdr;
+        u8 tmp[vf_packed_max_bytes + 16];
+        if (buf->data_offset + len + 9 > buf->data_size + buf->data_pad) {
+            memset(tmp, 0, sizeof(tmp));
+            memcpy(tmp, q, len - hdr);
+            q = tmp;
+        }
+        if (w == 0) {
+            u64 x = (l.flags & vf_packed_sign ? 1ull << f64_sign_shift : 0) |
+                ((u64)l.exp_base << f64_exp_shift);
+            for (size_t i = 0; i < n; i++) value[i] = f64_from_bits(x);
+        } else if (w > 57) {
+            _vf_packed_unpack<true>(q, value, n, l, w);
+        } else {
+            _vf_packed_unpack<false>(q, value, n, l, w);
+        }
+        buf->data_offset += len;
+
+        for (u64 patch = l.patch; patch; patch &= patch - 1) {
+            if (vf_f64_read(buf, &value[ctz(patch)]) < 0) return -1;
+        }
+        value += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
+/*
+ * delta-of-delta blocks
+ *
+ * vf_f64_write_dod stores blocks of up to 1024 values as the second
+ * differences of scaled integers, for nearly monotonic series with a
+ * nearly constant stride such as timestamps. each block starts with a
+ * tag byte, the decimal scale d from 0 to 9 or 0x80 for a plain block.
+ * a scaled block holds integers k with value = k / 10^d as signed VLU:
+ * k[0], k[1] - k[0], and then (k[i] - k[i-1]) - (k[i-1] - k[i-2]). the
+ * writer picks the smallest scale at which every value of the block
+ * converts back exactly, with |k| below 2^53, and otherwise stores the
+ * block as plain vf128 records.
+ */
+
+enum : size_t {
+    vf_dod_block = 1024,
+    vf_dod_max_scale = 9
+};
+
+enum : u8 {
+    vf_dod_plain = 0x80
+};
+
+static VF_ALWAYS_INLINE s64 _f64_round_s64(double y)
+{
+    s64 k = (s64)y;
+    double r = y - (double)k;
+    return k + (r >= 0.5) - (r <= -0.5);
+}
+
+static VF_ALWAYS_INLINE double _vf_dod_value(s64 k, size_t scale)
+{
+    return scale ? (double)k / _f64_pow10[scale] : (double)k;
+}
+
+/* scale value[0..n) to integers, returns the scale or -1 if none is exact */
+static int _vf_dod_scale(const double *value, size_t n, s64 *k)
+{
+    for (size_t scale = 0; scale <= vf_dod_max_scale; scale++) {
+        size_t i = 0;
+        for (; i < n; i++) {
+            double y = value[i] * _f64_pow10[scale];
+            if (!(y > -0x1p53 && y < 0x1p53)) break;
+            k[i] = _f64_round_s64(y);
+            if (f64_to_bits(_vf_dod_value(k[i], scale)) != f64_to_bits(value[i])) break;
+        }
+        if (i == n) return (int)scale;
+    }
+    return -1;
+}
+
+static int _vf_dod_write_block(vf_buf *buf, const double *value, size_t n)
+{
+    s64 k[vf_dod_block];
+    u8 len[vf_dod_block];
+
+    int scale = _vf_dod_scale(value, n, k);
+    if (scale < 0) {
+        if (vf_buf_check_capacity(buf, 1)) return -1;
+        buf->data[buf->data_offset++] = (char)vf_dod_plain;
+        return vf_f64_write_array(buf, value, n);
+    }
+
+    /* k is replaced by the differences, the lengths are summed for one check */
+    size_t total = 1;
+    s64 prev = 0, delta = 0;
+    for (size_t i = 0; i < n; i++) {
+        s64 d = k[i] - prev;
+        prev = k[i];
+        k[i] = i == 0 ? d : d - delta;
+        delta = i == 0 ? 0 : d;
+        len[i] = (u8)_vlu_length(_int_s64_bits(k[i]));
+        total += len[i];
+    }
+    if (vf_buf_check_capacity(buf, total)) return -1;
+
+    char *p = buf->data + buf->data_offset;
+    *p++ = (char)scale;
+    for (size_t i = 0; i < n; i++) {
+        p += _vlu_encode(p, (u64)k[i], len[i]);
+    }
+    buf->data_offset = p - buf->data;
+
+    return 0;
+}
+
+static VF_ALWAYS_INLINE int _vf_f64_read_dod_impl(vf_buf *buf,
+    double *value, size_t count)
+{
+    u64 r[vf_dod_block];
+
+    while (count > 0) {
+        size_t n = count < vf_dod_block ? count : vf_dod_block;
+        if (vf_buf_check_capacity(buf, 1)) return -1;
+
+        u8 tag = (u8)buf->data[buf->data_offset++];
+        if (tag == vf_dod_plain) {
+            if (_vf_f64_read_array_impl(buf, value, n) < 0) return -1;
+        } else if (tag <= vf_dod_max_scale) {
+            if (_vf_vlu_read_array_impl<true>(buf, r, n) < 0) return -1;
+            /* wrapping sums, a corrupt block decodes to garbage, not UB */
+            u64 k = r[0], delta = 0;
+            value[0] = _vf_dod_value((s64)k, tag);
+            for (size_t i = 1; i < n; i++) {
+                delta += r[i];
+                k += delta;
+                value[i] = _vf_dod_value((s64)k, tag);
+            }
+        } else {
+            buf->data_offset--;
+            return -1;
+        }
+        value += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
+/*
+ * joint exponent tuples
+ *
+ * vf_c64 stores the real and imaginary parts of a complex double and
+ * vf_vec3 the components of a float3 with one exponent. each tuple
+ * starts with a tag byte, 0x80 for a plain tuple followed by a vf128
+ * record per component, or the magnitude width w from 0 to 64 bits.
+ * a joint tuple continues with the exponent L of the lowest set bit of
+ * any component as a signed VLU, then one field per component of w
+ * magnitude bits and a sign bit, packed least significant bit first
+ * and padded to a byte. a component is ±m × 2^L. the writer uses the
+ * joint form when it is shorter than the plain records, so components
+ * of similar magnitude share the exponent and diverging ones cost one
+ * tag byte. infinities and NaNs are always plain.
+ */
+
+enum : u8 {
+    vf_tuple_plain = 0x80
+};
+
+enum : s64 {
+    vf_tuple_max_exp = 4096
+};
+
+static u64 _vf_tuple_bits(double v) { return f64_to_bits(v); }
+static u64 _vf_tuple_bits(float v) { return f32_to_bits(v); }
+static double _vf_tuple_from_bits(double*, u64 x) { return f64_from_bits(x); }
+static float _vf_tuple_from_bits(float*, u64 x) { return f32_from_bits((u32)x); }
+static size_t _vf_tuple_record(char *p, double v) { return _vf_f64_encode(p, vf_f64_data_get(v)); }
+static size_t _vf_tuple_record(char *p, float v) { return _vf_f32_encode(p, vf_f32_data_get(v)); }
+
+template <typename F, size_t N>
+struct vf_tuple_size
+{
+    /* the joint form is only written when it is shorter than plain */
+    enum : size_t { max = 1 + N * (sizeof(F) == 8 ? vf_f64_max_size : vf_f32_max_size) };
+};
+
+static_assert((size_t)vf_c64_max_length == vf_tuple_size<double,2>::max, "vf_c64_max_length");
+static_assert((size_t)vf_vec3_max_length == vf_tuple_size<float,3>::max, "vf_vec3_max_length");
+
+/* append n bits of v, acc holds nacc < 64 pending bits, stores are 8 bytes */
+static VF_ALWAYS_INLINE void _vf_bits_put(char *&q, u64 &acc, size_t &nacc, u64 v, size_t n)
+{
+    acc |= v << nacc;
+    if (nacc + n >= 64) {
+        u64 x = le64(acc);
+        memcpy(q, &x, sizeof(x));
+        q += 8;
+        acc = nacc ? v >> (64 - nacc) : 0;
+        nacc = nacc + n - 64;
+    } else {
+        nacc += n;
+    }
+}
+
+/* n bits at bit offset b, q must have 9 readable bytes from b / 8 */
+static VF_ALWAYS_INLINE u64 _vf_bits_get(const u8 *q, size_t b, size_t n)
+{
+    size_t sh = b & 7;
+    u64 x;
+    memcpy(&x, q + (b >> 3), sizeof(x));
+    x = le64(x) >> sh;
+    if (sh + n > 64) x |= (u64)q[(b >> 3) + 8] << (64 - sh);
+    return n < 64 ? x & ~(~0ull << n) : x;
+}
+
+/* encode one tuple at p, which must have vf_tuple_size::max + 8 bytes */
+template <typename F, int mant_size, int exp_size, size_t N>
+static VF_ALWAYS_INLINE size_t _vf_tuple_encode(char *p, const F *v)
+{
+    const s64 bias = ((s64)1 << (exp_size - 1)) - 1, emax = ((s64)1 << exp_size) - 1;
+    u64 m[N], sign[N];
+    s64 e[N], lo = vf_tuple_max_exp, hi = -vf_tuple_max_exp;
+    bool joint = true;
+
+    for (size_t i = 0; i < N; i++) {
+        u64 x = _vf_tuple_bits(v[i]);
+        s64 ex = (s64)((x >> mant_size) & emax);
+        sign[i] = (x >> (mant_size + exp_size)) & 1;
+        m[i] = (x & ((1ull << mant_size) - 1)) | ((u64)(ex != 0) << mant_size);
+        joint &= ex != emax;
+        if (m[i] == 0) continue;
+        int tz = ctz(m[i]);
+        m[i] >>= tz;
+        e[i] = (ex ? ex : 1) - bias - mant_size + tz;
+        lo = e[i] < lo ? e[i] : lo;
+        hi = e[i] + 64 - clz(m[i]) > hi ? e[i] + 64 - clz(m[i]) : hi;
+    }
+    if (hi < lo) lo = hi = 0;
+    joint &= hi - lo <= 64;
+
+    char *q = p + 1;
+    p[0] = (char)vf_tuple_plain;
+    for (size_t i = 0; i < N; i++) {
+        q += _vf_tuple_record(q, v[i]);
+    }
+    size_t plain = q - p;
+
+    size_t w = (size_t)(hi - lo);
+    size_t elen = _vlu_length(_int_s64_bits(lo));
+    size_t len = 1 + elen + (N * (w + 1) + 7) / 8;
+    if (!joint || len >= plain) return plain;
+
+    p[0] = (char)w;
+    q = p + 1 + _vlu_encode(p + 1, (u64)lo, elen);
+    u64 acc = 0;
+    size_t nacc = 0;
+    for (size_t i = 0; i < N; i++) {
+        _vf_bits_put(q, acc, nacc, m[i] ? m[i] << (e[i] - lo) : 0, w);
+        _vf_bits_put(q, acc, nacc, sign[i], 1);
+    }
+    acc = le64(acc);
+    memcpy(q, &acc, sizeof(acc));
+    return len;
+}
+
+/* decode one tuple, returns the length or zero if truncated or invalid */
+template <typename F, int mant_size, int exp_size, size_t N>
+static VF_ALWAYS_INLINE size_t _vf_tuple_decode(const char *p, size_t avail,
+    size_t pad, F *v)
+{
+    size_t off = 1, len;
+
+    if (avail < 1) return 0;
+    u8 tag = (u8)p[0];
+    if (tag == vf_tuple_plain) {
+        for (size_t i = 0; i < N; i++) {
+            u8 pre;
+            s64 vr_exp;
+            u64 vr_man;
+            len = _vf_record_decode(p + off, avail - off, pad, &pre, &vr_exp, &vr_man);
+            if (len == 0) return 0;
+            _vf_upto_unpack(&v[i], pre, vr_exp, vr_man);
+            off += len;
+        }
+        return off;
+    }
+
+    size_t w = tag;
+    u64 lo;
+    if (w > 64) return 0;
+    len = _vlu_decode(p + off, avail - off, pad, &lo);
+    if (len == 0) return 0;
+    _vlu_s64_fixup(p + off, len, &lo);
+    off += len;
+    size_t bytes = (N * (w + 1) + 7) / 8;
+    if ((s64)lo < -vf_tuple_max_exp || (s64)lo > vf_tuple_max_exp || off + bytes > avail) {
+        return 0;
+    }
+
+    /* copy the fields when the buffer padding does not cover the loads */
+    const u8 *q = (const u8*)p + off;
+    u8 tmp[(N * 65 + 7) / 8 + 9];
+    if (avail + pad - off < bytes + 9) {
+        memset(tmp, 0, sizeof(tmp));
+        memcpy(tmp, q, bytes);
+        q = tmp;
+    }
+    for (size_t i = 0; i < N; i++) {
+        u64 x = w ? _vf_bits_get(q, i * (w + 1), w) : 0;
+        u64 s = _vf_bits_get(q, i * (w + 1) + w, 1);
+        v[i] = _vf_tuple_from_bits(v, _ieee_from_parts<u64,mant_size,exp_size>(x, (s64)lo)
+            | (s << (mant_size + exp_size)));
+    }
+    return off + bytes;
+}
+
+template <typename F, int mant_size, int exp_size, size_t N>
+static VF_ALWAYS_INLINE int _vf_tuple_write_impl(vf_buf *buf, const F *value, size_t count)
+{
+    const size_t max = vf_tuple_size<F,N>::max;
+    char tmp[max + 8];
+
+    for (size_t i = 0; i < count; i++, value += N) {
+        if (vf_buf_check_capacity(buf, max + 8) == 0) {
+            buf->data_offset += _vf_tuple_encode<F,mant_size,exp_size,N>(
+                buf->data + buf->data_offset, value);
+            continue;
+        }
+        /* near the end of the buffer, encode aside and check the length */
+        size_t len = _vf_tuple_encode<F,mant_size,exp_size,N>(tmp, value);
+        if (vf_buf_check_capacity(buf, len)) return -1;
+        memcpy(buf->data + buf->data_offset, tmp, len);
+        buf->data_offset += len;
+    }
+
+    return 0;
+}
+
+template <typename F, int mant_size, int exp_size, size_t N>
+static VF_ALWAYS_INLINE int _vf_tuple_read_impl(vf_buf *buf, F *value, size_t count)
+{
+    const char *p = buf->data + buf->data_offset;
+    const char *end = buf->data + buf->data_size;
+
+    for (size_t i = 0; i < count; i++, value += N) {
+        size_t len = _vf_tuple_decode<F,mant_size,exp_size,N>(p, end - p, buf->data_pad, value);
+        if (len == 0) {
+            buf->data_offset = p - buf->data;
+            for (size_t j = 0; j < N; j++) value[j] = 0;
+            return -1;
+        }
+        p += len;
+    }
+    buf->data_offset = p - buf->data;
+
+    return 0;
+}
+
+/*
+ * fixed-dimension vectors
+ *
+ * vf_f32_write_vec stores each vector of dim floats behind a three byte
+ * header: the largest biased exponent E of the vector, the width k of
+ * the exponent deltas and the width m of the stored mantissas. one field
+ * of 1 + k + m bits per element follows, packed least significant bit
+ * first and padded to a byte, holding the top m bits of the mantissa,
+ * then the delta d and the sign. d is E + 1 - e for an element with
+ * biased exponent e, and 0 for zeros and subnormals, which have e = 0.
+ * m is the widest mantissa of the vector without its trailing zeros, so
+ * values that came from a narrower type cost only the bits they have.
+ * the fields hold the IEEE bits, infinities and NaNs included, and a
+ * vector decodes bit exactly. with bits below 24 the writer first rounds
+ * each value to bits significant bits, to nearest even, clamping values
+ * that would round past the largest finite float.
+ */
+
+enum : u32 {
+    vf_vec_header = 3,
+    vf_vec_max_delta_bits = 8
+};
+
+static VF_ALWAYS_INLINE u32 _vf_vec_round(float v, int drop)
+{
+    u32 x = f32_to_bits(v);
+    if (drop == 0 || ((x >> f32_exp_shift) & f32_exp_mask) == f32_exp_mask) return x;
+    u32 s = x & (1u << f32_sign_shift), a = x ^ s;
+    u32 mask = (1u << drop) - 1;
+    a += (1u << (drop - 1)) - 1 + ((a >> drop) & 1);
+    /* a carry out of the largest binade would make the value infinite,
+     * clamp to the largest finite value with bits significant bits. */
+    if (a >= f32_exp_mask << f32_exp_shift) a = (f32_exp_mask << f32_exp_shift) - 1;
+    return s | (a & ~mask);
+}
+
+static VF_ALWAYS_INLINE u32 _vf_vec_width(u32 x)
+{
+    return x ? 32 - clz(x) : 0;
+}
+
+/* the field of an element, its biased exponent is e */
+static VF_ALWAYS_INLINE u32 _vf_vec_field(vf_f32_data d, u32 e, u32 E, u32 k, u32 m)
+{
+    u32 man = m ? d.frac >> (32 - m) : 0;
+    u32 delta = e ? E + 1 - e : 0;
+    return man | delta << m | (u32)d.sign << (m + k);
+}
+
+static VF_ALWAYS_INLINE int _vf_f32_write_vec_impl(vf_buf *buf, const float *value,
+    size_t dim, size_t count, int bits)
+{
+    if (dim == 0 || bits < 1 || bits > (int)f32_mant_size + 1) return -1;
+    int drop = f32_mant_size + 1 - bits;
+
+    for (size_t j = 0; j < count; j++, value += dim) {
+        u32 E = 0, emin = f32_exp_mask, frac = 0;
+        for (size_t i = 0; i < dim; i++) {
+            vf_f32_data d = vf_f32_data_get(f32_from_bits(_vf_vec_round(value[i], drop)));
+            u32 e = (u32)(d.sexp + f32_exp_bias);
+            E = e > E ? e : E;
+            emin = e && e < emin ? e : emin;
+            frac |= d.frac;
+        }
+        u32 k = E ? _vf_vec_width(E + 1 - emin) : 0;
+        u32 m = frac ? 32 - ctz(frac) : 0;
+        size_t w = 1 + k + m, bytes = (dim * w + 7) / 8;
+        if (vf_buf_check_capacity(buf, vf_vec_header + bytes)) return -1;
+
+        char *q = buf->data + buf->data_offset;
+        q[0] = (char)E;
+        q[1] = (char)k;
+        q[2] = (char)m;
+        q += vf_vec_header;
+        /* only whole words are stored in the loop, the tail is copied */
+        u64 acc = 0;
+        size_t nacc = 0;
+        for (size_t i = 0; i < dim; i++) {
+            vf_f32_data d = vf_f32_data_get(f32_from_bits(_vf_vec_round(value[i], drop)));
+            u32 e = (u32)(d.sexp + f32_exp_bias);
+            _vf_bits_put(q, acc, nacc, _vf_vec_field(d, e, E, k, m), w);
+        }
+        acc = le64(acc);
+        memcpy(q, &acc, (nacc + 7) / 8);
+        buf->data_offset += vf_vec_header + bytes;
+    }
+
+    return 0;
+}
+
+/* decode elements [i, n) of a vector from fields at q, returns nonzero if invalid */
+static VF_ALWAYS_INLINE u32 _vf_vec_unpack(const u8 *q, float *value, size_t i, size_t n,
+    size_t base, u32 E, u32 k, u32 m)
+{
+    u32 w = 1 + k + m, fmask = (u32)((1ull << w) - 1), bad = 0;
+
+    for (; i < n; i++) {
+        size_t b = i * w - base;
+        u64 x;
+        memcpy(&x, q + (b >> 3), sizeof(x));
+        u32 f = (u32)(le64(x) >> (b & 7)) & fmask;
+        u32 man = (f & ((1u << m) - 1)) << (f32_mant_size - m);
+        u32 delta = (f >> m) & ((1u << k) - 1);
+        u32 e = delta ? E + 1 - delta : 0;
+        bad |= delta > E;
+        value[i] = f32_from_bits((f >> (m + k)) << f32_sign_shift | e << f32_exp_shift | man);
+    }
+    return bad;
+}
+
+static VF_ALWAYS_INLINE int _vf_f32_read_vec_impl(vf_buf *buf, float *value,
+    size_t dim, size_t count)
+{
+    if (dim == 0) return -1;
+
+    for (size_t j = 0; j < count; j++, value += dim) {
+        if (vf_buf_check_capacity(buf, vf_vec_header)) return -1;
+        const u8 *p = (const u8*)buf->data + buf->data_offset;
+        u32 E = p[0], k = p[1], m = p[2];
+        if (k > vf_vec_max_delta_bits || m > f32_mant_size) return -1;
+        size_t w = 1 + k + m, bytes = (dim * w + 7) / 8;
+        if (vf_buf_check_capacity(buf, vf_vec_header + bytes)) return -1;
+
+        /* fields that an 8 byte load would read past the padding are copied */
+        const u8 *q = p + vf_vec_header;
+        size_t end = buf->data_size + buf->data_pad - (buf->data_offset + vf_vec_header);
+        size_t n = end >= 8 ? ((end - 8) * 8 + 1) / w : 0;
+        n = n < dim ? n : dim;
+        u32 bad = _vf_vec_unpack(q, value, 0, n, 0, E, k, m);
+        if (n < dim) {
+            u8 tmp[32] = {};
+            size_t from = n * w / 8;
+            memcpy(tmp, q + from, bytes - from);
+            bad |= _vf_vec_unpack(tmp, value, n, dim, from * 8, E, k, m);
+        }
+        if (bad) return -1;
+        buf->data_offset += vf_vec_header + bytes;
+    }
+
+    return 0;
+}
+
+/*
+ * shared exponent blocks
+ *
+ * vf_f32_write_mx and vf_f64_write_mx quantize blocks of values to a
+ * shared exponent and per-element sign and magnitude, like the OCP MX
+ * formats. the stream starts with two bytes, the block size and the
+ * magnitude width. each block starts with its scale 2^E as a vf128 f64
+ * record, where E is the exponent of the largest magnitude, followed by
+ * one field per element holding the magnitude q in the low bits and the
+ * sign above it, packed least significant bit first. an element decodes
+ * to q * 2^(E + 1 - bits). a zero scale marks a block of zeros without
+ * fields and a NaN scale a block with infinities or NaNs, stored as
+ * plain vf128 records.
+ */
+
+enum : size_t {
+    vf_mx_max_block = 64,
+    vf_mx_max_bits = 31
+};
+
+static vf_f32_data _vf_mx_data_get(float value) { return vf_f32_data_get(value); }
+static vf_f64_data _vf_mx_data_get(double value) { return vf_f64_data_get(value); }
+
+static int _vf_mx_write_record(vf_buf *buf, float value) { return vf_f32_write_byval(buf, value); }
+static int _vf_mx_write_record(vf_buf *buf, double value) { return vf_f64_write_byval(buf, value); }
+static int _vf_mx_read_record(vf_buf *buf, float *value) { return vf_f32_read(buf, value); }
+static int _vf_mx_read_record(vf_buf *buf, double *value) { return vf_f64_read(buf, value); }
+
+template <typename F, int mant_size, int exp_size>
+static VF_ALWAYS_INLINE int _vf_mx_write_impl(vf_buf *buf, const F *value,
+    size_t count, size_t block, int bits)
+{
+    enum : int { bias = (1 << (exp_size - 1)) - 1 };
+    u64 m[vf_mx_max_block];
+    s32 ex[vf_mx_max_block];
+    u8 sign[vf_mx_max_block], tmp[vf_mx_max_block * 4 + 16];
+
+    if (block == 0 || block > vf_mx_max_block || bits < 1 ||
+        bits > (mant_size + 1 < (int)vf_mx_max_bits ? mant_size + 1 : (int)vf_mx_max_bits) ||
+        vf_buf_check_capacity(buf, 2)) return -1;
+    buf->data[buf->data_offset++] = (char)block;
+    buf->data[buf->data_offset++] = (char)bits;
+
+    size_t w = bits + 1;
+    u64 qmax = (1ull << bits) - 1;
+    while (count > 0) {
+        size_t n = count < block ? count : block;
+        s32 emax = -bias;
+        bool special = false, nonzero = false;
+
+        /* split fields, subnormals take the minimum normal exponent */
+        for (size_t i = 0; i < n; i++) {
+            auto d = _vf_mx_data_get(value[i]);
+            bool sub = d.sexp == -bias;
+            sign[i] = d.sign;
+            ex[i] = sub ? 1 - bias : (s32)d.sexp;
+            m[i] = ((u64)d.frac >> (exp_size + 1)) | (sub ? 0 : 1ull << mant_size);
+            special |= d.sexp == bias + 1;
+            nonzero |= m[i] != 0;
+            emax = m[i] && ex[i] > emax ? ex[i] : emax;
+        }
+
+        if (special || !nonzero) {
+            if (vf_f64_write_byval(buf, special ? _f64_nan() : 0.0) < 0) return -1;
+            for (size_t i = 0; special && i < n; i++) {
+                if (_vf_mx_write_record(buf, value[i]) < 0) return -1;
+            }
+            value += n;
+            count -= n;
+            continue;
+        }
+
+        /* round magnitudes to nearest even at the block scale */
+        for (size_t i = 0; i < n; i++) {
+            s32 s = mant_size + 1 + emax - bits - ex[i];
+            u64 q = s == 0 ? m[i] : s >= 60 ? 0 :
+                (m[i] + (1ull << (s - 1)) - 1 + ((m[i] >> s) & 1)) >> s;
+            m[i] = (q < qmax ? q : qmax) | ((u64)sign[i] << bits);
+        }
+
+        size_t bytes = (n * w + 7) / 8;
+        if (vf_f64_write_byval(buf, f64_from_bits((u64)(emax + f64_exp_bias) << f64_exp_shift)) < 0 ||
+            vf_buf_check_capacity(buf, bytes)) return -1;
+        /* fields are at most 32 bits, flush the accumulator 32 bits at a time */
+        u64 acc = 0;
+        size_t acc_bits = 0, o = 0;
+        for (size_t i = 0; i < n; i++) {
+            acc |= m[i] << acc_bits;
+            acc_bits += w;
+            if (acc_bits >= 32) {
+                u32 lo = le32((u32)acc);
+                memcpy(tmp + o, &lo, 4);
+                o += 4;
+                acc >>= 32;
+                acc_bits -= 32;
+            }
+        }
+        u64 rest = le64(acc);
+        memcpy(tmp + o, &rest, 8);
+        memcpy(buf->data + buf->data_offset, tmp, bytes);
+        buf->data_offset += bytes;
+
+        value += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
+template <typename F>
+static VF_ALWAYS_INLINE int _vf_mx_read_impl(vf_buf *buf, F *value, size_t count)
+{
+    if (vf_buf_check_capacity(buf, 2)) return -1;
+    size_t block = (u8)buf->data[buf->data_offset];
+    int bits = (u8)buf->data[buf->data_offset + 1];
+    if (block == 0 || block > vf_mx_max_block || bits < 1 || bits > (int)vf_mx_max_bits) return -1;
+    buf->data_offset += 2;
+
+    size_t w = bits + 1;
+    u64 mask = (1ull << w) - 1, qmask = (1ull << bits) - 1;
+    u8 tmp[vf_mx_max_block * 4 + 16];
+    while (count > 0) {
+        size_t n = count < block ? count : block;
+        double scale;
+
+        if (vf_f64_read(buf, &scale) < 0) return -1;
+        if (scale != scale || scale == 0.0) {
+            for (size_t i = 0; i < n; i++) {
+                if (scale == 0.0) {
+                    value[i] = 0;
+                } else if (_vf_mx_read_record(buf, &value[i]) < 0) {
+                    return -1;
+                }
+            }
+            value += n;
+            count -= n;
+            continue;
+        }
+
+        /* the scale must be a positive normal power of two */
+        u64 sb = f64_to_bits(scale);
+        s64 e = (s64)(sb >> f64_exp_shift) - (s64)f64_exp_bias;
+        if ((sb & f64_mant_mask) || (sb >> f64_sign_shift) || e < 1 - (s64)f64_exp_bias ||
+            e > (s64)f64_exp_bias) return -1;
+
+        size_t bytes = (n * w + 7) / 8;
+        if (vf_buf_check_capacity(buf, bytes)) return -1;
+        const u8 *q = (const u8*)buf->data + buf->data_offset;
+        if (buf->data_offset + bytes + 8 > buf->data_size + buf->data_pad) {
+            memset(tmp, 0, sizeof(tmp));
+            memcpy(tmp, q, bytes);
+            q = tmp;
+        }
+
+        /* the step 2^(E + 1 - bits) may be subnormal, products are exact */
+        s64 k = e + 1 - bits;
+        double step = f64_from_bits(k > -(s64)f64_exp_bias ?
+            (u64)(k + f64_exp_bias) << f64_exp_shift :
+            1ull << (k + f64_exp_bias - 1 + f64_mant_size));
+        for (size_t i = 0; i < n; i++) {
+            size_t off = i * w;
+            u64 lo;
+            memcpy(&lo, q + (off >> 3), 8);
+            u64 f = (le64(lo) >> (off & 7)) & mask;
+            double v = (double)(f & qmask) * step;
+            value[i] = (F)((f >> bits) ? -v : v);
+        }
+        buf->data_offset += bytes;
+
+        value += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
+/*
+ * entropy coded headers
+ *
+ * vf_f64_write_coded stores blocks of up to 4096 records with the header
+ * bytes gathered into a Huffman coded stream ahead of the payloads. the
+ * headers alternate between two bitstreams so the reader decodes two
+ * independent symbols per step. a block is:
+ *
+ *   u8 mode            0 plain records, 1 coded
+ *   u8 nsym - 1        number of header symbols used
+ *   u8 sym, u8 len     nsym code lengths in canonical order
+ *   u32 len0, len1     bitstream lengths in bytes, little-endian
+ *   stream 0, 1        codes of the even and odd headers
+ *   payloads           exponent and mantissa bytes of each record
+ *
+ * where all but the mode byte are only present in coded blocks. codes
+ * are canonical, at most 11 bits, and stored bit-reversed so they are
+ * read least significant bit first with one table lookup. a block with
+ * a single header symbol has a zero code length and empty streams.
+ */
+
+enum : size_t {
+    vf_coded_block = 4096,
+    vf_coded_max_len = 11,
+    vf_coded_table_size = 1 << vf_coded_max_len,
+    vf_coded_fixed_size = 10
+};
+
+/* Huffman code lengths, halving the counts until they fit the limit */
+static size_t _vf_coded_lengths(const u32 *freq, u8 *len, u8 *order)
+{
+    u32 count[256], weight[512];
+    u16 parent[512];
+    u8 depth[512];
+    size_t n = 0;
+
+    for (size_t s = 0; s < 256; s++) {
+        len[s] = 0;
+        count[s] = freq[s];
+        if (freq[s]) order[n++] = (u8)s;
+    }
+    if (n <= 1) return n;
+
+    for (;;) {
+        /* leaves sorted by count, merged nodes come out in order */
+        std::sort(order, order + n, [&](u8 a, u8 b) {
+            return count[a] < count[b] || (count[a] == count[b] && a < b);
+        });
+        for (size_t i = 0; i < n; i++) weight[i] = count[order[i]];
+        size_t leaf = 0, node = n, next = n;
+        for (size_t k = 0; k < n - 1; k++) {
+            size_t pick[2];
+            for (size_t j = 0; j < 2; j++) {
+                bool use_leaf = leaf < n && (node == next || weight[leaf] <= weight[node]);
+                pick[j] = use_leaf ? leaf++ : node++;
+            }
+            weight[next] = weight[pick[0]] + weight[pick[1]];
+            parent[pick[0]] = parent[pick[1]] = (u16)next++;
+        }
+        size_t max_len = 0;
+        depth[next - 1] = 0;
+        for (size_t i = next - 1; i-- > 0; ) {
+            depth[i] = (u8)(depth[parent[i]] + 1);
+        }
+        for (size_t i = 0; i < n; i++) {
+            len[order[i]] = depth[i];
+            max_len = depth[i] > max_len ? depth[i] : max_len;
+        }
+        if (max_len <= vf_coded_max_len) break;
+        for (size_t i = 0; i < n; i++) {
+            count[order[i]] = (count[order[i]] >> 1) | 1;
+        }
+    }
+
+    /* canonical order, by length then symbol */
+    std::sort(order, order + n, [&](u8 a, u8 b) {
+        return len[a] < len[b] || (len[a] == len[b] && a < b);
+    });
+    return n;
+}
+
+/* canonical codes in canonical order, bit-reversed for LSB first reads */
+static void _vf_coded_codes(const u8 *order, const u8 *len, size_t n, u16 *code)
+{
+    u32 c = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0) c = (c + 1) << (len[order[i]] - len[order[i - 1]]);
+        u32 r = 0;
+        for (size_t b = 0; b < len[order[i]]; b++) r |= ((c >> b) & 1) << (len[order[i]] - 1 - b);
+        code[order[i]] = (u16)r;
+    }
+}
+
+static int _vf_coded_write_block(vf_buf *buf, const double *value, size_t n, char *scratch)
+{
+    vf_buf rec = { scratch, 0, vf_coded_block * vf_f64_max_size, 0, buf->stats };
+    u32 freq[256] = { 0 };
+    u8 len[256], order[256];
+    u16 code[256];
+
+    if (vf_f64_write_array(&rec, value, n) < 0) return -1;
+
+    /* header frequencies and payload size */
+    size_t payload = 0;
+    for (size_t o = 0; o < rec.data_offset; ) {
+        u8 pre = (u8)scratch[o];
+        size_t plen = (pre & 0x80) ? ((pre >> 4) & 3) + (pre & 15) : 0;
+        freq[pre]++;
+        payload += plen;
+        o += 1 + plen;
+    }
+    size_t nsym = _vf_coded_lengths(freq, len, order);
+    _vf_coded_codes(order, len, nsym, code);
+
+    size_t bits[2] = { 0, 0 };
+    for (size_t o = 0, i = 0; o < rec.data_offset; i++) {
+        u8 pre = (u8)scratch[o];
+        bits[i & 1] += len[pre];
+        o += 1 + ((pre & 0x80) ? ((pre >> 4) & 3) + (pre & 15) : 0);
+    }
+    size_t s0 = (bits[0] + 7) / 8, s1 = (bits[1] + 7) / 8;
+    size_t size = vf_coded_fixed_size + 2 * nsym + s0 + s1 + payload;
+
+    if (size >= 1 + rec.data_offset) {
+        if (vf_buf_check_capacity(buf, 1 + rec.data_offset)) return -1;
+        buf->data[buf->data_offset] = 0;
+        memcpy(buf->data + buf->data_offset + 1, scratch, rec.data_offset);
+        buf->data_offset += 1 + rec.data_offset;
+        return 0;
+    }
+    if (vf_buf_check_capacity(buf, size)) return -1;
+
+    u8 *p = (u8*)buf->data + buf->data_offset;
+    *p++ = 1;
+    *p++ = (u8)(nsym - 1);
+    for (size_t i = 0; i < nsym; i++) {
+        *p++ = order[i];
+        *p++ = len[order[i]];
+    }
+    u32 l0 = le32((u32)s0), l1 = le32((u32)s1);
+    memcpy(p, &l0, 4);
+    memcpy(p + 4, &l1, 4);
+    p += 8;
+
+    /* both streams are written in one pass through the headers */
+    u8 *out[2] = { p, p + s0 };
+    u64 acc[2] = { 0, 0 };
+    size_t acc_bits[2] = { 0, 0 };
+    u8 *q = p + s0 + s1;
+    for (size_t o = 0, i = 0; o < rec.data_offset; i++) {
+        u8 pre = (u8)scratch[o];
+        size_t plen = (pre & 0x80) ? ((pre >> 4) & 3) + (pre & 15) : 0, k = i & 1;
+        acc[k] |= (u64)code[pre] << acc_bits[k];
+        acc_bits[k] += len[pre];
+        while (acc_bits[k] >= 8) {
+            *out[k]++ = (u8)acc[k];
+            acc[k] >>= 8;
+            acc_bits[k] -= 8;
+        }
+        memcpy(q, scratch + o + 1, plen);
+        q += plen;
+        o += 1 + plen;
+    }
+    for (size_t k = 0; k < 2; k++) {
+        if (acc_bits[k]) *out[k]++ = (u8)acc[k];
+    }
+    buf->data_offset = (char*)q - buf->data;
+
+    return 0;
+}
+
+struct vf_coded_reader
+{
+    const u8 *p, *end;
+    u64 bits;
+    size_t avail, used;
+};
+
+/* top up to at least 56 bits, past the readable end the bits are zero */
+static VF_ALWAYS_INLINE void _vf_coded_refill(vf_coded_reader &r)
+{
+    if (r.p + 8 <= r.end) {
+        u64 w;
+        memcpy(&w, r.p, 8);
+        r.bits |= le64(w) << r.avail;
+        r.p += (63 - r.avail) >> 3;
+        r.avail |= 56;
+    } else {
+        while (r.avail <= 56 && r.p < r.end) {
+            r.bits |= (u64)*r.p++ << r.avail;
+            r.avail += 8;
+        }
+        if (r.avail < 56) r.avail = 56;
+    }
+}
+
+static VF_ALWAYS_INLINE u16 _vf_coded_decode(vf_coded_reader &r, const u16 *table)
+{
+    u16 e = table[r.bits & (vf_coded_table_size - 1)];
+    size_t l = e >> 8;
+    r.bits >>= l;
+    r.avail -= l;
+    r.used += l;
+    return e;
+}
+
+static VF_ALWAYS_INLINE int _vf_f64_read_coded_impl(vf_buf *buf,
+    double *value, size_t count)
+{
+    u8 hdr[vf_coded_block], sym[256], len[256];
+    u16 table[vf_coded_table_size], code[256];
+
+    while (count > 0) {
+        size_t n = count < vf_coded_block ? count : vf_coded_block;
+        if (vf_buf_check_capacity(buf, 1)) return -1;
+
+        const u8 *p = (const u8*)buf->data + buf->data_offset;
+        if (p[0] == 0) {
+            buf->data_offset++;
+            if (_vf_f64_read_array_impl(buf, value, n) < 0) return -1;
+            value += n;
+            count -= n;
+            continue;
+        }
+        if (p[0] != 1 || vf_buf_check_capacity(buf, 2)) return -1;
+
+        /* distinct symbols, code lengths in canonical order, complete or unique code */
+        size_t nsym = (size_t)p[1] + 1, kraft = 0;
+        u64 seen[4] = {};
+        if (vf_buf_check_capacity(buf, vf_coded_fixed_size + 2 * nsym)) return -1;
+        for (size_t i = 0; i < nsym; i++) {
+            sym[i] = p[2 + 2 * i];
+            if (seen[sym[i] >> 6] >> (sym[i] & 63) & 1) return -1;
+            seen[sym[i] >> 6] |= 1ull << (sym[i] & 63);
+            len[sym[i]] = p[3 + 2 * i];
+            size_t l = len[sym[i]];
+            if ((nsym == 1) != (l == 0) || l > vf_coded_max_len) return -1;
+            if (i > 0 && (l < len[sym[i - 1]] || (l == len[sym[i - 1]] && sym[i] <= sym[i - 1]))) {
+                return -1;
+            }
+            kraft += l ? vf_coded_table_size >> l : 0;
+        }
+        if (kraft > vf_coded_table_size) return -1;
+        p += 2 + 2 * nsym;
+
+        u32 l0, l1;
+        memcpy(&l0, p, 4);
+        memcpy(&l1, p + 4, 4);
+        l0 = le32(l0);
+        l1 = le32(l1);
+        p += 8;
+        size_t hsize = vf_coded_fixed_size + 2 * nsym;
+        if (vf_buf_check_capacity(buf, hsize + (size_t)l0 + l1)) return -1;
+
+        /* headers, two symbols from independent streams per step */
+        if (nsym == 1) {
+            memset(hdr, sym[0], n);
+        } else {
+            _vf_coded_codes(sym, len, nsym, code);
+            memset(table, 0, sizeof(table));
+            for (size_t i = 0; i < nsym; i++) {
+                size_t l = len[sym[i]];
+                for (size_t j = code[sym[i]]; j < vf_coded_table_size; j += (size_t)1 << l) {
+                    table[j] = (u16)(sym[i] | (l << 8));
+                }
+            }
+            const u8 *end = (const u8*)buf->data + buf->data_size + buf->data_pad;
+            vf_coded_reader r0 = { p, end, 0, 0, 0 };
+            vf_coded_reader r1 = { p + l0, end, 0, 0, 0 };
+            u16 bad = 0;
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                _vf_coded_refill(r0);
+                _vf_coded_refill(r1);
+                for (size_t j = 0; j < 8; j += 2) {
+                    u16 e0 = _vf_coded_decode(r0, table);
+                    u16 e1 = _vf_coded_decode(r1, table);
+                    hdr[i + j] = (u8)e0;
+                    hdr[i + j + 1] = (u8)e1;
+                    bad |= (u16)((e0 < 0x100) | (e1 < 0x100));
+                }
+            }
+            for (; i < n; i++) {
+                vf_coded_reader &r = i & 1 ? r1 : r0;
+                _vf_coded_refill(r);
+                u16 e = _vf_coded_decode(r, table);
+                hdr[i] = (u8)e;
+                bad |= (u16)(e < 0x100);
+            }
+            if (bad || r0.used > (size_t)l0 * 8 || r1.used > (size_t)l1 * 8) return -1;
+        }
+
+        /* payloads follow the streams in record order */
+        buf->data_offset += hsize + l0 + l1;
+        const char *q = buf->data + buf->data_offset;
+        const char *end = buf->data + buf->data_size;
+        for (size_t i = 0; i < n; i++) {
+            u8 pre = hdr[i];
+            s64 vr_exp = 0;
+            u64 vr_man = 0;
+            if (pre & 0x80) {
+                int l = _vf_payload_decode(q, end - q, buf->data_pad, pre, &vr_exp, &vr_man);
+                if (l < 0) {
+                    buf->data_offset = q - buf->data;
+                    return -1;
+                }
+                q += l;
+            }
+            value[i] = _vf_f64_unpack(pre, vr_exp, vr_man);
+        }
+        buf->data_offset = q - buf->data;
+
+        value += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
+/*
+ * schema records
+ *
+ * a schema compiles a list of struct fields into a plan of field ops
+ * with the worst-case encoded record size. records are written as the
+ * concatenation of their fields in schema order, floats as vf128 records
+ * and integers as VLU. the writer checks the worst-case size once per
+ * record and encodes with unchecked stores, records near the end of the
+ * buffer fall back to checked writes.
+ */
+
+struct vf_schema_op
+{
+    u32 offset;
+    u32 type;
+};
+
+struct vf_schema
+{
+    size_t stride;
+    size_t max_size;
+    size_t count;
+    vf_schema_op *op;
+};
+
+static size_t _vf_field_size(vf_field_type type)
+{
+    switch (type) {
+    case vf_field_f32: case vf_field_s32: case vf_field_u32: return 4;
+    case vf_field_f64: case vf_field_s64: case vf_field_u64: return 8;
+    }
+    return 0;
+}
+
+static size_t _vf_field_max_size(vf_field_type type)
+{
+    switch (type) {
+    case vf_field_f32: return vf_f32_max_size;
+    case vf_field_f64: return vf_f64_max_size;
+    default: return vf_vlu_max_size;
+    }
+}
+
+vf_schema* vf_schema_new(const vf_field *field, size_t count, size_t stride)
+{
+    vf_schema *s;
+
+    if (count == 0 || count > 0xffff || stride > 0xffffffffu) return nullptr;
+    for (size_t i = 0; i < count; i++) {
+        size_t size = _vf_field_size(field[i].type);
+        if (size == 0 || field[i].offset > stride || stride - field[i].offset < size) {
+            return nullptr;
+        }
+    }
+
+    s = (vf_schema*)malloc(sizeof(vf_schema) + count * sizeof(vf_schema_op));
+    if (!s) return nullptr;
+    s->stride = stride;
+    s->max_size = 0;
+    s->count = count;
+    s->op = (vf_schema_op*)(s + 1);
+    for (size_t i = 0; i < count; i++) {
+        s->op[i] = vf_schema_op { (u32)field[i].offset, (u32)field[i].type };
+        s->max_size += _vf_field_max_size(field[i].type);
+    }
+
+    return s;
+}
+
+void vf_schema_destroy(vf_schema *schema)
+{
+    free(schema);
+}
+
+size_t vf_schema_max_length(const vf_schema *schema)
+{
+    return schema->max_size;
+}
+
+template <typename T>
+static VF_ALWAYS_INLINE T _vf_field_load(const char *p)
+{
+    T v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+template <typename T>
+static VF_ALWAYS_INLINE void _vf_field_store(char *p, T v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+/* p has schema->max_size bytes available */
+static VF_ALWAYS_INLINE char* _vf_schema_encode(char *p, vf_stats *stats,
+    const vf_schema *s, const char *rec)
+{
+    for (size_t j = 0; j < s->count; j++) {
+        const char *f = rec + s->op[j].offset;
+        char *q = p;
+        u64 x;
+        switch ((vf_field_type)s->op[j].type) {
+        case vf_field_f32:
+            p += _vf_f32_encode(p, vf_f32_data_get(_vf_field_load<float>(f)));
+            if (stats) _vf_stats_add(stats, q, -(s64)f32_exp_bias);
+            continue;
+        case vf_field_f64:
+            p += _vf_f64_encode(p, vf_f64_data_get(_vf_field_load<double>(f)));
+            if (stats) _vf_stats_add(stats, q, -(s64)f64_exp_bias);
+            continue;
+        case vf_field_s32:
+            x = (u64)(s64)_vf_field_load<s32>(f);
+            p += _vlu_encode(p, x, _vlu_length(_int_s64_bits((s64)x)));
+            continue;
+        case vf_field_u32:
+            x = _vf_field_load<u32>(f);
+            p += _vlu_encode(p, x, _vlu_length(_int_u64_bits(x)));
+            continue;
+        case vf_field_s64:
+            x = (u64)_vf_field_load<s64>(f);
+            p += _vlu_encode(p, x, _vlu_length(_int_s64_bits((s64)x)));
+            continue;
+        case vf_field_u64:
+            x = _vf_field_load<u64>(f);
+            p += _vlu_encode(p, x, _vlu_length(_int_u64_bits(x)));
+            continue;
+        }
+    }
+    return p;
+}
+
+static int _vf_schema_write_checked(vf_buf *buf, const vf_schema *s, const char *rec)
+{
+    for (size_t j = 0; j < s->count; j++) {
+        const char *f = rec + s->op[j].offset;
+        int ret = 0;
+        switch ((vf_field_type)s->op[j].type) {
+        case vf_field_f32: ret = vf_f32_write_byval(buf, _vf_field_load<float>(f)); break;
+        case vf_field_f64: ret = vf_f64_write_byval(buf, _vf_field_load<double>(f)); break;
+        case vf_field_s32: ret = vf_vlu_s64_write_byval(buf, _vf_field_load<s32>(f)); break;
+        case vf_field_u32: ret = vf_vlu_u64_write_byval(buf, _vf_field_load<u32>(f)); break;
+        case vf_field_s64: ret = vf_vlu_s64_write_byval(buf, _vf_field_load<s64>(f)); break;
+        case vf_field_u64: ret = vf_vlu_u64_write_byval(buf, _vf_field_load<u64>(f)); break;
+        }
+        if (ret < 0) return -1;
+    }
+    return 0;
+}
+
+/* a record that does not fit is not written */
+static VF_ALWAYS_INLINE int _vf_schema_write_impl(vf_buf *buf,
+    const vf_schema *s, const void *record, size_t count)
+{
+    const char *rec = (const char*)record;
+
+    for (size_t i = 0; i < count; i++, rec += s->stride) {
+        size_t start = buf->data_offset;
+        if (start < buf->data_size && buf->data_size - start >= s->max_size) {
+            char *p = _vf_schema_encode(buf->data + start, buf->stats, s, rec);
+            buf->data_offset = p - buf->data;
+        } else if (_vf_schema_write_checked(buf, s, rec) < 0) {
+            buf->data_offset = start;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * decode one record into rec, returning its length or zero if a field is
+ * truncated or invalid. integer fields narrower than 64 bits must hold
+ * the decoded value.
+ */
+static VF_ALWAYS_INLINE size_t _vf_schema_decode(const char *p, const char *end,
+    size_t pad, vf_stats *stats, const vf_schema *s, char *rec)
+{
+    const char *start = p;
+    u8 pre;
+    s64 vr_exp;
+    u64 vr_man, x;
+
+    for (size_t j = 0; j < s->count; j++) {
+        char *f = rec + s->op[j].offset;
+        size_t len = 0;
+        switch ((vf_field_type)s->op[j].type) {
+        case vf_field_f32:
+            len = _vf_record_decode(p, end - p, pad, &pre, &vr_exp, &vr_man);
+            if (len == 0) return 0;
+            if (stats) _vf_stats_add(stats, p, -(s64)f32_exp_bias);
+            _vf_field_store(f, _vf_f32_unpack(pre, vr_exp, vr_man));
+            break;
+        case vf_field_f64:
+            len = _vf_record_decode(p, end - p, pad, &pre, &vr_exp, &vr_man);
+            if (len == 0) return 0;
+            if (stats) _vf_stats_add(stats, p, -(s64)f64_exp_bias);
+            _vf_field_store(f, _vf_f64_unpack(pre, vr_exp, vr_man));
+            break;
+        case vf_field_s32:
+            len = _vlu_decode(p, end - p, pad, &x);
+            if (len == 0) return 0;
+            _vlu_s64_fixup(p, len, &x);
+            if ((s64)x != (s32)(s64)x) return 0;
+            _vf_field_store(f, (s32)(s64)x);
+            break;
+        case vf_field_u32:
+            len = _vlu_decode(p, end - p, pad, &x);
+            if (len == 0 || x > 0xffffffffull) return 0;
+            _vf_field_store(f, (u32)x);
+            break;
+        case vf_field_s64:
+            len = _vlu_decode(p, end - p, pad, &x);
+            if (len == 0) return 0;
+            _vlu_s64_fixup(p, len, &x);
+            _vf_field_store(f, (s64)x);
+            break;
+        case vf_field_u64:
+            len = _vlu_decode(p, end - p, pad, &x);
+            if (len == 0) return 0;
+            _vf_field_store(f, x);
+            break;
+        }
+        p += len;
+    }
+    return p - start;
+}
+
+/* a record that fails to decode leaves the offset at its start */
+static VF_ALWAYS_INLINE int _vf_schema_read_impl(vf_buf *buf,
+    const vf_schema *s, void *record, size_t count)
+{
+    const char *p = buf->data + buf->data_offset;
+    const char *end = buf->data + buf->data_size;
+    char *rec = (char*)record;
+
+    for (size_t i = 0; i < count; i++, rec += s->stride) {
+        size_t len = _vf_schema_decode(p, end, buf->data_pad, buf->stats, s, rec);
+        if (len == 0) {
+            buf->data_offset = p - buf->data;
+            return -1;
+        }
+        p += len;
+    }
+    buf->data_offset = p - buf->data;
+
+    return 0;
+}
+
+/*
+ * kernel dispatch
+ *
+ * each kernel is the same portable source compiled with a target
+ * attribute, so the BMI2 kernel gets lzcnt, tzcnt, shlx and bzhi and
+ * the AVX2 and AVX-512 kernels also vectorize the field split. kernels
+ * with BMI2 compact LEB128 groups with pext.
+ */
+
+#define VF_KERNEL_IMPL(isa,target,pext)                                        \
+target static int _vf_f64_read_array_##isa(vf_buf *buf,                        \
+    double *value, size_t count)                                               \
+{                                                                              \
+    return _vf_f64_read_array_impl(buf, value, count);                         \
+}                                                                              \
+target static int _vf_f64_write_array_##isa(vf_buf *buf,                       \
+    const double *value, size_t count)                                         \
+{                                                                              \
+    return _vf_f64_write_array_impl(buf, value, count);                        \
+}                                                                              \
+target static int _vf_f32_read_array_##isa(vf_buf *buf,                        \
+    float *value, size_t count)                                                \
+{                                                                              \
+    return _vf_f32_read_array_impl(buf, value, count);                         \
+}                                                                              \
+target static int _vf_f32_write_array_##isa(vf_buf *buf,                       \
+    const float *value, size_t count)                                          \
+{                                                                              \
+    return _vf_f32_write_array_impl(buf, value, count);                        \
+}                                                                              \
+target static int _vf_leb128_u64_read_array_##isa(vf_buf *buf,                 \
+    u64 *value, size_t count)                                                  \
+{                                                                              \
+    return _vf_leb128_read_array_impl<pext,false>(buf, value, count);          \
+}                                                                              \
+target static int _vf_leb128_s64_read_array_##isa(vf_buf *buf,                 \
+    s64 *value, size_t count)                                                  \
+{                                                                              \
+    return _vf_leb128_read_array_impl<pext,true>(buf, (u64*)value, count);     \
+}                                                                              \
+target static int _vf_vlu_u64_read_array_##isa(vf_buf *buf,                    \
+    u64 *value, size_t count)                                                  \
+{                                                                              \
+    return _vf_vlu_read_array_impl<false>(buf, value, count);                  \
+}                                                                              \
+target static int _vf_vlu_s64_read_array_##isa(vf_buf *buf,                    \
+    s64 *value, size_t count)                                                  \
+{                                                                              \
+    return _vf_vlu_read_array_impl<true>(buf, (u64*)value, count);             \
+}                                                                              \
+target static int _vf_f64_read_packed_##isa(vf_buf *buf,                       \
+    double *value, size_t count)                                               \
+{                                                                              \
+    return _vf_f64_read_packed_impl(buf, value, count);                        \
+}                                                                              \
+target static int _vf_f32_read_mx_##isa(vf_buf *buf,                           \
+    float *value, size_t count)                                                \
+{                                                                              \
+    return _vf_mx_read_impl(buf, value, count);                                \
+}                                                                              \
+target static int _vf_f32_write_mx_##isa(vf_buf *buf,                          \
+    const float *value, size_t count, size_t block, int bits)                  \
+{                                                                              \
+    return _vf_mx_write_impl<float,f32_mant_size,f32_exp_size>(                \
+        buf, value, count, block, bits);                                       \
+}                                                                              \
+target static int _vf_f64_read_mx_##isa(vf_buf *buf,                           \
+    double *value, size_t count)                                               \
+{                                                                              \
+    return _vf_mx_read_impl(buf, value, count);                                \
+}                                                                              \
+target static int _vf_f64_write_mx_##isa(vf_buf *buf,                          \
+    const double *value, size_t count, size_t block, int bits)                 \
+{                                                                              \
+    return _vf_mx_write_impl<double,f64_mant_size,f64_exp_size>(               \
+        buf, value, count, block, bits);                                       \
+}                                                                              \
+target static int _vf_f64_read_dod_##isa(vf_buf *buf,                          \
+    double *value, size_t count)                                               \
+{                                                                              \
+    return _vf_f64_read_dod_impl(buf, value, count);                           \
+}                                                                              \
+target static int _vf_c64_read_array_##isa(vf_buf *buf,                        \
+    double *value, size_t count)                                               \
+{                                                                              \
+    return _vf_tuple_read_impl<double,f64_mant_size,f64_exp_size,2>(           \
+        buf, value, count);                                                    \
+}                                                                              \
+target static int _vf_c64_write_array_##isa(vf_buf *buf,                       \
+    const double *value, size_t count)                                         \
+{                                                                              \
+    return _vf_tuple_write_impl<double,f64_mant_size,f64_exp_size,2>(          \
+        buf, value, count);                                                    \
+}                                                                              \
+target static int _vf_vec3_read_array_##isa(vf_buf *buf,                       \
+    float *value, size_t count)                                                \
+{                                                                              \
+    return _vf_tuple_read_impl<float,f32_mant_size,f32_exp_size,3>(            \
+        buf, value, count);                                                    \
+}                                                                              \
+target static int _vf_vec3_write_array_##isa(vf_buf *buf,                      \
+    const float *value, size_t count)                                          \
+{                                                                              \
+    return _vf_tuple_write_impl<float,f32_mant_size,f32_exp_size,3>(           \
+        buf, value, count);                                                    \
+}                                                                              \
+target static int _vf_f32_read_vec_##isa(vf_buf *buf,                          \
+    float *value, size_t dim, size_t count)                                    \
+{                                                                              \
+    return _vf_f32_read_vec_impl(buf, value, dim, count);                      \
+}                                                                              \
+target static int _vf_f32_write_vec_##isa(vf_buf *buf,                         \
+    const float *value, size_t dim, size_t count, int bits)                    \
+{                                                                              \
+    return _vf_f32_write_vec_impl(buf, value, dim, count, bits);               \
+}                                                                              \
+target static int _vf_f64_read_coded_##isa(vf_buf *buf,                        \
+    double *value, size_t count)                                               \
+{                                                                              \
+    return _vf_f64_read_coded_impl(buf, value, count);                         \
+}                                                                              \
+target static int _vf_schema_read_##isa(vf_buf *buf,                           \
+    const vf_schema *schema, void *record, size_t count)                       \
+{                                                                              \
+    return _vf_schema_read_impl(buf, schema, record, count);                   \
+}                                                                              \
+target static int _vf_schema_write_##isa(vf_buf *buf,                          \
+    const vf_schema *schema, const void *record, size_t count)                 \
+{                                                                              \
+    return _vf_schema_write_impl(buf, schema, record, count);                  \
+}                                                                              \
+target static int _vf_f64_read_upto_##isa(vf_buf *buf,                         \
+    double *value, size_t *count)                                              \
+{                                                                              \
+    return _vf_read_upto_impl(buf, value, count, -(s64)f64_exp_bias);          \
+}                                                                              \
+target static int _vf_f32_read_upto_##isa(vf_buf *buf,                         \
+    float *value, size_t *count)                                               \
+{                                                                              \
+    return _vf_read_upto_impl(buf, value, count, -(s64)f32_exp_bias);          \
+}                                                                              \
+target static int _vf_f64_read_from_any_##isa(vf_buf *buf,                     \
+    double *value, size_t count, s64 sub_exp, vf_rounding mode)                \
+{                                                                              \
+    return _vf_read_from_any_mode(buf, value, count, sub_exp, mode);           \
+}                                                                              \
+target static int _vf_f32_read_from_any_##isa(vf_buf *buf,                     \
+    float *value, size_t count, s64 sub_exp, vf_rounding mode)                 \
+{                                                                              \
+    return _vf_read_from_any_mode(buf, value, count, sub_exp, mode);           \
+}
+
+#define VF_KERNEL_ENTRY(isa)                                                   \
+    _vf_f64_read_array_##isa, _vf_f64_write_array_##isa,                       \
+    _vf_f32_read_array_##isa, _vf_f32_write_array_##isa,                       \
+    _vf_leb128_u64_read_array_##isa, _vf_leb128_s64_read_array_##isa,          \
+    _vf_vlu_u64_read_array_##isa, _vf_vlu_s64_read_array_##isa,                \
+    _vf_f64_read_packed_##isa,                                                 \
+    _vf_f32_read_mx_##isa, _vf_f32_write_mx_##isa,                             \
+    _vf_f64_read_mx_##isa, _vf_f64_write_mx_##isa,                             \
+    _vf_f64_read_coded_##isa,                                                  \
+    _vf_schema_read_##isa, _vf_schema_write_##isa,                             \
+    _vf_f64_read_upto_##isa, _vf_f32_read_upto_##isa,                          \
+    _vf_f64_read_from_any_##isa, _vf_f32_read_from_any_##isa,                  \
+    _vf_f64_read_dod_##isa,                                                    \
+    _vf_c64_read_array_##isa, _vf_c64_write_array_##isa,                       \
+    _vf_vec3_read_array_##isa, _vf_vec3_write_array_##isa,                     \
+    _vf_f32_read_vec_##isa, _vf_f32_write_vec_##isa
+
+struct vf_kernel_table
+{
+    vf_kernel_isa isa;
+    const char *name;
+    int (*f64_read_array)(vf_buf *buf, double *value, size_t count);
+    int (*f64_write_array)(vf_buf *buf, const double *value, size_t count);
+    int (*f32_read_array)(vf_buf *buf, float *value, size_t count);
+    int (*f32_write_array)(vf_buf *buf, const float *value, size_t count);
+    int (*leb128_u64_read_array)(vf_buf *buf, u64 *value, size_t count);
+    int (*leb128_s64_read_array)(vf_buf *buf, s64 *value, size_t count);
+    int (*vlu_u64_read_array)(vf_buf *buf, u64 *value, size_t count);
+    int (*vlu_s64_read_array)(vf_buf *buf, s64 *value, size_t count);
+    int (*f64_read_packed)(vf_buf *buf, double *value, size_t count);
+    int (*f32_read_mx)(vf_buf *buf, float *value, size_t count);
+    int (*f32_write_mx)(vf_buf *buf, const float *value, size_t count, size_t block, int bits);
+    int (*f64_read_mx)(vf_buf *buf, double *value, size_t count);
+    int (*f64_write_mx)(vf_buf *buf, const double *value, size_t count, size_t block, int bits);
+    int (*f64_read_coded)(vf_buf *buf, double *value, size_t count);
+    int (*schema_read)(vf_buf *buf, const vf_schema *schema, void *record, size_t count);
+    int (*schema_write)(vf_buf *buf, const vf_schema *schema, const void *record, size_t count);
+    int (*f64_read_upto)(vf_buf *buf, double *value, size_t *count);
+    int (*f32_read_upto)(vf_buf *buf, float *value, size_t *count);
+    int (*f64_read_from_any)(vf_buf *buf, double *value, size_t count, s64 sub_exp, vf_rounding mode);
+    int (*f32_read_from_any)(vf_buf *buf, float *value, size_t count, s64 sub_exp, vf_rounding mode);
+    int (*f64_read_dod)(vf_buf *buf, double *value, size_t count);
+    int (*c64_read_array)(vf_buf *buf, double *value, size_t count);
+    int (*c64_write_array)(vf_buf *buf, const double *value, size_t count);
+    int (*vec3_read_array)(vf_buf *buf, float *value, size_t count);
+    int (*vec3_write_array)(vf_buf *buf, const float *value, size_t count);
+    int (*f32_read_vec)(vf_buf *buf, float *value, size_t dim, size_t count);
+    int (*f32_write_vec)(vf_buf *buf, const float *value, size_t dim, size_t count, int bits);
+};
+
+VF_KERNEL_IMPL(scalar, , false)
+#if VF_KERNEL_X86
+VF_KERNEL_IMPL(bmi2, VF_TARGET("bmi,bmi2,lzcnt"), true)
+VF_KERNEL_IMPL(avx2, VF_TARGET("avx2,bmi,bmi2,lzcnt"), true)
+VF_KERNEL_IMPL(avx512, VF_TARGET("avx512f,avx512bw,avx512vl,avx512cd,avx2,bmi,bmi2,lzcnt"), true)
+#endif
+
+static const vf_kernel_table _vf_kernel_tables[] = {
+    { vf_kernel_scalar, "scalar", VF_KERNEL_ENTRY(scalar) },
+#if VF_KERNEL_X86
+    { vf_kernel_bmi2, "bmi2", VF_KERNEL_ENTRY(bmi2) },
+    { vf_kernel_avx2, "avx2", VF_KERNEL_ENTRY(avx2) },
+    { vf_kernel_avx512, "avx512", VF_KERNEL_ENTRY(avx512) },
+#endif
+};
+
+enum : size_t {
+    vf_kernel_count = sizeof(_vf_kernel_tables) / sizeof(_vf_kernel_tables[0])
+};
+
+static vf_kernel_isa _vf_kernel_cpuid()
+{
+#if VF_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512cd") &&
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2")) {
+        return vf_kernel_avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2")) {
+        return vf_kernel_avx2;
+    }
+    if (__builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2")) {
+        return vf_kernel_bmi2;
+    }
+#endif
+    return vf_kernel_scalar;
+}
+
+static const vf_kernel_table* _vf_kernel_resolve()
+{
+    vf_kernel_isa isa = _vf_kernel_cpuid();
+    const char *env = getenv("VF128_KERNEL");
+
+    if (env) {
+        for (size_t i = 0; i < vf_kernel_count; i++) {
+            if (strcmp(env, _vf_kernel_tables[i].name) == 0) {
+                if (_vf_kernel_tables[i].isa < isa) {
+                    isa = _vf_kernel_tables[i].isa;
+                }
+                break;
+            }
+        }
+    }
+
+    return &_vf_kernel_tables[isa];
+}
+
+/*
+ * constant initialized so that static initializers in other units see
+ * null and resolve. relaxed ordering suffices as the tables are const
+ * and racing resolves store the same pointer.
+ */
+static std::atomic<const vf_kernel_table*> _vf_kernel{nullptr};
+
+static const vf_kernel_table* _vf_kernel_get()
+{
+    const vf_kernel_table *k = _vf_kernel.load(std::memory_order_relaxed);
+    if (!k) {
+        k = _vf_kernel_resolve();
+        _vf_kernel.store(k, std::memory_order_relaxed);
+    }
+    return k;
+}
+
+vf_kernel_isa vf_kernel_get(void)
+{
+    return _vf_kernel_get()->isa;
+}
+
+vf_kernel_isa vf_kernel_best(void)
+{
+    return _vf_kernel_cpuid();
+}
+
+int vf_kernel_set(vf_kernel_isa isa)
+{
+    if ((size_t)isa >= vf_kernel_count || isa > _vf_kernel_cpuid()) {
+        return -1;
+    }
+    _vf_kernel.store(&_vf_kernel_tables[isa], std::memory_order_relaxed);
+    return 0;
+}
+
+const char* vf_kernel_name(vf_kernel_isa isa)
+{
+    switch (isa) {
+    case vf_kernel_scalar: return "scalar";
+    case vf_kernel_bmi2: return "bmi2";
+    case vf_kernel_avx2: return "avx2";
+    case vf_kernel_avx512: return "avx512";
+    default: return "unknown";
+    }
+}
+
+int vf_f64_read_array(vf_buf *buf, double *value, size_t count)
+{
+    return _vf_kernel_get()->f64_read_array(buf, value, count);
+}
+
+int vf_f64_write_array(vf_buf *buf, const double *value, size_t count)
+{
+    return _vf_kernel_get()->f64_write_array(buf, value, count);
+}
+
+int vf_f32_read_array(vf_buf *buf, float *value, size_t count)
+{
+    return _vf_kernel_get()->f32_read_array(buf, value, count);
+}
+
+int vf_f32_write_array(vf_buf *buf, const float *value, size_t count)
+{
+    return _vf_kernel_get()->f32_write_array(buf, value, count);
+}
+
+int vf_f64_read_upto(vf_buf *buf, double *value, size_t *count)
+{
+    return _vf_kernel_get()->f64_read_upto(buf, value, count);
+}
+
+int vf_f32_read_upto(vf_buf *buf, float *value, size_t *count)
+{
+    return _vf_kernel_get()->f32_read_upto(buf, value, count);
+}
+
+static int _vf_sub_exp(vf_field_type from, s64 *sub_exp)
+{
+    switch (from) {
+    case vf_field_f32: *sub_exp = -(s64)f32_exp_bias; return 0;
+    case vf_field_f64: *sub_exp = -(s64)f64_exp_bias; return 0;
+    default: return -1;
+    }
+}
+
+int vf_f64_read_from_any(vf_buf *buf, double *value, size_t count,
+    vf_field_type from, vf_rounding mode)
+{
+    s64 sub_exp;
+    if (_vf_sub_exp(from, &sub_exp) < 0) return -1;
+    return _vf_kernel_get()->f64_read_from_any(buf, value, count, sub_exp, mode);
+}
+
+int vf_f32_read_from_any(vf_buf *buf, float *value, size_t count,
+    vf_field_type from, vf_rounding mode)
+{
+    s64 sub_exp;
+    if (_vf_sub_exp(from, &sub_exp) < 0) return -1;
+    return _vf_kernel_get()->f32_read_from_any(buf, value, count, sub_exp, mode);
+}
+
+int vf_leb128_u64_read_array(vf_buf *buf, u64 *value, size_t count)
+{
+    return _vf_kernel_get()->leb128_u64_read_array(buf, value, count);
+}
+
+int vf_leb128_s64_read_array(vf_buf *buf, s64 *value, size_t count)
+{
+    return _vf_kernel_get()->leb128_s64_read_array(buf, value, count);
+}
+
+int vf_vlu_u64_read_array(vf_buf *buf, u64 *value, size_t count)
+{
+    return _vf_kernel_get()->vlu_u64_read_array(buf, value, count);
+}
+
+int vf_vlu_s64_read_array(vf_buf *buf, s64 *value, size_t count)
+{
+    return _vf_kernel_get()->vlu_s64_read_array(buf, value, count);
+}
+
+int vf_f64_read_packed(vf_buf *buf, double *value, size_t count)
+{
+    return _vf_kernel_get()->f64_read_packed(buf, value, count);
+}
+
+int vf_f32_read_mx(vf_buf *buf, float *value, size_t count)
+{
+    return _vf_kernel_get()->f32_read_mx(buf, value, count);
+}
+
+int vf_f32_write_mx(vf_buf *buf, const float *value, size_t count, size_t block, int bits)
+{
+    return _vf_kernel_get()->f32_write_mx(buf, value, count, block, bits);
+}
+
+int vf_f64_read_mx(vf_buf *buf, double *value, size_t count)
+{
+    return _vf_kernel_get()->f64_read_mx(buf, value, count);
+}
+
+int vf_f64_write_mx(vf_buf *buf, const double *value, size_t count, size_t block, int bits)
+{
+    return _vf_kernel_get()->f64_write_mx(buf, value, count, block, bits);
+}
+
+int vf_f64_read_coded(vf_buf *buf, double *value, size_t count)
+{
+    return _vf_kernel_get()->f64_read_coded(buf, value, count);
+}
+
+int vf_f64_write_coded(vf_buf *buf, const double *value, size_t count)
+{
+    char *scratch = (char*)malloc(vf_coded_block * vf_f64_max_size);
+    int ret = 0;
+
+    if (!scratch) return -1;
+    while (count > 0 && ret == 0) {
+        size_t n = count < vf_coded_block ? count : vf_coded_block;
+        ret = _vf_coded_write_block(buf, value, n, scratch);
+        value += n;
+        count -= n;
+    }
+    free(scratch);
+
+    return ret;
+}
+
+int vf_f64_read_dod(vf_buf *buf, double *value, size_t count)
+{
+    return _vf_kernel_get()->f64_read_dod(buf, value, count);
+}
+
+int vf_f64_write_dod(vf_buf *buf, const double *value, size_t count)
+{
+    while (count > 0) {
+        size_t n = count < vf_dod_block ? count : vf_dod_block;
+        if (_vf_dod_write_block(buf, value, n) < 0) return -1;
+        value += n;
+        count -= n;
+    }
+    return 0;
+}
+
+int vf_c64_read(vf_buf *buf, double *value)
+{
+    return _vf_tuple_read_impl<double,f64_mant_size,f64_exp_size,2>(buf, value, 1);
+}
+
+int vf_c64_write(vf_buf *buf, const double *value)
+{
+    return _vf_tuple_write_impl<double,f64_mant_size,f64_exp_size,2>(buf, value, 1);
+}
+
+int vf_c64_read_array(vf_buf *buf, double *value, size_t count)
+{
+    return _vf_kernel_get()->c64_read_array(buf, value, count);
+}
+
+int vf_c64_write_array(vf_buf *buf, const double *value, size_t count)
+{
+    return _vf_kernel_get()->c64_write_array(buf, value, count);
+}
+
+int vf_vec3_read(vf_buf *buf, float *value)
+{
+    return _vf_tuple_read_impl<float,f32_mant_size,f32_exp_size,3>(buf, value, 1);
+}
+
+int vf_vec3_write(vf_buf *buf, const float *value)
+{
+    return _vf_tuple_write_impl<float,f32_mant_size,f32_exp_size,3>(buf, value, 1);
+}
+
+int vf_vec3_read_array(vf_buf *buf, float *value, size_t count)
+{
+    return _vf_kernel_get()->vec3_read_array(buf, value, count);
+}
+
+int vf_vec3_write_array(vf_buf *buf, const float *value, size_t count)
+{
+    return _vf_kernel_get()->vec3_write_array(buf, value, count);
+}
+
+int vf_f32_read_vec(vf_buf *buf, float *value, size_t dim, size_t count)
+{
+    return _vf_kernel_get()->f32_read_vec(buf, value, dim, count);
+}
+
+int vf_f32_write_vec(vf_buf *buf, const float *value, size_t dim, size_t count, int bits)
+{
+    return _vf_kernel_get()->f32_write_vec(buf, value, dim, count, bits);
+}
+
+int vf_schema_read(vf_buf *buf, const vf_schema *schema, void *record, size_t count)
+{
+    return _vf_kernel_get()->schema_read(buf, schema, record, count);
+}
+
+int vf_schema_write(vf_buf *buf, const vf_schema *schema, const void *record, size_t count)
+{
+    return _vf_kernel_get()->schema_write(buf, schema, record, count);
+}
+
+int vf_f64_write_packed(vf_buf *buf, const double *value, size_t count)
+{
+    while (count > 0) {
+        size_t n = count < vf_packed_block ? count : vf_packed_block;
+        if (_vf_packed_write_block(buf, value, n) < 0) return -1;
+        value += n;
+        count -= n;
+    }
+    return 0;
+}
+
+/*
+ * decimal strings
+ *
+ * vf_f64_write_decimal scans a decimal string and converts it with the
+ * Eisel-Lemire fast path before encoding. vf_f64_read_decimal prints the
+ * shortest string that parses back to the same value (Ryu), in fixed
+ * notation for decimal exponents from -5 to 15 and scientific otherwise.
+ */
+
+static bool _decimal_word(const char *p, const char *end, const char *word)
+{
+    for (; p < end && *word; p++, word++) {
+        if ((*p | 0x20) != *word) return false;
+    }
+    return p == end && *word == 0;
+}
+
+static int _decimal_special(const char *p, const char *end, double *value)
+{
+    bool neg = false;
+
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p < end && (*p == '+' || *p == '-')) {
+        neg = *p++ == '-';
+    }
+    if (_decimal_word(p, end, "inf") || _decimal_word(p, end, "infinity")) {
+        *value = neg ? -_f64_inf() : _f64_inf();
+        return 0;
+    }
+    if (_decimal_word(p, end, "nan")) {
+        *value = _f64_nan();
+        return 0;
+    }
+    return -1;
+}
+
+int vf_f64_write_decimal(vf_buf *buf, const char *str, size_t len)
+{
+    decimal_data d;
+    double value;
+
+    if (_decimal_scan(str, str + len, '.', &d) == 0) {
+        value = _f64_decimal(d);
+    } else if (_decimal_special(str, str + len, &value) < 0) {
+        return -1;
+    }
+
+    return vf_f64_write_byval(buf, value);
+}
+
+static VF_ALWAYS_INLINE u32 _pow5_bits(u32 e) { return ((e * 1217359) >> 19) + 1; }
+static VF_ALWAYS_INLINE u32 _log10_pow2(u32 e) { return (e * 78913) >> 18; }
+static VF_ALWAYS_INLINE u32 _log10_pow5(u32 e) { return (e * 732923) >> 20; }
+
+static VF_ALWAYS_INLINE bool _multiple_of_pow5(u64 v, u32 p)
+{
+    u32 n = 0;
+    for (; v % 5 == 0; v /= 5) n++;
+    return n >= p;
+}
+
+static VF_ALWAYS_INLINE bool _multiple_of_pow2(u64 v, u32 p)
+{
+    return (v & ((1ull << p) - 1)) == 0;
+}
+
+/* (m * mul) >> j for a 125-bit multiplier with 64 < j < 128 */
+static VF_ALWAYS_INLINE u64 _mul_shift64(u64 m, const u64 *mul, s32 j)
+{
+    u64 hi0, lo1, hi1, lo, hi;
+    int sh = j - 64;
+
+    _u64_mul_128(m, mul[0], &hi0);
+    lo1 = _u64_mul_128(m, mul[1], &hi1);
+    lo = lo1 + hi0;
+    hi = hi1 + (lo < lo1);
+    return (hi << (64 - sh)) | (lo >> sh);
+}
+
+/*
+ * shortest decimal w * 10^e10 in the rounding interval of a finite,
+ * non-zero double, closest to the exact value (Ryu, Adams 2018).
+ */
+static void _f64_shortest(u64 ieee_mant, u32 ieee_exp, u64 *out, s32 *out_e10)
+{
+    s32 e2, e10;
+    u64 m2, mv, vr, vp, vm, output;
+    u32 mm_shift, q;
+    bool even, vm_tz = false, vr_tz = false;
+    s32 removed = 0;
+    u8 last = 0;
+
+    if (ieee_exp == 0) {
+        e2 = 1 - (s32)f64_exp_bias - (s32)f64_mant_size - 2;
+        m2 = ieee_mant;
+    } else {
+        e2 = (s32)ieee_exp - (s32)f64_exp_bias - (s32)f64_mant_size - 2;
+        m2 = f64_mant_prefix | ieee_mant;
+    }
+    even = (m2 & 1) == 0;
+    mv = 4 * m2;
+    mm_shift = ieee_mant != 0 || ieee_exp <= 1;
+
+    if (e2 >= 0) {
+        q = _log10_pow2(e2) - (e2 > 3);
+        e10 = (s32)q;
+        s32 k = _vf_pow5_inv_bitcount + _pow5_bits(q) - 1;
+        s32 i = -e2 + (s32)q + k;
+        vr = _mul_shift64(4 * m2, _vf_pow5_inv_split[q], i);
+        vp = _mul_shift64(4 * m2 + 2, _vf_pow5_inv_split[q], i);
+        vm = _mul_shift64(4 * m2 - 1 - mm_shift, _vf_pow5_inv_split[q], i);
+        if (q <= 21) {
+            if (mv % 5 == 0) {
+                vr_tz = _multiple_of_pow5(mv, q);
+            } else if (even) {
+                vm_tz = _multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= _multiple_of_pow5(mv + 2, q);
+            }
+        }
+    } else {
+        q = _log10_pow5(-e2) - (-e2 > 1);
+        e10 = (s32)q + e2;
+        s32 i = -e2 - (s32)q;
+        s32 k = (s32)_pow5_bits(i) - _vf_pow5_bitcount;
+        s32 j = (s32)q - k;
+        vr = _mul_shift64(4 * m2, _vf_pow5_split[i], j);
+        vp = _mul_shift64(4 * m2 + 2, _vf_pow5_split[i], j);
+        vm = _mul_shift64(4 * m2 - 1 - mm_shift, _vf_pow5_split[i], j);
+        if (q <= 1) {
+            vr_tz = true;
+            if (even) {
+                vm_tz = mm_shift == 1;
+            } else {
+                --vp;
+            }
+        } else if (q < 63) {
+            vr_tz = _multiple_of_pow2(mv, q);
+        }
+    }
+
+    if (vm_tz || vr_tz) {
+        /* general case, rarely taken */
+        while (vp / 10 > vm / 10) {
+            vm_tz &= vm % 10 == 0;
+            vr_tz &= last == 0;
+            last = (u8)(vr % 10);
+            vr /= 10; vp /= 10; vm /= 10;
+            removed++;
+        }
+        if (vm_tz) {
+            while (vm % 10 == 0) {
+                vr_tz &= last == 0;
+                last = (u8)(vr % 10);
+                vr /= 10; vp /= 10; vm /= 10;
+                removed++;
+            }
+        }
+        if (vr_tz && last == 5 && vr % 2 == 0) {
+            /* round even if the exact value is .5000... */
+            last = 4;
+        }
+        output = vr + ((vr == vm && (!even || !vm_tz)) || last >= 5);
+    } else {
+        bool round_up = false;
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100; vp /= 100; vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10; vp /= 10; vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+
+    *out = output;
+    *out_e10 = e10 + removed;
+}
+
+enum : size_t { vf_f64_decimal_max = 32 };
+
+static size_t _f64_format_shortest(char *s, double value)
+{
+    u64 bits = f64_to_bits(value), w;
+    u32 ieee_exp = (u32)f64_exp_dec(value);
+    u64 ieee_mant = f64_mant_dec(value);
+    char digits[20];
+    size_t n = 0, o = 0;
+    s32 e10, x;
+
+    if (ieee_exp == f64_exp_mask) {
+        if (ieee_mant) {
+            memcpy(s, "nan", 3);
+            return 3;
+        }
+        if (bits >> 63) s[o++] = '-';
+        memcpy(s + o, "inf", 3);
+        return o + 3;
+    }
+    if (bits >> 63) s[o++] = '-';
+    if (ieee_exp == 0 && ieee_mant == 0) {
+        s[o++] = '0';
+        return o;
+    }
+
+    _f64_shortest(ieee_mant, ieee_exp, &w, &e10);
+    for (; w; w /= 10) digits[19 - n++] = (char)('0' + w % 10);
+    const char *d = digits + 20 - n;
+    x = e10 + (s32)n - 1;
+
+    if (x < -5 || x > 15) {
+        s[o++] = d[0];
+        if (n > 1) {
+            s[o++] = '.';
+            memcpy(s + o, d + 1, n - 1);
+            o += n - 1;
+        }
+        s[o++] = 'e';
+        s[o++] = x < 0 ? '-' : '+';
+        x = x < 0 ? -x : x;
+        if (x >= 100) s[o++] = (char)('0' + x / 100);
+        s[o++] = (char)('0' + x / 10 % 10);
+        s[o++] = (char)('0' + x % 10);
+    } else if (e10 >= 0) {
+        memcpy(s + o, d, n);
+        o += n;
+        memset(s + o, '0', e10);
+        o += e10;
+    } else if (x >= 0) {
+        memcpy(s + o, d, x + 1);
+        o += x + 1;
+        s[o++] = '.';
+        memcpy(s + o, d + x + 1, n - x - 1);
+        o += n - x - 1;
+    } else {
+        s[o++] = '0';
+        s[o++] = '.';
+        memset(s + o, '0', -x - 1);
+        o += -x - 1;
+        memcpy(s + o, d, n);
+        o += n;
+    }
+    return o;
+}
+
+int vf_f64_read_decimal(vf_buf *buf, char *str, size_t cap)
+{
+    char tmp[vf_f64_decimal_max];
+    size_t offset = buf->data_offset, len;
+    f64_result r = vf_f64_read_byval(buf);
+
+    if (r.error < 0) {
+        return -1;
+    }
+    len = _f64_format_shortest(tmp, r.value);
+    if (len + 1 > cap) {
+        buf->data_offset = offset;
+        return -1;
+    }
+    memcpy(str, tmp, len);
+    str[len] = '\0';
+    return (int)len;
+}
+
+/*
+ * ASN.1 REAL <-> vf128 transcoding
+ *
+ * both formats hold a sign, a binary exponent and an integer fraction.
+ * values that are exact in binary64 are reshaped directly between the
+ * ASN.1 lsb-relative exponent and right-justified fraction and the vf128
+ * fields, and produce the same bytes as decoding to a double and calling
+ * vf_f64_write or vf_asn1_der_real_f64_write. other values (decimal forms,
+ * wider fractions, out of range exponents) are rounded through a double.
+ */
+
+enum : size_t { vf_asn1_real_max_size = 2 + 11 };
+
+static VF_ALWAYS_INLINE int _transcode_asn1_data(const char *p, size_t len, vf_f64_data *d)
+{
+    asn1_real_parts r;
+    decimal_data dec;
+    u64 m, frac;
+    s64 lsb, e, exp2;
+    int tz, bits;
+
+    if (_asn1_real_parse(p, len, &r) < 0) return -1;
+    switch (r.kind) {
+    case _real_kind_special:
+        switch (r.b) {
+        case _real_special_pos_inf:  *d = vf_f64_data { false, f64_exp_bias + 1, 0 }; return 0;
+        case _real_special_neg_inf:  *d = vf_f64_data { true, f64_exp_bias + 1, 0 };  return 0;
+        case _real_special_neg_zero: *d = vf_f64_data { true, -(s64)f64_exp_bias, 0 }; return 0;
+        default: *d = vf_f64_data_get(_f64_nan()); return 0;
+        }
+    case _real_kind_decimal:
+        if (_asn1_real_decimal_parse(p + 1, len - 1, r.b, &dec) < 0) return -1;
+        *d = vf_f64_data_get(_f64_decimal(dec));
+        return 0;
+    default:
+        break;
+    }
+
+    if (r.hi == 0) {
+        if (r.lo == 0) {
+            *d = vf_f64_data { r.sign, -(s64)f64_exp_bias, 0 };
+            return 0;
+        }
+        tz = ctz(r.lo);
+        m = r.lo >> tz;
+        bits = 64 - clz(m);
+        lsb = r.exp2 + tz;
+        e = lsb + bits - 1;
+        if (bits <= 53 && e >= 1 - (s64)f64_exp_bias && e <= (s64)f64_exp_bias) {
+            *d = vf_f64_data { r.sign, e, (m << (64 - bits)) << 1 };
+            return 0;
+        }
+        if (e < 1 - (s64)f64_exp_bias && lsb >= 1 - (s64)f64_exp_bias - (s64)f64_mant_size) {
+            s64 sh = lsb - (1 - (s64)f64_exp_bias - (s64)f64_mant_size) + f64_exp_size + 1;
+            *d = vf_f64_data { r.sign, -(s64)f64_exp_bias, m << sh };
+            return 0;
+        }
+    }
+
+    frac = _asn1_real_frac_u64(r, &exp2);
+    *d = vf_f64_data_get(_f64_from_parts(r.sign, frac, exp2));
+    return 0;
+}
+
+static VF_ALWAYS_INLINE f64_real_data _transcode_real_data(bool sign, u64 m, s64 lsb)
+{
+    int tz = ctz(m);
+    m >>= tz;
+    lsb += tz;
+    return f64_real_data {
+        m, lsb,
+        vf_asn1_ber_integer_u64_length(&m),
+        vf_asn1_ber_integer_s64_length(&lsb),
+        sign, false, false, false
+    };
+}
+
+/*
+ * reshape a vf128 record to ASN.1 fields (see _vf_f64_unpack)
+ */
+static VF_ALWAYS_INLINE f64_real_data _transcode_vf128_data(u8 pre, s64 vr_exp, u64 vr_man)
+{
+    bool vf_inl = ! ((pre >> 7) & 1);
+    bool vf_sgn =    (pre >> 6) & 1;
+    int  vf_exp =    (pre >> 4) & 3;
+    int  vf_man =     pre       & 15;
+    int lz, bits;
+    s64 e;
+
+    if (vf_inl) {
+        if (vf_exp == 0 && vf_man == 0) {
+            return f64_real_data { 0, 0, 1, 1, vf_sgn, false, false, true };
+        } else if (vf_exp == 0) {
+            return _transcode_real_data(vf_sgn, (u64)vf_man, -4);
+        } else if (vf_exp == 3) {
+            return f64_real_data { 0, 0, 1, 1, vf_sgn && !vf_man, !vf_man, !!vf_man, false };
+        } else {
+            return _transcode_real_data(vf_sgn, 16 | (u64)vf_man, vf_exp - 5);
+        }
+    }
+
+    if (vr_man == 0) {
+        e = vr_exp;
+        if (e >= 1 - (s64)f64_exp_bias && e <= (s64)f64_exp_bias) {
+            return _transcode_real_data(vf_sgn, 1, e);
+        }
+    } else {
+        lz = clz(vr_man);
+        bits = 64 - lz;
+        if (vr_exp <= -(s64)f64_exp_bias) {
+            e = vr_exp + 1;
+            if (e - bits + 1 >= 1 - (s64)f64_exp_bias - (s64)f64_mant_size) {
+                return _transcode_real_data(vf_sgn, vr_man, e - bits + 1);
+            }
+        } else {
+            e = vf_exp == 0 ? -(s64)ctz(vr_man) - 1 : vr_exp;
+            if (bits <= 53 && e <= (s64)f64_exp_bias) {
+                return _transcode_real_data(vf_sgn, vr_man, e - bits + 1);
+            }
+        }
+    }
+
+    return f64_asn1_data_get(_vf_f64_unpack(pre, vr_exp, vr_man));
+}
+
+int vf_transcode_asn1_to_vf128(vf_buf *dst, vf_buf *src, size_t count)
+{
+    asn1_hdr hdr;
+    vf_f64_data d;
+    size_t len;
+
+    for (size_t i = 0; i < count; i++) {
+        const char *p = src->data + src->data_offset;
+        size_t avail = src->data_size - src->data_offset;
+
+        /* single byte identifier and short form length */
+        if (avail >= 2 && (u8)p[0] == asn1_tag_real && (u8)p[1] < 0x80) {
+            len = (u8)p[1];
+            if (len > avail - 2) return -1;
+            if (_transcode_asn1_data(p + 2, len, &d) < 0) return -1;
+            src->data_offset += 2 + len;
+        } else {
+            if (vf_asn1_ber_ident_read(src, &hdr._id) < 0) return -1;
+            if (vf_asn1_ber_length_read(src, &hdr._length) < 0) return -1;
+            if (hdr._id._identifier != asn1_tag_real || hdr._id._constructed ||
+                hdr._id._class != asn1_class_universal) return -1;
+            if (vf_buf_check_capacity(src, hdr._length)) return -1;
+            if (_transcode_asn1_data(src->data + src->data_offset,
+                hdr._length, &d) < 0) return -1;
+            src->data_offset += hdr._length;
+        }
+
+        if (_vf_stats_record(dst, -(s64)f64_exp_bias,
+            [&] { return _vf_f64_write_data(dst, d); }) < 0) return -1;
+    }
+
+    return 0;
+}
+
+int vf_transcode_vf128_to_asn1(vf_buf *dst, vf_buf *src, size_t count)
+{
+    f64_real_data d;
+    u8 pre;
+    s64 vr_exp;
+    u64 vr_man;
+    size_t len;
+
+    for (size_t i = 0; i < count; i++) {
+        len = _vf_stats_record(src, -(s64)f64_exp_bias, [&] {
+            size_t n = _vf_record_decode(src->data + src->data_offset,
+                src->data_size - src->data_offset, src->data_pad, &pre, &vr_exp, &vr_man);
+            src->data_offset += n;
+            return n;
+        });
+        if (len == 0) return -1;
+
+        d = _transcode_vf128_data(pre, vr_exp, vr_man);
+        len = _asn1_real_content_length(d);
+        if (vf_buf_check_capacity(dst, 2 + len)) return -1;
+
+        char *p = dst->data + dst->data_offset;
+        p[0] = (char)asn1_tag_real;
+        p[1] = (char)len;
+        _asn1_real_content_encode(p + 2, d);
+        dst->data_offset += 2 + len;
+    }
+
+    return 0;
+}
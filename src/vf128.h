@@ -2,9 +2,24 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <float.h>
 
 #include "stdendian.h"
 
+/*
+ * VF128_INLINE selects the header-only build where the codecs are
+ * declared static inline and their definitions are included below,
+ * so that callers can inline them into their serialization loops.
+ */
+#if defined(VF128_INLINE) && VF128_INLINE
+#if !defined(__cplusplus)
+#error "VF128_INLINE requires C++"
+#endif
+#define VF_API static inline
+#else
+#define VF_API
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,6 +35,19 @@ typedef unsigned long long u64;
 typedef float f32;
 typedef double f64;
 
+/*
+ * f80 is the x87 extended precision long double and f128 is IEEE 754
+ * binary128. they are declared where the compiler supports them.
+ */
+#if LDBL_MANT_DIG == 64 && LDBL_MAX_EXP == 16384 && defined(__SIZEOF_INT128__)
+#define VF_HAS_F80 1
+typedef long double f80;
+#endif
+#if defined(__SIZEOF_FLOAT128__) && defined(__SIZEOF_INT128__)
+#define VF_HAS_F128 1
+typedef __float128 f128;
+#endif
+
 /*
  * buffer interface
  */
@@ -36,16 +64,48 @@ struct vf_span
     size_t length;
 };
 
+/*
+ * data_pad is the number of readable bytes following data_size. readers
+ * use fixed width loads when padding is present and otherwise fall back
+ * to variable length reads. vf_buf_new allocates VF_BUF_PADDING bytes.
+ */
+#define VF_BUF_PADDING 16
+
+struct vf_stats;
+
+/*
+ * stats is an optional vf_stats counting the records encoded or decoded
+ * through the buffer, null unless set with vf_buf_set_stats.
+ */
 struct vf_buf
 {
     char *data;
     size_t data_offset;
     size_t data_size;
+    size_t data_pad;
+    struct vf_stats *stats;
 };
 
-vf_buf* vf_buf_new(size_t size);
-void vf_buf_destroy(vf_buf* buf);
-void vf_buf_dump(vf_buf *buf);
+VF_API vf_buf* vf_buf_new(size_t size);
+VF_API void vf_buf_destroy(vf_buf* buf);
+VF_API void vf_buf_dump(vf_buf *buf);
+
+/*
+ * buffer pool. vf_buf_acquire returns a buffer of at least size bytes
+ * from a thread safe pool, reset but not cleared, and vf_buf_release
+ * returns it for reuse. sizes are rounded up to power of two classes up
+ * to 64 MiB and the rounding is added to the padding, larger buffers
+ * are allocated and freed directly. each thread keeps a small cache per
+ * pool in front of lock-free global free lists. pooled buffers must be
+ * released to their pool, not destroyed, and all buffers must be
+ * released before vf_buf_pool_destroy.
+ */
+typedef struct vf_buf_pool vf_buf_pool;
+
+VF_API vf_buf_pool* vf_buf_pool_new(void);
+VF_API void vf_buf_pool_destroy(vf_buf_pool *pool);
+VF_API vf_buf* vf_buf_acquire(vf_buf_pool *pool, size_t size);
+VF_API void vf_buf_release(vf_buf_pool *pool, vf_buf *buf);
 
 static size_t vf_buf_write_i8(vf_buf* buf, int8_t num);
 static size_t vf_buf_write_i16(vf_buf* buf, int16_t num);
@@ -84,9 +144,16 @@ static size_t vf_buf_offset(vf_buf* buf);
 
 #define CREFL_FN(Y,X) vf_ ## Y ## _ ## X
 
+/* len may be a decoded length near 2^64, the comparison must not wrap */
 static inline size_t vf_buf_check_capacity(vf_buf *buf, size_t len)
 {
-    return (buf->data_offset + len > buf->data_size) ? -1 : 0;
+    return (buf->data_offset > buf->data_size ||
+        len > buf->data_size - buf->data_offset) ? -1 : 0;
+}
+
+static inline int vf_buf_check_padded(vf_buf *buf, size_t len)
+{
+    return buf->data_offset + len <= buf->data_size + buf->data_pad;
 }
 
 #if USE_UNALIGNED_ACCESSES && !USE_CRT_MEMCPY
@@ -288,17 +355,31 @@ static inline vf_span vf_buf_remaining(vf_buf* buf)
  * floating point helpers
  */
 
-float _f32_inf();
-float _f32_nan();
-float _f32_snan();
-double _f64_inf();
-double _f64_nan();
-double _f64_snan();
+VF_API float _f32_inf();
+VF_API float _f32_nan();
+VF_API float _f32_snan();
+VF_API double _f64_inf();
+VF_API double _f64_nan();
+VF_API double _f64_snan();
 
 /*
  * integer and floating-point serialization
  */
 
+/*
+ * rounding of values with more precision than the type they are read
+ * into. the plain readers truncate (vf_round_zero), vf_f32_read_from_any
+ * and vf_f64_read_from_any select the mode. exponents beyond the range
+ * of the type read as ±Inf in every mode, values below it round to a
+ * subnormal or zero.
+ */
+typedef enum {
+    vf_round_nearest            = 0,
+    vf_round_zero               = 1,
+    vf_round_up                 = 2,
+    vf_round_down               = 3,
+} vf_rounding;
+
 typedef enum {
     asn1_class_universal        = 0b00,
     asn1_class_application      = 0b01,
@@ -317,6 +398,7 @@ typedef enum {
     asn1_tag_object_descriptor  = 7,
     asn1_tag_external           = 8,
     asn1_tag_real               = 9,
+    asn1_tag_sequence           = 16,
 } asn1_tag;
 
 struct asn1_id
@@ -338,91 +420,400 @@ struct f32_result { f32 value; s32 error; };
 struct f64_result { f64 value; s64 error; };
 struct s64_result { s64 value; s64 error; };
 struct u64_result { u64 value; s64 error; };
+#if defined(VF_HAS_F80)
+struct f80_result { f80 value; s64 error; };
+#endif
+#if defined(VF_HAS_F128)
+struct f128_result { f128 value; s64 error; };
+#endif
+
+VF_API size_t vf_asn1_ber_tag_length(u64 len);
+VF_API int vf_asn1_ber_tag_read(vf_buf *buf, u64 *len);
+VF_API int vf_asn1_ber_tag_write(vf_buf *buf, u64 len);
+
+VF_API size_t vf_asn1_ber_ident_length(asn1_id _id);
+VF_API int vf_asn1_ber_ident_read(vf_buf *buf, asn1_id *_id);
+VF_API int vf_asn1_ber_ident_write(vf_buf *buf, asn1_id _id);
+
+VF_API size_t vf_asn1_ber_length_length(u64 length);
+VF_API int vf_asn1_ber_length_read(vf_buf *buf, u64 *length);
+VF_API int vf_asn1_ber_length_write(vf_buf *buf, u64 length);
+
+VF_API size_t vf_asn1_ber_integer_u64_length(const u64 *value);
+VF_API int vf_asn1_ber_integer_u64_read(vf_buf *buf, size_t len, u64 *value);
+VF_API int vf_asn1_ber_integer_u64_write(vf_buf *buf, size_t len, const u64 *value);
+VF_API int vf_asn1_der_integer_u64_read(vf_buf *buf, asn1_tag _tag, u64 *value);
+VF_API int vf_asn1_der_integer_u64_write(vf_buf *buf, asn1_tag _tag, const u64 *value);
+
+VF_API size_t vf_asn1_ber_integer_u64_length_byval(const u64 value);
+VF_API struct u64_result vf_asn1_ber_integer_u64_read_byval(vf_buf *buf, size_t len);
+VF_API int vf_asn1_ber_integer_u64_write_byval(vf_buf *buf, size_t len, const u64 value);
+VF_API struct u64_result vf_asn1_der_integer_u64_read_byval(vf_buf *buf, asn1_tag _tag);
+VF_API int vf_asn1_der_integer_u64_write_byval(vf_buf *buf, asn1_tag _tag, const u64 value);
+
+VF_API size_t vf_asn1_ber_integer_s64_length(const s64 *value);
+VF_API int vf_asn1_ber_integer_s64_read(vf_buf *buf, size_t len, s64 *value);
+VF_API int vf_asn1_ber_integer_s64_write(vf_buf *buf, size_t len, const s64 *value);
+VF_API int vf_asn1_der_integer_s64_read(vf_buf *buf, asn1_tag _tag, s64 *value);
+VF_API int vf_asn1_der_integer_s64_write(vf_buf *buf, asn1_tag _tag, const s64 *value);
+
+VF_API size_t vf_asn1_ber_integer_s64_length_byval(const s64 value);
+VF_API struct s64_result vf_asn1_ber_integer_s64_read_byval(vf_buf *buf, size_t len);
+VF_API int vf_asn1_ber_integer_s64_write_byval(vf_buf *buf, size_t len, const s64 value);
+VF_API struct s64_result vf_asn1_der_integer_s64_read_byval(vf_buf *buf, asn1_tag _tag);
+VF_API int vf_asn1_der_integer_s64_write_byval(vf_buf *buf, asn1_tag _tag, const s64 value);
+
+VF_API size_t vf_le_ber_integer_u64_length(const u64 *value);
+VF_API int vf_le_ber_integer_u64_read(vf_buf *buf, size_t len, u64 *value);
+VF_API int vf_le_ber_integer_u64_write(vf_buf *buf, size_t len, const u64 *value);
+
+VF_API size_t vf_le_ber_integer_u64_length_byval(const u64 value);
+VF_API struct u64_result vf_le_ber_integer_u64_read_byval(vf_buf *buf, size_t len);
+VF_API int vf_le_ber_integer_u64_write_byval(vf_buf *buf, size_t len, const u64 value);
+
+VF_API size_t vf_le_ber_integer_s64_length(const s64 *value);
+VF_API int vf_le_ber_integer_s64_read(vf_buf *buf, size_t len, s64 *value);
+VF_API int vf_le_ber_integer_s64_write(vf_buf *buf, size_t len, const s64 *value);
+
+VF_API size_t vf_le_ber_integer_s64_length_byval(const s64 value);
+VF_API struct s64_result vf_le_ber_integer_s64_read_byval(vf_buf *buf, size_t len);
+VF_API int vf_le_ber_integer_s64_write_byval(vf_buf *buf, size_t len, const s64 value);
+
+/*
+ * encoding statistics
+ *
+ * a vf_stats attached to a buffer counts the class and length of every
+ * f32 and f64 record written or read through it. the counters are plain
+ * integers, use one vf_stats per thread and combine with vf_stats_merge.
+ */
+typedef enum vf_class
+{
+    vf_class_zero,
+    vf_class_inf,
+    vf_class_nan,
+    vf_class_inline,
+    vf_class_pow2,
+    vf_class_unary,
+    vf_class_subnormal,
+    vf_class_full,
+    vf_class_count
+} vf_class;
+
+enum { vf_stats_max_length = 12 };
+
+struct vf_stats
+{
+    u64 records[vf_class_count];
+    u64 length[vf_stats_max_length + 1];
+    u64 header_bytes;
+    u64 exp_bytes;
+    u64 man_bytes;
+};
+typedef struct vf_stats vf_stats;
+
+VF_API void vf_stats_reset(vf_stats *stats);
+VF_API void vf_stats_merge(vf_stats *dst, const vf_stats *src);
+VF_API const char* vf_class_name(vf_class c);
+
+static inline void vf_buf_set_stats(vf_buf *buf, vf_stats *stats)
+{
+    buf->stats = stats;
+}
 
-size_t vf_asn1_ber_tag_length(u64 len);
-int vf_asn1_ber_tag_read(vf_buf *buf, u64 *len);
-int vf_asn1_ber_tag_write(vf_buf *buf, u64 len);
-
-size_t vf_asn1_ber_ident_length(asn1_id _id);
-int vf_asn1_ber_ident_read(vf_buf *buf, asn1_id *_id);
-int vf_asn1_ber_ident_write(vf_buf *buf, asn1_id _id);
-
-size_t vf_asn1_ber_length_length(u64 length);
-int vf_asn1_ber_length_read(vf_buf *buf, u64 *length);
-int vf_asn1_ber_length_write(vf_buf *buf, u64 length);
-
-size_t vf_asn1_ber_integer_u64_length(const u64 *value);
-int vf_asn1_ber_integer_u64_read(vf_buf *buf, size_t len, u64 *value);
-int vf_asn1_ber_integer_u64_write(vf_buf *buf, size_t len, const u64 *value);
-int vf_asn1_der_integer_u64_read(vf_buf *buf, asn1_tag _tag, u64 *value);
-int vf_asn1_der_integer_u64_write(vf_buf *buf, asn1_tag _tag, const u64 *value);
-
-size_t vf_asn1_ber_integer_u64_length_byval(const u64 value);
-struct u64_result vf_asn1_ber_integer_u64_read_byval(vf_buf *buf, size_t len);
-int vf_asn1_ber_integer_u64_write_byval(vf_buf *buf, size_t len, const u64 value);
-struct u64_result vf_asn1_der_integer_u64_read_byval(vf_buf *buf, asn1_tag _tag);
-int vf_asn1_der_integer_u64_write_byval(vf_buf *buf, asn1_tag _tag, const u64 value);
-
-size_t vf_asn1_ber_integer_s64_length(const s64 *value);
-int vf_asn1_ber_integer_s64_read(vf_buf *buf, size_t len, s64 *value);
-int vf_asn1_ber_integer_s64_write(vf_buf *buf, size_t len, const s64 *value);
-int vf_asn1_der_integer_s64_read(vf_buf *buf, asn1_tag _tag, s64 *value);
-int vf_asn1_der_integer_s64_write(vf_buf *buf, asn1_tag _tag, const s64 *value);
-
-size_t vf_asn1_ber_integer_s64_length_byval(const s64 value);
-struct s64_result vf_asn1_ber_integer_s64_read_byval(vf_buf *buf, size_t len);
-int vf_asn1_ber_integer_s64_write_byval(vf_buf *buf, size_t len, const s64 value);
-struct s64_result vf_asn1_der_integer_s64_read_byval(vf_buf *buf, asn1_tag _tag);
-int vf_asn1_der_integer_s64_write_byval(vf_buf *buf, asn1_tag _tag, const s64 value);
-
-size_t vf_le_ber_integer_u64_length(const u64 *value);
-int vf_le_ber_integer_u64_read(vf_buf *buf, size_t len, u64 *value);
-int vf_le_ber_integer_u64_write(vf_buf *buf, size_t len, const u64 *value);
-
-size_t vf_le_ber_integer_u64_length_byval(const u64 value);
-struct u64_result vf_le_ber_integer_u64_read_byval(vf_buf *buf, size_t len);
-int vf_le_ber_integer_u64_write_byval(vf_buf *buf, size_t len, const u64 value);
-
-size_t vf_le_ber_integer_s64_length(const s64 *value);
-int vf_le_ber_integer_s64_read(vf_buf *buf, size_t len, s64 *value);
-int vf_le_ber_integer_s64_write(vf_buf *buf, size_t len, const s64 *value);
-
-size_t vf_le_ber_integer_s64_length_byval(const s64 *value);
-struct s64_result vf_le_ber_integer_s64_read_byval(vf_buf *buf, size_t len);
-int vf_le_ber_integer_s64_write_byval(vf_buf *buf, size_t len, const s64 value);
-
-size_t vf_asn1_ber_real_f64_length(const double *value);
-int vf_asn1_ber_real_f64_read(vf_buf *buf, size_t len, double *value);
-int vf_asn1_ber_real_f64_write(vf_buf *buf, size_t len, const double *value);
-int vf_asn1_der_real_f64_read(vf_buf *buf, asn1_tag _tag, double *value);
-int vf_asn1_der_real_f64_write(vf_buf *buf, asn1_tag _tag, const double *value);
-
-size_t vf_asn1_ber_real_f64_length_byval(const double value);
-struct f64_result vf_asn1_ber_real_f64_read_byval(vf_buf *buf, size_t len);
-int vf_asn1_ber_real_f64_write_byval(vf_buf *buf, size_t len, const double value);
-struct f64_result vf_asn1_der_real_f64_read_byval(vf_buf *buf, asn1_tag _tag);
-int vf_asn1_der_real_f64_write_byval(vf_buf *buf, asn1_tag _tag, const double value);
-
-int vf_f64_read(vf_buf *buf, double *value);
-int vf_f64_write(vf_buf *buf, const double *value);
-struct f64_result vf_f64_read_byval(vf_buf *buf);
-int vf_f64_write_byval(vf_buf *buf, const double value);
-
-int vf_f32_read(vf_buf *buf, float *value);
-int vf_f32_write(vf_buf *buf, const float *value);
-struct f32_result vf_f32_read_byval(vf_buf *buf);
-int vf_f32_write_byval(vf_buf *buf, const float value);
-
-int ieee754_f64_read(vf_buf *buf, double *value);
-int ieee754_f64_write(vf_buf *buf, const double *value);
-struct f64_result ieee754_f64_read_byval(vf_buf *buf);
-int ieee754_f64_write_byval(vf_buf *buf, const double value);
-
-int ieee754_f32_read(vf_buf *buf, float *value);
-int ieee754_f32_write(vf_buf *buf, const float *value);
-struct f32_result ieee754_f32_read_byval(vf_buf *buf);
-int ieee754_f32_write_byval(vf_buf *buf, const float value);
+/*
+ * LEB128 and VLU variable length integers. the array readers decode
+ * count values using the selected kernel.
+ */
+VF_API int vf_leb128_u64_read(vf_buf *buf, u64 *value);
+VF_API int vf_leb128_u64_write(vf_buf *buf, const u64 *value);
+VF_API struct u64_result vf_leb128_u64_read_byval(vf_buf *buf);
+VF_API int vf_leb128_u64_write_byval(vf_buf *buf, const u64 value);
+VF_API int vf_leb128_u64_read_array(vf_buf *buf, u64 *value, size_t count);
+
+VF_API int vf_leb128_s64_read(vf_buf *buf, s64 *value);
+VF_API int vf_leb128_s64_write(vf_buf *buf, const s64 *value);
+VF_API struct s64_result vf_leb128_s64_read_byval(vf_buf *buf);
+VF_API int vf_leb128_s64_write_byval(vf_buf *buf, const s64 value);
+VF_API int vf_leb128_s64_read_array(vf_buf *buf, s64 *value, size_t count);
+
+VF_API int vf_vlu_u64_read(vf_buf *buf, u64 *value);
+VF_API int vf_vlu_u64_write(vf_buf *buf, const u64 *value);
+VF_API struct u64_result vf_vlu_u64_read_byval(vf_buf *buf);
+VF_API int vf_vlu_u64_write_byval(vf_buf *buf, const u64 value);
+VF_API int vf_vlu_u64_read_array(vf_buf *buf, u64 *value, size_t count);
+
+VF_API int vf_vlu_s64_read(vf_buf *buf, s64 *value);
+VF_API int vf_vlu_s64_write(vf_buf *buf, const s64 *value);
+VF_API struct s64_result vf_vlu_s64_read_byval(vf_buf *buf);
+VF_API int vf_vlu_s64_write_byval(vf_buf *buf, const s64 value);
+VF_API int vf_vlu_s64_read_array(vf_buf *buf, s64 *value, size_t count);
+
+/*
+ * unchecked writers store one record at the buffer offset and return its
+ * length. the caller checks that the maximum record length is available,
+ * which allows one check to cover a sequence of records.
+ */
+enum {
+    vf_f64_max_length = 11,
+    vf_f32_max_length = 7,
+    vf_vlu_max_length = 9
+};
+
+VF_API size_t vf_f64_write_unchecked(vf_buf *buf, const double value);
+VF_API size_t vf_f32_write_unchecked(vf_buf *buf, const float value);
+VF_API size_t vf_vlu_u64_write_unchecked(vf_buf *buf, const u64 value);
+VF_API size_t vf_vlu_s64_write_unchecked(vf_buf *buf, const s64 value);
+
+VF_API size_t vf_asn1_ber_real_f64_length(const double *value);
+VF_API int vf_asn1_ber_real_f64_read(vf_buf *buf, size_t len, double *value);
+VF_API int vf_asn1_ber_real_f64_write(vf_buf *buf, size_t len, const double *value);
+VF_API int vf_asn1_der_real_f64_read(vf_buf *buf, asn1_tag _tag, double *value);
+VF_API int vf_asn1_der_real_f64_write(vf_buf *buf, asn1_tag _tag, const double *value);
+
+VF_API size_t vf_asn1_ber_real_f64_length_byval(const double value);
+VF_API struct f64_result vf_asn1_ber_real_f64_read_byval(vf_buf *buf, size_t len);
+VF_API int vf_asn1_ber_real_f64_write_byval(vf_buf *buf, size_t len, const double value);
+VF_API struct f64_result vf_asn1_der_real_f64_read_byval(vf_buf *buf, asn1_tag _tag);
+VF_API int vf_asn1_der_real_f64_write_byval(vf_buf *buf, asn1_tag _tag, const double value);
+
+VF_API size_t vf_asn1_ber_real_f32_length(const float *value);
+VF_API int vf_asn1_ber_real_f32_read(vf_buf *buf, size_t len, float *value);
+VF_API int vf_asn1_ber_real_f32_write(vf_buf *buf, size_t len, const float *value);
+VF_API int vf_asn1_der_real_f32_read(vf_buf *buf, asn1_tag _tag, float *value);
+VF_API int vf_asn1_der_real_f32_write(vf_buf *buf, asn1_tag _tag, const float *value);
+
+VF_API size_t vf_asn1_ber_real_f32_length_byval(const float value);
+VF_API struct f32_result vf_asn1_ber_real_f32_read_byval(vf_buf *buf, size_t len);
+VF_API int vf_asn1_ber_real_f32_write_byval(vf_buf *buf, size_t len, const float value);
+VF_API struct f32_result vf_asn1_der_real_f32_read_byval(vf_buf *buf, asn1_tag _tag);
+VF_API int vf_asn1_der_real_f32_write_byval(vf_buf *buf, asn1_tag _tag, const float value);
+
+#if defined(VF_HAS_F80)
+VF_API size_t vf_asn1_ber_real_f80_length(const f80 *value);
+VF_API int vf_asn1_ber_real_f80_read(vf_buf *buf, size_t len, f80 *value);
+VF_API int vf_asn1_ber_real_f80_write(vf_buf *buf, size_t len, const f80 *value);
+VF_API int vf_asn1_der_real_f80_read(vf_buf *buf, asn1_tag _tag, f80 *value);
+VF_API int vf_asn1_der_real_f80_write(vf_buf *buf, asn1_tag _tag, const f80 *value);
+
+VF_API size_t vf_asn1_ber_real_f80_length_byval(const f80 value);
+VF_API struct f80_result vf_asn1_ber_real_f80_read_byval(vf_buf *buf, size_t len);
+VF_API int vf_asn1_ber_real_f80_write_byval(vf_buf *buf, size_t len, const f80 value);
+VF_API struct f80_result vf_asn1_der_real_f80_read_byval(vf_buf *buf, asn1_tag _tag);
+VF_API int vf_asn1_der_real_f80_write_byval(vf_buf *buf, asn1_tag _tag, const f80 value);
+#endif
+
+#if defined(VF_HAS_F128)
+VF_API size_t vf_asn1_ber_real_f128_length(const f128 *value);
+VF_API int vf_asn1_ber_real_f128_read(vf_buf *buf, size_t len, f128 *value);
+VF_API int vf_asn1_ber_real_f128_write(vf_buf *buf, size_t len, const f128 *value);
+VF_API int vf_asn1_der_real_f128_read(vf_buf *buf, asn1_tag _tag, f128 *value);
+VF_API int vf_asn1_der_real_f128_write(vf_buf *buf, asn1_tag _tag, const f128 *value);
+
+VF_API size_t vf_asn1_ber_real_f128_length_byval(const f128 value);
+VF_API struct f128_result vf_asn1_ber_real_f128_read_byval(vf_buf *buf, size_t len);
+VF_API int vf_asn1_ber_real_f128_write_byval(vf_buf *buf, size_t len, const f128 value);
+VF_API struct f128_result vf_asn1_der_real_f128_read_byval(vf_buf *buf, asn1_tag _tag);
+VF_API int vf_asn1_der_real_f128_write_byval(vf_buf *buf, asn1_tag _tag, const f128 value);
+#endif
+
+/*
+ * DER SEQUENCE OF REAL. the reader decodes at most *count elements and
+ * sets *count to the number decoded, also when it fails.
+ */
+VF_API int vf_asn1_der_real_f64_read_array(vf_buf *buf, asn1_tag _tag, double *value, size_t *count);
+VF_API int vf_asn1_der_real_f64_write_array(vf_buf *buf, asn1_tag _tag, const double *value, size_t count);
+
+VF_API int vf_f64_read(vf_buf *buf, double *value);
+VF_API int vf_f64_write(vf_buf *buf, const double *value);
+VF_API struct f64_result vf_f64_read_byval(vf_buf *buf);
+VF_API int vf_f64_write_byval(vf_buf *buf, const double value);
+
+VF_API int vf_f32_read(vf_buf *buf, float *value);
+VF_API int vf_f32_write(vf_buf *buf, const float *value);
+VF_API struct f32_result vf_f32_read_byval(vf_buf *buf);
+VF_API int vf_f32_write_byval(vf_buf *buf, const float value);
+
+VF_API int vf_f64_read_array(vf_buf *buf, double *value, size_t count);
+VF_API int vf_f64_write_array(vf_buf *buf, const double *value, size_t count);
+VF_API int vf_f32_read_array(vf_buf *buf, float *value, size_t count);
+VF_API int vf_f32_write_array(vf_buf *buf, const float *value, size_t count);
+
+/*
+ * vf_f64_read_upto and vf_f32_read_upto decode at most *count records,
+ * stopping at the end of the buffer, and set *count to the number read.
+ * they return -1 at a truncated or invalid record, after the records
+ * before it.
+ */
+VF_API int vf_f64_read_upto(vf_buf *buf, double *value, size_t *count);
+VF_API int vf_f32_read_upto(vf_buf *buf, float *value, size_t *count);
+
+/*
+ * packed block arrays. blocks of 64 values share an exponent base and
+ * width and a mantissa width and are bit-packed at fixed width, values
+ * that do not fit follow the block as vf128 records. this is a separate
+ * format from the record arrays, read it with vf_f64_read_packed.
+ */
+VF_API int vf_f64_read_packed(vf_buf *buf, double *value, size_t count);
+VF_API int vf_f64_write_packed(vf_buf *buf, const double *value, size_t count);
+
+/*
+ * shared exponent blocks (lossy). block values of 1-64 elements share
+ * the exponent of their largest magnitude and each element keeps a sign
+ * and a bits wide magnitude, 1-24 bits for f32 and 1-31 bits for f64,
+ * rounded to nearest even. blocks with infinities or NaNs are stored
+ * exactly. the block size and width are stored in the stream.
+ */
+VF_API int vf_f32_read_mx(vf_buf *buf, float *value, size_t count);
+VF_API int vf_f32_write_mx(vf_buf *buf, const float *value, size_t count, size_t block, int bits);
+VF_API int vf_f64_read_mx(vf_buf *buf, double *value, size_t count);
+VF_API int vf_f64_write_mx(vf_buf *buf, const double *value, size_t count, size_t block, int bits);
+
+/*
+ * entropy coded arrays. blocks of 4096 records store their header bytes
+ * Huffman coded in two interleaved bitstreams ahead of the payloads, and
+ * fall back to plain records when coding does not make them smaller.
+ * this is a separate format, read it with vf_f64_read_coded.
+ */
+VF_API int vf_f64_read_coded(vf_buf *buf, double *value, size_t count);
+VF_API int vf_f64_write_coded(vf_buf *buf, const double *value, size_t count);
+
+/*
+ * delta-of-delta arrays. blocks of 1024 values are scaled by a power of
+ * ten to integers that convert back exactly and store their second
+ * differences as VLU, so a series with a nearly constant stride such as
+ * timestamps takes about a byte per value. blocks without an exact scale
+ * are plain records. this is a separate format, read it with
+ * vf_f64_read_dod.
+ */
+VF_API int vf_f64_read_dod(vf_buf *buf, double *value, size_t count);
+VF_API int vf_f64_write_dod(vf_buf *buf, const double *value, size_t count);
+
+/*
+ * joint exponent tuples. vf_c64 codes a complex double as two doubles,
+ * real then imaginary, as laid out by std::complex<double> and C99
+ * double complex. vf_vec3 codes three floats. the components share one
+ * exponent and have a mantissa of common width, or are written as
+ * independent vf128 records when that is shorter. the array functions
+ * take count tuples.
+ */
+enum { vf_c64_max_length = 23, vf_vec3_max_length = 22 };
+
+VF_API int vf_c64_read(vf_buf *buf, double *value);
+VF_API int vf_c64_write(vf_buf *buf, const double *value);
+VF_API int vf_c64_read_array(vf_buf *buf, double *value, size_t count);
+VF_API int vf_c64_write_array(vf_buf *buf, const double *value, size_t count);
+
+VF_API int vf_vec3_read(vf_buf *buf, float *value);
+VF_API int vf_vec3_write(vf_buf *buf, const float *value);
+VF_API int vf_vec3_read_array(vf_buf *buf, float *value, size_t count);
+VF_API int vf_vec3_write_array(vf_buf *buf, const float *value, size_t count);
+
+/*
+ * fixed-dimension vectors. each vector of dim floats has a three byte
+ * header with its largest exponent and the widths of the exponent deltas
+ * and mantissas, followed by one bit-packed field per element, at most
+ * 3 + 4 * dim bytes. with bits 24 the values decode bit exactly, smaller
+ * values round each element to bits significant bits (lossy). the reader
+ * must pass the dim used by the writer.
+ */
+VF_API int vf_f32_read_vec(vf_buf *buf, float *value, size_t dim, size_t count);
+VF_API int vf_f32_write_vec(vf_buf *buf, const float *value, size_t dim, size_t count, int bits);
+
+/*
+ * schema records. a schema describes the fields of a struct by offset
+ * and type, and vf_schema_write encodes count structs stride bytes apart
+ * as their fields in order, floats as vf128 records and integers as VLU.
+ * the worst-case record size is checked once per record. narrow integer
+ * fields fail to read if the stored value does not fit.
+ */
+typedef enum {
+    vf_field_f32,
+    vf_field_f64,
+    vf_field_s32,
+    vf_field_u32,
+    vf_field_s64,
+    vf_field_u64,
+} vf_field_type;
+
+struct vf_field
+{
+    size_t offset;
+    vf_field_type type;
+};
+
+typedef struct vf_field vf_field;
+typedef struct vf_schema vf_schema;
+
+VF_API vf_schema* vf_schema_new(const vf_field *field, size_t count, size_t stride);
+VF_API void vf_schema_destroy(vf_schema *schema);
+VF_API size_t vf_schema_max_length(const vf_schema *schema);
+VF_API int vf_schema_read(vf_buf *buf, const vf_schema *schema, void *record, size_t count);
+VF_API int vf_schema_write(vf_buf *buf, const vf_schema *schema, const void *record, size_t count);
+
+/*
+ * cross-precision arrays. vf_f32_read_from_any and vf_f64_read_from_any
+ * decode count records written from vf_field_f32 or vf_field_f64 values,
+ * rounding with mode. from is needed because renormalized subnormals are
+ * relative to the exponent range of the type that was written.
+ */
+VF_API int vf_f32_read_from_any(vf_buf *buf, float *value, size_t count,
+    vf_field_type from, vf_rounding mode);
+VF_API int vf_f64_read_from_any(vf_buf *buf, double *value, size_t count,
+    vf_field_type from, vf_rounding mode);
+
+/*
+ * decimal string codecs. vf_f64_write_decimal encodes a decimal string
+ * (strtod syntax without hexadecimal) and vf_f64_read_decimal decodes a
+ * value into the shortest string that round-trips, returning its length
+ * or -1 if the value or its terminating NUL does not fit in cap.
+ */
+VF_API int vf_f64_write_decimal(vf_buf *buf, const char *str, size_t len);
+VF_API int vf_f64_read_decimal(vf_buf *buf, char *str, size_t cap);
+
+/*
+ * bulk transcoders between DER REAL TLVs and vf128 f64 records. count
+ * values are converted from src to dst without going through double
+ * for values exact in binary64. a TLV that is not a universal REAL is
+ * an error.
+ */
+VF_API int vf_transcode_asn1_to_vf128(vf_buf *dst, vf_buf *src, size_t count);
+VF_API int vf_transcode_vf128_to_asn1(vf_buf *dst, vf_buf *src, size_t count);
+
+VF_API int ieee754_f64_read(vf_buf *buf, double *value);
+VF_API int ieee754_f64_write(vf_buf *buf, const double *value);
+VF_API struct f64_result ieee754_f64_read_byval(vf_buf *buf);
+VF_API int ieee754_f64_write_byval(vf_buf *buf, const double value);
+
+VF_API int ieee754_f32_read(vf_buf *buf, float *value);
+VF_API int ieee754_f32_write(vf_buf *buf, const float *value);
+VF_API struct f32_result ieee754_f32_read_byval(vf_buf *buf);
+VF_API int ieee754_f32_write_byval(vf_buf *buf, const float value);
+
+/*
+ * kernel dispatch
+ *
+ * the array codecs are compiled for several instruction set levels and
+ * the best level supported by the processor is selected at load time.
+ * the environment variable VF128_KERNEL=scalar|bmi2|avx2|avx512 limits
+ * the selection, and vf_kernel_set can change it at runtime.
+ */
+
+typedef enum {
+    vf_kernel_scalar            = 0,
+    vf_kernel_bmi2              = 1,
+    vf_kernel_avx2              = 2,
+    vf_kernel_avx512            = 3,
+} vf_kernel_isa;
+
+VF_API vf_kernel_isa vf_kernel_get(void);
+VF_API vf_kernel_isa vf_kernel_best(void);
+VF_API int vf_kernel_set(vf_kernel_isa isa);
+VF_API const char* vf_kernel_name(vf_kernel_isa isa);
 
 #ifdef __cplusplus
 }
 #endif
+
+#if defined(VF128_INLINE) && VF128_INLINE
+#include "vf128.cc"
+#endif
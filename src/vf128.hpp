@@ -0,0 +1,278 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+
+#include "vf128.h"
+
+/*
+ * C++17 interface
+ *
+ * vf::write(buf, a, b, c) and vf::read<double, float, s64>(buf) select
+ * the codec of each value at compile time. floating-point values are
+ * vf128 records and integers are VLU, so the bytes are the same as the
+ * corresponding sequence of C calls. the maximum length of the values is
+ * a constant and one capacity check covers all of them. with VF128_INLINE
+ * the codecs are inlined into the caller.
+ *
+ * a write or read that fails leaves the buffer offset where it was.
+ */
+
+namespace vf {
+
+template <typename T, typename = void>
+struct codec;
+
+template <>
+struct codec<double>
+{
+    static constexpr size_t max_length = vf_f64_max_length;
+    static size_t write_unchecked(vf_buf *buf, double v) { return vf_f64_write_unchecked(buf, v); }
+    static int write(vf_buf *buf, double v) { return vf_f64_write_byval(buf, v); }
+    static int read(vf_buf *buf, double &v) { return vf_f64_read(buf, &v); }
+};
+
+template <>
+struct codec<float>
+{
+    static constexpr size_t max_length = vf_f32_max_length;
+    static size_t write_unchecked(vf_buf *buf, float v) { return vf_f32_write_unchecked(buf, v); }
+    static int write(vf_buf *buf, float v) { return vf_f32_write_byval(buf, v); }
+    static int read(vf_buf *buf, float &v) { return vf_f32_read(buf, &v); }
+};
+
+/* std::complex<double> is laid out as two doubles, real then imaginary */
+template <>
+struct codec<std::complex<double>>
+{
+    static constexpr size_t max_length = vf_c64_max_length;
+    static size_t write_unchecked(vf_buf *buf, const std::complex<double> &v)
+    {
+        size_t start = buf->data_offset;
+        vf_c64_write(buf, reinterpret_cast<const double*>(&v));
+        return buf->data_offset - start;
+    }
+    static int write(vf_buf *buf, const std::complex<double> &v)
+    {
+        return vf_c64_write(buf, reinterpret_cast<const double*>(&v));
+    }
+    static int read(vf_buf *buf, std::complex<double> &v)
+    {
+        return vf_c64_read(buf, reinterpret_cast<double*>(&v));
+    }
+};
+
+/* integers narrower than 64 bits fail to read values that do not fit */
+template <typename T>
+struct codec<T, std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>>>
+{
+    static constexpr size_t max_length = vf_vlu_max_length;
+    static size_t write_unchecked(vf_buf *buf, T v) { return vf_vlu_s64_write_unchecked(buf, (s64)v); }
+    static int write(vf_buf *buf, T v) { return vf_vlu_s64_write_byval(buf, (s64)v); }
+    static int read(vf_buf *buf, T &v)
+    {
+        s64 x;
+        if (vf_vlu_s64_read(buf, &x) < 0) return -1;
+        if (x < (s64)std::numeric_limits<T>::min() || x > (s64)std::numeric_limits<T>::max()) return -1;
+        v = (T)x;
+        return 0;
+    }
+};
+
+template <typename T>
+struct codec<T, std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T>>>
+{
+    static constexpr size_t max_length = vf_vlu_max_length;
+    static size_t write_unchecked(vf_buf *buf, T v) { return vf_vlu_u64_write_unchecked(buf, (u64)v); }
+    static int write(vf_buf *buf, T v) { return vf_vlu_u64_write_byval(buf, (u64)v); }
+    static int read(vf_buf *buf, T &v)
+    {
+        u64 x;
+        if (vf_vlu_u64_read(buf, &x) < 0) return -1;
+        if (x > (u64)std::numeric_limits<T>::max()) return -1;
+        v = (T)x;
+        return 0;
+    }
+};
+
+template <typename... Ts>
+inline constexpr size_t max_length = (codec<std::decay_t<Ts>>::max_length + ... + 0);
+
+template <typename... Ts>
+inline int write(vf_buf *buf, const Ts&... v)
+{
+    size_t start = buf->data_offset;
+
+    if (vf_buf_check_capacity(buf, max_length<Ts...>) == 0) {
+        (codec<Ts>::write_unchecked(buf, v), ...);
+        return 0;
+    }
+    /* near the end of the buffer, fall back to checked writes */
+    if ((... && (codec<Ts>::write(buf, v) == 0))) return 0;
+    buf->data_offset = start;
+    return -1;
+}
+
+template <typename... Ts>
+inline int write(vf_buf *buf, const std::tuple<Ts...> &t)
+{
+    return std::apply([buf](const auto&... v) { return vf::write(buf, v...); }, t);
+}
+
+template <typename... Ts>
+inline int read(vf_buf *buf, Ts&... v)
+{
+    size_t start = buf->data_offset;
+
+    if ((... && (codec<Ts>::read(buf, v) == 0))) return 0;
+    buf->data_offset = start;
+    return -1;
+}
+
+template <typename... Ts>
+inline int read(vf_buf *buf, std::tuple<Ts...> &t)
+{
+    return std::apply([buf](auto&... v) { return vf::read(buf, v...); }, t);
+}
+
+/* reads into the references of std::tie(a, b, c) */
+template <typename... Ts>
+inline int read(vf_buf *buf, std::tuple<Ts&...> &&t)
+{
+    return std::apply([buf](auto&... v) { return vf::read(buf, v...); }, t);
+}
+
+template <typename... Ts>
+inline std::optional<std::tuple<Ts...>> read(vf_buf *buf)
+{
+    std::tuple<Ts...> t;
+    if (vf::read(buf, t) < 0) return std::nullopt;
+    return t;
+}
+
+inline int write_array(vf_buf *buf, const std::complex<double> *v, size_t count)
+{
+    return vf_c64_write_array(buf, reinterpret_cast<const double*>(v), count);
+}
+
+inline int read_array(vf_buf *buf, std::complex<double> *v, size_t count)
+{
+    return vf_c64_read_array(buf, reinterpret_cast<double*>(v), count);
+}
+
+/*
+ * decode_view<T> is an input range over the f64 or f32 records of a
+ * span. the iterator decodes on increment from a batch it refills with
+ * vf_f64_read_upto, so a scan runs in constant memory with decode fused
+ * into the loop. iteration stops at the end of the span or at the first
+ * invalid record, which sets error().
+ */
+template <typename T>
+struct decode_traits;
+
+template <>
+struct decode_traits<double>
+{
+    static int read_upto(vf_buf *buf, double *v, size_t *n) { return vf_f64_read_upto(buf, v, n); }
+};
+
+template <>
+struct decode_traits<float>
+{
+    static int read_upto(vf_buf *buf, float *v, size_t *n) { return vf_f32_read_upto(buf, v, n); }
+};
+
+template <typename T>
+class decode_view
+{
+public:
+    enum : size_t { batch = 256 };
+
+    class iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        iterator() : _view(nullptr), _buf(), _pos(0), _count(0) {}
+
+        explicit iterator(const decode_view *view)
+            : _view(view), _buf(), _pos(0), _count(0)
+        {
+            _buf.data = view->_data;
+            _buf.data_size = view->_size;
+            _buf.data_pad = view->_pad;
+            refill();
+        }
+
+        reference operator*() const { return _batch[_pos]; }
+        pointer operator->() const { return &_batch[_pos]; }
+
+        iterator& operator++()
+        {
+            if (++_pos == _count) refill();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        /* iterators are equal at the end, or at the same record of a view */
+        bool operator==(const iterator &o) const
+        {
+            if (_count == 0 || o._count == 0) return _count == o._count;
+            return _view == o._view && _buf.data_offset - _count + _pos ==
+                o._buf.data_offset - o._count + o._pos;
+        }
+
+        bool operator!=(const iterator &o) const { return !(*this == o); }
+
+    private:
+        void refill()
+        {
+            size_t n = batch;
+            if (decode_traits<T>::read_upto(&_buf, _batch, &n) < 0) _view->_error = true;
+            _pos = 0;
+            _count = n;
+        }
+
+        const decode_view *_view;
+        vf_buf _buf;
+        size_t _pos;
+        size_t _count;
+        T _batch[batch];
+    };
+
+    explicit decode_view(vf_span span)
+        : _data((char*)span.data), _size(span.length), _pad(0), _error(false) {}
+
+    /* the remaining records of buf, using its padding for fast loads */
+    explicit decode_view(const vf_buf *buf)
+        : _data(buf->data + buf->data_offset), _size(buf->data_size - buf->data_offset),
+          _pad(buf->data_pad), _error(false) {}
+
+    iterator begin() const { return iterator(this); }
+    iterator end() const { return iterator(); }
+
+    bool error() const { return _error; }
+
+private:
+    char *_data;
+    size_t _size;
+    size_t _pad;
+    mutable bool _error;
+};
+
+}
@@ -0,0 +1,341 @@
+#undef NDEBUG
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "vf128.h"
+
+#ifdef _WIN32
+#define USE_MMAP 0
+#else
+#define USE_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std::chrono;
+
+/*
+ * analyze_io reports the vf128 size of raw f32/f64 and NumPy .npy files:
+ * the size, the encoding class mix, encode and decode throughput, and
+ * projected sizes when mantissas are rounded to a byte budget or to an
+ * error bound.
+ */
+
+enum elem_type { elem_f32, elem_f64 };
+
+struct input_file
+{
+    std::string path;
+    elem_type type;
+    const char *data;
+    size_t count;
+    const void *map;
+    size_t map_size;
+};
+
+static bool map_file(const char *path, input_file &f)
+{
+#if USE_MMAP
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+    f.map = p;
+    f.map_size = (size_t)st.st_size;
+#else
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return false;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(fp);
+        return false;
+    }
+    char *p = (char*)malloc((size_t)size);
+    if (fread(p, 1, (size_t)size, fp) != (size_t)size) {
+        free(p);
+        fclose(fp);
+        return false;
+    }
+    fclose(fp);
+    f.map = p;
+    f.map_size = (size_t)size;
+#endif
+    return true;
+}
+
+static void unmap_file(input_file &f)
+{
+#if USE_MMAP
+    munmap((void*)f.map, f.map_size);
+#else
+    free((void*)f.map);
+#endif
+}
+
+/*
+ * NumPy format 1.0-3.0 header with a little-endian '<f4' or '<f8' descr,
+ * C order. the shape is flattened.
+ */
+static bool parse_npy(input_file &f)
+{
+    const char *p = (const char*)f.map;
+    size_t hdr_len, off;
+
+    if (f.map_size < 10 || memcmp(p, "\x93NUMPY", 6) != 0) return false;
+    if (p[6] == 1) {
+        hdr_len = (u8)p[8] | ((size_t)(u8)p[9] << 8);
+        off = 10;
+    } else if (f.map_size >= 12) {
+        hdr_len = (u8)p[8] | ((size_t)(u8)p[9] << 8) |
+            ((size_t)(u8)p[10] << 16) | ((size_t)(u8)p[11] << 24);
+        off = 12;
+    } else {
+        return false;
+    }
+    if (off + hdr_len > f.map_size) return false;
+
+    std::string hdr(p + off, hdr_len);
+    if (hdr.find("'fortran_order': True") != std::string::npos) return false;
+    if (hdr.find("'<f8'") != std::string::npos) {
+        f.type = elem_f64;
+    } else if (hdr.find("'<f4'") != std::string::npos) {
+        f.type = elem_f32;
+    } else {
+        return false;
+    }
+    f.data = p + off + hdr_len;
+    f.count = (f.map_size - off - hdr_len) / (f.type == elem_f64 ? 8 : 4);
+    return true;
+}
+
+static bool ends_with(const std::string &s, const char *sfx)
+{
+    size_t n = strlen(sfx);
+    return s.size() >= n && s.compare(s.size() - n, n, sfx) == 0;
+}
+
+static bool open_input(const char *path, elem_type def, input_file &f)
+{
+    f.path = path;
+    if (!map_file(path, f)) return false;
+    if (ends_with(f.path, ".npy")) {
+        if (!parse_npy(f)) {
+            unmap_file(f);
+            return false;
+        }
+        return true;
+    }
+    f.type = ends_with(f.path, ".f32") ? elem_f32 : ends_with(f.path, ".f64") ? elem_f64 : def;
+    f.data = (const char*)f.map;
+    f.count = f.map_size / (f.type == elem_f64 ? 8 : 4);
+    return true;
+}
+
+/*
+ * round to nearest even keeping bits significant bits, the leading one
+ * included. the stored vf128 mantissa holds the same bits.
+ */
+template <typename T, typename U, int mant_size>
+static T round_mantissa(T x, int bits)
+{
+    int drop = mant_size + 1 - bits;
+    U u;
+    if (drop <= 0 || !std::isfinite(x) || x == 0) return x;
+    memcpy(&u, &x, sizeof(u));
+    u += ((U)1 << (drop - 1)) - 1 + ((u >> drop) & 1);
+    u &= ~(((U)1 << drop) - 1);
+    memcpy(&x, &u, sizeof(u));
+    return x;
+}
+
+/* values are decoded into aligned storage, mmap offsets may be unaligned */
+template <typename T>
+static std::vector<T> load_values(const input_file &f)
+{
+    std::vector<T> v(f.count);
+    memcpy(v.data(), f.data, f.count * sizeof(T));
+    return v;
+}
+
+static int write_array(vf_buf *buf, const float *v, size_t n) { return vf_f32_write_array(buf, v, n); }
+static int write_array(vf_buf *buf, const double *v, size_t n) { return vf_f64_write_array(buf, v, n); }
+static int read_array(vf_buf *buf, float *v, size_t n) { return vf_f32_read_array(buf, v, n); }
+static int read_array(vf_buf *buf, double *v, size_t n) { return vf_f64_read_array(buf, v, n); }
+
+static double elapsed_ns(high_resolution_clock::time_point st)
+{
+    return (double)duration_cast<nanoseconds>(high_resolution_clock::now() - st).count();
+}
+
+template <typename T, typename U, int mant_size>
+static void analyze(const input_file &f, const std::vector<int> &budgets,
+    const std::vector<int> &bits, const std::vector<double> &errors)
+{
+    std::vector<T> in = load_values<T>(f), out(f.count), q(f.count);
+    size_t n = f.count, raw = n * sizeof(T);
+    vf_buf *buf = vf_buf_new(n * 11 + 16);
+    vf_stats stats;
+    double t_enc, t_dec;
+
+    vf_stats_reset(&stats);
+    vf_buf_set_stats(buf, &stats);
+    assert(!write_array(buf, in.data(), n));
+    vf_buf_set_stats(buf, nullptr);
+    size_t size = vf_buf_offset(buf);
+
+    /* best of three, the first pass above has touched every page */
+    t_enc = t_dec = 1e30;
+    for (int r = 0; r < 3; r++) {
+        auto st = high_resolution_clock::now();
+        vf_buf_reset(buf);
+        assert(!write_array(buf, in.data(), n));
+        t_enc = std::min(t_enc, elapsed_ns(st));
+        st = high_resolution_clock::now();
+        vf_buf_reset(buf);
+        assert(!read_array(buf, out.data(), n));
+        t_dec = std::min(t_dec, elapsed_ns(st));
+    }
+
+    printf("%s: %s, %zu values, %zu bytes\n", f.path.c_str(),
+        f.type == elem_f64 ? "f64" : "f32", n, raw);
+    printf("  vf128   %12zu bytes %8.3f bytes/value %7.2f%% of raw\n",
+        size, (double)size / n, 100. * size / raw);
+    printf("  encode  %12.3f ns/value %8.3f GB/s\n", t_enc / n, raw / t_enc);
+    printf("  decode  %12.3f ns/value %8.3f GB/s\n", t_dec / n, raw / t_dec);
+
+    printf("\n  %-10s %12s %8s\n", "class", "records", "%");
+    for (int c = 0; c < vf_class_count; c++) {
+        if (!stats.records[c]) continue;
+        printf("  %-10s %12llu %7.2f%%\n", vf_class_name((vf_class)c),
+            stats.records[c], 100. * stats.records[c] / n);
+    }
+    printf("\n  %-10s %12s %8s\n", "length", "records", "%");
+    for (int l = 1; l <= vf_stats_max_length; l++) {
+        if (!stats.length[l]) continue;
+        printf("  %-10d %12llu %7.2f%%\n", l, stats.length[l], 100. * stats.length[l] / n);
+    }
+    printf("\n  header %llu, exponent %llu, mantissa %llu bytes\n",
+        stats.header_bytes, stats.exp_bytes, stats.man_bytes);
+
+    if (budgets.empty() && bits.empty() && errors.empty()) {
+        puts("");
+        vf_buf_destroy(buf);
+        return;
+    }
+
+    /*
+     * a mantissa byte budget of b bytes keeps 8b significant bits and
+     * round to nearest with p bits bounds the relative error by 2^-p.
+     */
+    std::vector<std::pair<std::string,int>> modes;
+    char name[32];
+    for (int b : budgets) modes.push_back({ "budget=" + std::to_string(b), b * 8 });
+    for (int b : bits) modes.push_back({ "bits=" + std::to_string(b), b });
+    for (double e : errors) {
+        snprintf(name, sizeof(name), "error=%g", e);
+        modes.push_back({ name, std::max(1, (int)ceil(-log2(e))) });
+    }
+
+    printf("\n  %-12s %5s %12s %12s %8s %12s\n",
+        "projection", "bits", "bytes", "bytes/value", "% raw", "max rel err");
+    for (auto &m : modes) {
+        double max_err = 0.;
+        for (size_t i = 0; i < n; i++) {
+            q[i] = round_mantissa<T,U,mant_size>(in[i], m.second);
+            if (std::isfinite(in[i]) && in[i] != 0) {
+                double e = fabs(((double)q[i] - (double)in[i]) / (double)in[i]);
+                if (e > max_err) max_err = e;
+            }
+        }
+        vf_buf_reset(buf);
+        assert(!write_array(buf, q.data(), n));
+        size_t qs = vf_buf_offset(buf);
+        printf("  %-12s %5d %12zu %12.3f %7.2f%% %12.3g\n", m.first.c_str(),
+            m.second < mant_size + 1 ? m.second : mant_size + 1,
+            qs, (double)qs / n, 100. * qs / raw, max_err);
+    }
+    puts("");
+
+    vf_buf_destroy(buf);
+}
+
+template <typename T>
+static std::vector<T> parse_list(const char *s)
+{
+    std::vector<T> v;
+    while (*s) {
+        char *end;
+        double x = strtod(s, &end);
+        if (end == s) break;
+        if (x > 0) v.push_back((T)x);
+        s = *end == ',' ? end + 1 : end;
+    }
+    return v;
+}
+
+int main(int argc, char **argv)
+{
+    elem_type def = elem_f64;
+    std::vector<int> budgets, bits;
+    std::vector<double> errors;
+    int files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--f32") == 0) {
+            def = elem_f32;
+        } else if (strcmp(argv[i], "--f64") == 0) {
+            def = elem_f64;
+        } else if (strncmp(argv[i], "--budget=", 9) == 0) {
+            budgets = parse_list<int>(argv[i] + 9);
+        } else if (strncmp(argv[i], "--bits=", 7) == 0) {
+            bits = parse_list<int>(argv[i] + 7);
+        } else if (strncmp(argv[i], "--error=", 8) == 0) {
+            errors = parse_list<double>(argv[i] + 8);
+        } else {
+            files++;
+        }
+    }
+    if (files == 0) {
+        fprintf(stderr, "usage: %s [--f32|--f64] [--budget=<bytes>(,…)] "
+            "[--bits=<bits>(,…)] [--error=<rel>(,…)] <file>…\n", argv[0]);
+        fprintf(stderr, "\nraw little-endian .f32/.f64 files (default --f64) "
+            "or NumPy .npy files\n");
+        fprintf(stderr, "\ne.g.   %s --budget=2,3 --error=1e-3,1e-6 weights.npy\n", argv[0]);
+        exit(1);
+    }
+
+    printf("kernel: %s\n\n", vf_kernel_name(vf_kernel_get()));
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0) continue;
+        input_file f;
+        if (!open_input(argv[i], def, f)) {
+            fprintf(stderr, "%s: cannot read or unsupported format\n", argv[i]);
+            continue;
+        }
+        if (f.count == 0) {
+            fprintf(stderr, "%s: no values\n", argv[i]);
+        } else if (f.type == elem_f64) {
+            analyze<double,u64,52>(f, budgets, bits, errors);
+        } else {
+            analyze<float,u32,23>(f, budgets, bits, errors);
+        }
+        unmap_file(f);
+    }
+}
@@ -3,10 +3,18 @@
 #include <cstdlib>
 #include <cassert>
 #include <cstring>
+#include <cerrno>
 #include <cmath>
 #include <chrono>
+#include <random>
+#include <vector>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <atomic>
 
 #include "vf128.h"
+#include "vf128.hpp"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -15,11 +23,153 @@
 #include <time.h>
 #endif
 
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <sched.h>
+#endif
+
 using namespace std::chrono;
 
 typedef signed long long llong;
 typedef unsigned long long ullong;
 
+/*
+ * hardware performance counters
+ *
+ * --perf counts cycles, instructions, branch misses and L1D and LLC read
+ * misses over each timed region with perf_event_open on Linux. counters
+ * that cannot be opened, e.g. in containers without perf access, are
+ * reported as n/a and timing continues without them.
+ */
+
+enum perf_counter
+{
+    perf_cycles,
+    perf_instructions,
+    perf_branch_misses,
+    perf_l1d_misses,
+    perf_llc_misses,
+    perf_counter_count
+};
+
+struct perf_counts
+{
+    double value[perf_counter_count];
+    bool valid[perf_counter_count];
+};
+
+static bool perf_enabled;
+static perf_counts perf_last;
+
+#if defined(__linux__)
+static int perf_fd[perf_counter_count] = { -1, -1, -1, -1, -1 };
+
+static int perf_open_counter(__u32 type, __u64 config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void perf_init()
+{
+    const __u64 cache_read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    int avail = 0;
+
+    perf_fd[perf_cycles] = perf_open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    perf_fd[perf_instructions] = perf_open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    perf_fd[perf_branch_misses] = perf_open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    perf_fd[perf_l1d_misses] = perf_open_counter(PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_L1D | cache_read_miss);
+    perf_fd[perf_llc_misses] = perf_open_counter(PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_LL | cache_read_miss);
+    for (int i = 0; i < perf_counter_count; i++) {
+        avail += perf_fd[i] >= 0;
+    }
+    if (avail == 0) {
+        fprintf(stderr, "perf: counters unavailable (%s), timing only\n", strerror(errno));
+        perf_enabled = false;
+    }
+}
+
+static void perf_begin()
+{
+    for (int i = 0; i < perf_counter_count; i++) {
+        if (perf_fd[i] < 0) continue;
+        ioctl(perf_fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(perf_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+static void perf_end()
+{
+    for (int i = 0; i < perf_counter_count; i++) {
+        __u64 r[3];
+        perf_last.valid[i] = false;
+        if (perf_fd[i] < 0) continue;
+        ioctl(perf_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(perf_fd[i], r, sizeof(r)) != sizeof(r) || r[2] == 0) continue;
+        /* scale when the counter was multiplexed */
+        perf_last.value[i] = (double)r[0] * ((double)r[1] / (double)r[2]);
+        perf_last.valid[i] = true;
+    }
+}
+#else
+static void perf_init()
+{
+    fprintf(stderr, "perf: counters unsupported on this platform, timing only\n");
+    perf_enabled = false;
+}
+static void perf_begin() {}
+static void perf_end() {}
+#endif
+
+static high_resolution_clock::time_point bench_start()
+{
+    if (perf_enabled) perf_begin();
+    return high_resolution_clock::now();
+}
+
+static high_resolution_clock::time_point bench_stop()
+{
+    auto t = high_resolution_clock::now();
+    if (perf_enabled) perf_end();
+    return t;
+}
+
+static void print_perf(const char *prefix, const perf_counts &pc, double ops)
+{
+    static const char *names[] = { "cycles", "instr", "br-miss", "l1d-miss", "llc-miss" };
+    if (!perf_enabled) return;
+    printf("%s", prefix);
+    for (int i = 0; i < perf_counter_count; i++) {
+        if (pc.valid[i]) {
+            printf(" %s/op %.3f", names[i], pc.value[i] / ops);
+        } else {
+            printf(" %s/op n/a", names[i]);
+        }
+        if (i == perf_instructions) {
+            if (pc.valid[perf_cycles] && pc.valid[perf_instructions] && pc.value[perf_cycles] > 0) {
+                printf(" IPC %.2f", pc.value[perf_instructions] / pc.value[perf_cycles]);
+            } else {
+                printf(" IPC n/a");
+            }
+        }
+    }
+    printf("\n");
+}
+
 static void _millisleep(llong sleep_ms)
 {
 #ifdef _WIN32
@@ -42,6 +192,10 @@ static void _millisleep(llong sleep_ms)
 char pi_str[] = "3.141592653589793";
 char pi_strf[] = "3.141592";
 unsigned char pi_asn[] = { 0x09, 0x09, 0x80, 0xD0, 0x03, 0x24, 0x3F, 0x6A, 0x88, 0x85, 0xA3 };
+unsigned char pi_asn_f32[] = { 0x09, 0x05, 0x80, 0xED, 0x19, 0x21, 0xFB };
+unsigned char pi_asn_b16[] = { 0x09, 0x09, 0xA0, 0xF4, 0x03, 0x24, 0x3F, 0x6A, 0x88, 0x85, 0xA3 };
+unsigned char pi_asn_nr3[] = { 0x09, 0x16, 0x03, '3', '1', '4', '1', '5', '9', '2', '6',
+    '5', '3', '5', '8', '9', '7', '9', '3', '.', 'E', '-', '1', '5' };
 unsigned long long i17 = 72057594037927935;
 char i17_str[] = "72057594037927935";
 unsigned int i10 = 2147483648;
@@ -50,6 +204,8 @@ unsigned char i17_asn[] = { 0x02, 0x08, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
 unsigned long long i12 = 18014398509481984;
 unsigned char i12_leb[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x20 };
 unsigned char i12_vlu[] = { 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40 };
+unsigned char i12_asn[] = { 0x02, 0x07, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+unsigned char i12_le[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40 };
 unsigned char pi_vf8[] = { 0x97, 0x01, 0xA3, 0x85, 0x88, 0x6A, 0x3F, 0x24, 0x03 };
 unsigned char pi_f64[] = { 0x18, 0x2d, 0x44, 0x54, 0xfb, 0x21, 0x09, 0x40 };
 unsigned char pi_f32[] = { 0xd8, 0x0f, 0x49, 0x40 };
@@ -59,11 +215,11 @@ struct bench_result { const char *name; llong count; double t; llong size; };
 static bench_result bench_ascii_strtod(llong count)
 {
     double f;
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         f = strtod(pi_str, NULL);
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     assert(fabs(f - 3.141592) < 0.0001);
 
@@ -75,11 +231,11 @@ static bench_result bench_ascii_strtod(llong count)
 static bench_result bench_ascii_strtof(llong count)
 {
     float f;
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         f = strtof(pi_strf, NULL);
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     assert(fabsf(f - 3.141592f) < 0.0001f);
 
@@ -91,11 +247,11 @@ static bench_result bench_ascii_snprintf_f(llong count)
 {
     char buf[32];
     const float pi = 3.141592f;
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         assert(snprintf(buf, sizeof(buf), "%.8lf", pi) > 0);
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     assert(strncmp(buf,"3.141592", 8) == 0);
 
@@ -108,11 +264,11 @@ static bench_result bench_ascii_snprintf_d(llong count)
 {
     char buf[32];
     const double pi = 3.141592653589793;
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         assert(snprintf(buf, sizeof(buf), "%.16lf", pi) > 0);
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     assert(strncmp(buf,"3.141592653589793", 17) == 0);
 
@@ -120,256 +276,1456 @@ static bench_result bench_ascii_snprintf_d(llong count)
     return bench_result { "f64-write-snprintf-dec", count, t, 8 * count };
 }
 
+static bench_result bench_vf64_write_decimal(llong count)
+{
+    double f;
+    vf_buf *buf = vf_buf_new(128);
+    size_t len = strlen(pi_str);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_write_decimal(buf, pi_str, len));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_f64_read(buf, &f);
+    assert(f == 3.141592653589793);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-write-dec", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_read_decimal(llong count)
+{
+    char str[32];
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(vf_f64_read_decimal(buf, str, sizeof(str)) > 0);
+    }
+    auto et = bench_stop();
+
+    assert(strcmp(str, pi_str) == 0);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-read-dec", count, t, 8 * count };
+}
+
 static bench_result bench_asn1_read_byptr_real(llong count)
 {
     double f;
     vf_buf *buf = vf_buf_new(128);
     vf_buf_write_bytes(buf, (const char*)pi_asn, sizeof(pi_asn));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f64_read(buf, asn1_tag_real, &f));
+    }
+    auto et = bench_stop();
+
+    assert(fabs(f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-asn.1-read-byptr", count, t, 8 * count };
+}
+
+static bench_result bench_asn1_read_byval_real(llong count)
+{
+    f64_result r;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_asn, sizeof(pi_asn));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        r = vf_asn1_der_real_f64_read_byval(buf, asn1_tag_real);
+        assert(!r.error);
+    }
+    auto et = bench_stop();
+
+    assert(fabs(r.value - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-asn.1-read-byval", count, t, 8 * count };
+}
+
+static bench_result bench_asn1_read_base16_real(llong count)
+{
+    double f;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_asn_b16, sizeof(pi_asn_b16));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f64_read(buf, asn1_tag_real, &f));
+    }
+    auto et = bench_stop();
+
+    assert(f == 3.141592653589793);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-asn.1-read-base16", count, t, 8 * count };
+}
+
+static bench_result bench_asn1_read_decimal_real(llong count)
+{
+    double f;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_asn_nr3, sizeof(pi_asn_nr3));
+
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
         assert(!vf_asn1_der_real_f64_read(buf, asn1_tag_real, &f));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
+
+    assert(f == 3.141592653589793);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-asn.1-read-nr3", count, t, 8 * count };
+}
+
+static bench_result bench_asn1_write_byptr_real(llong count)
+{
+    double f = 3.141592653589793;
+    vf_buf *buf = vf_buf_new(128);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f64_write(buf, asn1_tag_real, &f));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_asn1_der_real_f64_read(buf, asn1_tag_real, &f);
+    assert(fabs(f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-asn.1-write-byptr", count, t, 8 * count };
+}
+
+static bench_result bench_asn1_write_byval_real(llong count)
+{
+    f64_result r;
+    double f = 3.141592653589793;
+    vf_buf *buf = vf_buf_new(128);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f64_write_byval(buf, asn1_tag_real, f));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    r = vf_asn1_der_real_f64_read_byval(buf, asn1_tag_real);
+    assert(fabs(r.value - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-asn.1-write-byval", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_read_byptr_real(llong count)
+{
+    double f;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_read(buf, &f));
+    }
+    auto et = bench_stop();
+
+    assert(fabs(f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-read-byptr", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_read_byval_real(llong count)
+{
+    f64_result r;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        r = vf_f64_read_byval(buf);
+        assert(!r.error);
+    }
+    auto et = bench_stop();
+
+    assert(fabs(r.value - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-read-byval", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_write_byptr_real(llong count)
+{
+    double f = 3.141592653589793;
+    vf_buf *buf = vf_buf_new(128);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_write(buf, &f));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_f64_read(buf, &f);
+    assert(fabs(f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-write-byptr", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_write_byval_real(llong count)
+{
+    f64_result r;
+    double f = 3.141592653589793;
+    vf_buf *buf = vf_buf_new(128);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_write_byval(buf, f));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    r = vf_f64_read_byval(buf);
+    assert(fabs(r.value - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-write-byval", count, t, 8 * count };
+}
+
+static bench_result bench_vf32_read_byptr_real(llong count)
+{
+    float f;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_read(buf, &f));
+    }
+    auto et = bench_stop();
+
+    assert(fabs(f - 3.141592f) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-vf128-read-byptr", count, t, 4 * count };
+}
+
+static bench_result bench_vf32_read_byval_real(llong count)
+{
+    f32_result r;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        r = vf_f32_read_byval(buf);
+        assert(!r.error);
+    }
+    auto et = bench_stop();
+
+    assert(fabs(r.value - 3.141592f) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-vf128-read-byval", count, t, 4 * count };
+}
+
+static bench_result bench_vf32_write_byptr_real(llong count)
+{
+    float f = 3.141592f;
+    vf_buf *buf = vf_buf_new(128);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_write(buf, &f));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_f32_read(buf, &f);
+    assert(fabs(f - 3.141592f) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-vf128-write-byptr", count, t, 4 * count };
+}
+
+static bench_result bench_vf32_write_byval_real(llong count)
+{
+    f32_result r;
+    float f = 3.141592f;
+    vf_buf *buf = vf_buf_new(128);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_write_byval(buf, f));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    r = vf_f32_read_byval(buf);
+    assert(fabs(r.value - 3.141592f) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-vf128-write-byval", count, t, 4 * count };
+}
+
+enum { array_len = 256 };
+
+static bench_result bench_vf64_read_array_real(llong count)
+{
+    double f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    for (llong i = 0; i < array_len; i++) {
+        vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_read_array(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    assert(fabs(f[array_len-1] - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-read-array", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_write_array_real(llong count)
+{
+    double f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592653589793;
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_write_array(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_f64_read_array(buf, f, array_len);
+    assert(fabs(f[array_len-1] - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-write-array", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_read_packed_real(llong count)
+{
+    double f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592653589793;
+    }
+    assert(!vf_f64_write_packed(buf, f, array_len));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_read_packed(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    assert(fabs(f[array_len-1] - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-read-packed", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_write_packed_real(llong count)
+{
+    double f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592653589793;
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_write_packed(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_f64_read_packed(buf, f, array_len);
+    assert(fabs(f[array_len-1] - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-write-packed", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_read_coded_real(llong count)
+{
+    double f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592653589793;
+    }
+    assert(!vf_f64_write_coded(buf, f, array_len));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_read_coded(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    assert(fabs(f[array_len-1] - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-read-coded", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_write_coded_real(llong count)
+{
+    double f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592653589793;
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_write_coded(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_f64_read_coded(buf, f, array_len);
+    assert(fabs(f[array_len-1] - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-vf128-write-coded", count, t, 8 * count };
+}
+
+/* microsecond timestamps one millisecond apart */
+static void bench_timestamps(double *f, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        f[i] = (double)(1700000000000000ll + (llong)i * 1000 + (llong)(i * 7 % 5)) / 1e6;
+    }
+}
+
+static bench_result bench_vf64_read_dod_real(llong count)
+{
+    double f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    bench_timestamps(f, array_len);
+    assert(!vf_f64_write_dod(buf, f, array_len));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_read_dod(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    assert(f[1] == (double)1700000000001002ll / 1e6);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-dod-read-array", count, t, 8 * count };
+}
+
+static bench_result bench_vf64_write_dod_real(llong count)
+{
+    double f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    bench_timestamps(f, array_len);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_write_dod(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_f64_read_dod(buf, f, array_len);
+    assert(f[1] == (double)1700000000001002ll / 1e6);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-dod-write-array", count, t, 8 * count };
+}
+
+/* FFT bins, complex values with a shared magnitude range */
+static void bench_c64(double *f, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        f[i * 2] = cos((double)i * 0.3) / (double)(i + 1);
+        f[i * 2 + 1] = sin((double)i * 0.3) / (double)(i + 1);
+    }
+}
+
+/* vertex positions of a unit sphere */
+static void bench_vec3(float *f, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        float a = (float)i * 0.1f, b = (float)i * 0.017f;
+        f[i * 3] = cosf(a) * sinf(b);
+        f[i * 3 + 1] = sinf(a) * sinf(b);
+        f[i * 3 + 2] = cosf(b);
+    }
+}
+
+static bench_result bench_c64_read_real(llong count)
+{
+    enum { n = array_len / 2 };
+    double f[array_len], g[array_len];
+    vf_buf *buf = vf_buf_new(n * vf_c64_max_length);
+    bench_c64(f, n);
+    assert(!vf_c64_write_array(buf, f, n));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_c64_read_array(buf, g, n));
+    }
+    auto et = bench_stop();
+
+    assert(memcmp(f, g, sizeof(f)) == 0);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "c64-read-array", count, t, 8 * count };
+}
+
+static bench_result bench_c64_write_real(llong count)
+{
+    enum { n = array_len / 2 };
+    double f[array_len];
+    vf_buf *buf = vf_buf_new(n * vf_c64_max_length);
+    bench_c64(f, n);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_c64_write_array(buf, f, n));
+    }
+    auto et = bench_stop();
+
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "c64-write-array", count, t, 8 * count };
+}
+
+static bench_result bench_vec3_read_real(llong count)
+{
+    enum { n = array_len / 3 };
+    float f[n * 3], g[n * 3];
+    vf_buf *buf = vf_buf_new(n * vf_vec3_max_length);
+    bench_vec3(f, n);
+    assert(!vf_vec3_write_array(buf, f, n));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += n * 3) {
+        vf_buf_reset(buf);
+        assert(!vf_vec3_read_array(buf, g, n));
+    }
+    auto et = bench_stop();
+
+    assert(memcmp(f, g, sizeof(f)) == 0);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "vec3-read-array", count, t, 4 * count };
+}
+
+static bench_result bench_vec3_write_real(llong count)
+{
+    enum { n = array_len / 3 };
+    float f[n * 3];
+    vf_buf *buf = vf_buf_new(n * vf_vec3_max_length);
+    bench_vec3(f, n);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += n * 3) {
+        vf_buf_reset(buf);
+        assert(!vf_vec3_write_array(buf, f, n));
+    }
+    auto et = bench_stop();
+
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "vec3-write-array", count, t, 4 * count };
+}
+
+/* 768-dimension embeddings, normally distributed components */
+enum { bench_emb_dim = 768 };
+
+static void bench_embedding(float *f, size_t n)
+{
+    std::mt19937_64 g(768);
+    std::normal_distribution<float> d(0.f, 0.05f);
+    for (size_t i = 0; i < n; i++) f[i] = d(g);
+}
+
+static bench_result bench_vf32_read_vec_real(llong count)
+{
+    static float f[bench_emb_dim], g[bench_emb_dim];
+    vf_buf *buf = vf_buf_new(3 + 4 * bench_emb_dim);
+    bench_embedding(f, bench_emb_dim);
+    assert(!vf_f32_write_vec(buf, f, bench_emb_dim, 1, 24));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += bench_emb_dim) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_read_vec(buf, g, bench_emb_dim, 1));
+    }
+    auto et = bench_stop();
+
+    assert(memcmp(f, g, sizeof(f)) == 0);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-vec-read", count, t, 4 * count };
+}
+
+static bench_result bench_vf32_write_vec_real(llong count)
+{
+    static float f[bench_emb_dim];
+    vf_buf *buf = vf_buf_new(3 + 4 * bench_emb_dim);
+    bench_embedding(f, bench_emb_dim);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += bench_emb_dim) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_write_vec(buf, f, bench_emb_dim, 1, 24));
+    }
+    auto et = bench_stop();
+
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-vec-write", count, t, 4 * count };
+}
+
+/* a market data tick of mixed float and integer fields */
+struct bench_tick
+{
+    double price;
+    float qty;
+    s64 ts;
+    u64 id;
+};
+
+static const vf_field bench_tick_fields[] = {
+    { offsetof(bench_tick, ts), vf_field_s64 },
+    { offsetof(bench_tick, price), vf_field_f64 },
+    { offsetof(bench_tick, qty), vf_field_f32 },
+    { offsetof(bench_tick, id), vf_field_u64 },
+};
+
+static void bench_tick_fill(bench_tick *t)
+{
+    for (llong i = 0; i < array_len; i++) {
+        t[i] = bench_tick { 100. + (double)(i % 400) / 4., (float)(i * 100),
+            1700000000000000000ll + i * 1000, (u64)i * 7919 };
+    }
+}
+
+static bench_result bench_tick_read_schema(llong count)
+{
+    bench_tick t[array_len];
+    vf_schema *s = vf_schema_new(bench_tick_fields, 4, sizeof(bench_tick));
+    vf_buf *buf = vf_buf_new(array_len * vf_schema_max_length(s));
+    bench_tick_fill(t);
+    assert(!vf_schema_write(buf, s, t, array_len));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_schema_read(buf, s, t, array_len));
+    }
+    auto et = bench_stop();
+
+    assert(t[array_len-1].ts == 1700000000000000000ll + (array_len - 1) * 1000);
+    vf_buf_destroy(buf);
+    vf_schema_destroy(s);
+
+    double t_ns = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "tick-schema-read", count, t_ns, (llong)sizeof(bench_tick) * count };
+}
+
+static bench_result bench_tick_write_schema(llong count)
+{
+    bench_tick t[array_len];
+    vf_schema *s = vf_schema_new(bench_tick_fields, 4, sizeof(bench_tick));
+    vf_buf *buf = vf_buf_new(array_len * vf_schema_max_length(s));
+    bench_tick_fill(t);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_schema_write(buf, s, t, array_len));
+    }
+    auto et = bench_stop();
+
+    vf_buf_destroy(buf);
+    vf_schema_destroy(s);
+
+    double t_ns = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "tick-schema-write", count, t_ns, (llong)sizeof(bench_tick) * count };
+}
+
+/* the same ticks written field by field */
+static bench_result bench_tick_write_fields(llong count)
+{
+    bench_tick t[array_len];
+    vf_buf *buf = vf_buf_new(array_len * 36);
+    bench_tick_fill(t);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        for (llong j = 0; j < array_len; j++) {
+            assert(!vf_vlu_s64_write(buf, &t[j].ts));
+            assert(!vf_f64_write(buf, &t[j].price));
+            assert(!vf_f32_write(buf, &t[j].qty));
+            assert(!vf_vlu_u64_write(buf, &t[j].id));
+        }
+    }
+    auto et = bench_stop();
+
+    vf_buf_destroy(buf);
+
+    double t_ns = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "tick-fields-write", count, t_ns, (llong)sizeof(bench_tick) * count };
+}
+
+/* the same ticks written with the C++ interface */
+static bench_result bench_tick_write_tuple(llong count)
+{
+    bench_tick t[array_len];
+    vf_buf *buf = vf_buf_new(array_len * 36);
+    bench_tick_fill(t);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        for (llong j = 0; j < array_len; j++) {
+            assert(!vf::write(buf, t[j].ts, t[j].price, t[j].qty, t[j].id));
+        }
+    }
+    auto et = bench_stop();
+
+    vf_buf_destroy(buf);
+
+    double t_ns = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "tick-tuple-write", count, t_ns, (llong)sizeof(bench_tick) * count };
+}
+
+/* a request handler buffer, allocated per request or taken from a pool */
+static bench_result bench_buf_new_destroy(llong count)
+{
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf *buf = vf_buf_new(64 << 10);
+        assert(!vf_f64_write_byval(buf, 3.141592653589793));
+        vf_buf_destroy(buf);
+    }
+    auto et = bench_stop();
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "buf-new-destroy-64k", count, t, 0 };
+}
+
+static bench_result bench_buf_acquire_release(llong count)
+{
+    vf_buf_pool *pool = vf_buf_pool_new();
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf *buf = vf_buf_acquire(pool, 64 << 10);
+        assert(!vf_f64_write_byval(buf, 3.141592653589793));
+        vf_buf_release(pool, buf);
+    }
+    auto et = bench_stop();
+
+    vf_buf_pool_destroy(pool);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "buf-acquire-release-64k", count, t, 0 };
+}
+
+/* activations in [-1, 1) as 32-value blocks of 8-bit magnitudes */
+static bench_result bench_vf32_read_mx_real(llong count)
+{
+    float f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(float));
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = (float)((i * 37) % 256 - 128) / 128.f;
+    }
+    assert(!vf_f32_write_mx(buf, f, array_len, 32, 8));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_read_mx(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    assert(f[1] == (float)(37 - 128) / 128.f);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-mx8-read-array", count, t, 4 * count };
+}
+
+static bench_result bench_vf32_write_mx_real(llong count)
+{
+    float f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(float));
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = (float)((i * 37) % 256 - 128) / 128.f;
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_write_mx(buf, f, array_len, 32, 8));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_f32_read_mx(buf, f, array_len);
+    assert(f[1] == (float)(37 - 128) / 128.f);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-mx8-write-array", count, t, 4 * count };
+}
+
+static bench_result bench_vf32_read_array_real(llong count)
+{
+    float f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    for (llong i = 0; i < array_len; i++) {
+        vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_read_array(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    assert(fabs(f[array_len-1] - 3.141592f) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-vf128-read-array", count, t, 4 * count };
+}
+
+/* the f64 records of pi rounded to nearest float */
+static bench_result bench_vf32_read_any_real(llong count)
+{
+    float f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    for (llong i = 0; i < array_len; i++) {
+        vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_read_from_any(buf, f, array_len, vf_field_f64, vf_round_nearest));
+    }
+    auto et = bench_stop();
+
+    assert(f[array_len-1] == (float)3.141592653589793);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-vf128-read-any", count, t, 4 * count };
+}
+
+static bench_result bench_vf32_write_array_real(llong count)
+{
+    float f[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_vf8));
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592f;
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_write_array(buf, f, array_len));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_f32_read_array(buf, f, array_len);
+    assert(fabs(f[array_len-1] - 3.141592f) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-vf128-write-array", count, t, 4 * count };
+}
+
+static bench_result bench_asn1_f32_read_byptr_real(llong count)
+{
+    float f;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_asn_f32, sizeof(pi_asn_f32));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f32_read(buf, asn1_tag_real, &f));
+    }
+    auto et = bench_stop();
+
+    assert(fabs((double)f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-asn.1-read-byptr", count, t, 4 * count };
+}
+
+static bench_result bench_asn1_f32_read_byval_real(llong count)
+{
+    f32_result r;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_asn_f32, sizeof(pi_asn_f32));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        r = vf_asn1_der_real_f32_read_byval(buf, asn1_tag_real);
+        assert(!r.error);
+    }
+    auto et = bench_stop();
+
+    assert(fabs((double)r.value - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-asn.1-read-byval", count, t, 4 * count };
+}
+
+static bench_result bench_asn1_f32_write_byptr_real(llong count)
+{
+    float f = 3.141592f;
+    vf_buf *buf = vf_buf_new(128);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f32_write(buf, asn1_tag_real, &f));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_asn1_der_real_f32_read(buf, asn1_tag_real, &f);
+    assert(fabs((double)f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-asn.1-write-byptr", count, t, 4 * count };
+}
+
+static bench_result bench_asn1_f32_write_byval_real(llong count)
+{
+    float f = 3.141592f;
+    vf_buf *buf = vf_buf_new(128);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f32_write_byval(buf, asn1_tag_real, f));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_asn1_der_real_f32_read(buf, asn1_tag_real, &f);
+    assert(fabs((double)f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f32-asn.1-write-byval", count, t, 4 * count };
+}
+
+#if defined(VF_HAS_F80)
+static bench_result bench_asn1_f80_read_byptr_real(llong count)
+{
+    f80 f;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_asn, sizeof(pi_asn));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f80_read(buf, asn1_tag_real, &f));
+    }
+    auto et = bench_stop();
+
+    assert(fabs((double)f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f80-asn.1-read-byptr", count, t, 16 * count };
+}
+
+static bench_result bench_asn1_f80_write_byptr_real(llong count)
+{
+    f80 f = 3.141592653589793L;
+    vf_buf *buf = vf_buf_new(128);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f80_write(buf, asn1_tag_real, &f));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_asn1_der_real_f80_read(buf, asn1_tag_real, &f);
+    assert(fabs((double)f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f80-asn.1-write-byptr", count, t, 16 * count };
+}
+#endif
+
+#if defined(VF_HAS_F128)
+static bench_result bench_asn1_f128_read_byptr_real(llong count)
+{
+    f128 f;
+    vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)pi_asn, sizeof(pi_asn));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f128_read(buf, asn1_tag_real, &f));
+    }
+    auto et = bench_stop();
+
+    assert(fabs((double)f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f128-asn.1-read-byptr", count, t, 16 * count };
+}
+
+static bench_result bench_asn1_f128_write_byptr_real(llong count)
+{
+    f128 f = 3.141592653589793;
+    vf_buf *buf = vf_buf_new(128);
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f128_write(buf, asn1_tag_real, &f));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_asn1_der_real_f128_read(buf, asn1_tag_real, &f);
+    assert(fabs((double)f - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f128-asn.1-write-byptr", count, t, 16 * count };
+}
+#endif
+
+static bench_result bench_asn1_read_array_real(llong count)
+{
+    double f[array_len];
+    size_t n;
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_asn) + 8);
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592653589793;
+    }
+    assert(!vf_asn1_der_real_f64_write_array(buf, asn1_tag_real, f, array_len));
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        n = array_len;
+        assert(!vf_asn1_der_real_f64_read_array(buf, asn1_tag_real, f, &n));
+    }
+    auto et = bench_stop();
+
+    assert(fabs(f[array_len-1] - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-asn.1-read-array", count, t, 8 * count };
+}
+
+static bench_result bench_asn1_write_array_real(llong count)
+{
+    double f[array_len];
+    size_t n = array_len;
+    vf_buf *buf = vf_buf_new(array_len * sizeof(pi_asn) + 8);
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592653589793;
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f64_write_array(buf, asn1_tag_real, f, array_len));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(buf);
+    vf_asn1_der_real_f64_read_array(buf, asn1_tag_real, f, &n);
+    assert(fabs(f[array_len-1] - 3.141592) < 0.0001);
+    vf_buf_destroy(buf);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-asn.1-write-array", count, t, 8 * count };
+}
+
+static bench_result bench_transcode_asn1_vf128_real(llong count)
+{
+    double f[array_len];
+    vf_buf *src = vf_buf_new(array_len * sizeof(pi_asn) + 8);
+    vf_buf *dst = vf_buf_new(array_len * 16);
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592653589793;
+        assert(!vf_asn1_der_real_f64_write(src, asn1_tag_real, &f[i]));
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(src);
+        vf_buf_reset(dst);
+        assert(!vf_transcode_asn1_to_vf128(dst, src, array_len));
+    }
+    auto et = bench_stop();
+
+    vf_buf_reset(dst);
+    assert(!vf_f64_read_array(dst, f, array_len));
+    assert(fabs(f[array_len-1] - 3.141592) < 0.0001);
+    vf_buf_destroy(src);
+    vf_buf_destroy(dst);
+
+    double t = (double)duration_cast<nanoseconds>(et - st).count();
+    return bench_result { "f64-asn.1-to-vf128", count, t, 8 * count };
+}
+
+static bench_result bench_transcode_asn1_vf128_f64_real(llong count)
+{
+    double f[array_len], v;
+    vf_buf *src = vf_buf_new(array_len * sizeof(pi_asn) + 8);
+    vf_buf *dst = vf_buf_new(array_len * 16);
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592653589793;
+        assert(!vf_asn1_der_real_f64_write(src, asn1_tag_real, &f[i]));
+    }
+
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(src);
+        vf_buf_reset(dst);
+        for (llong j = 0; j < array_len; j++) {
+            assert(!vf_asn1_der_real_f64_read(src, asn1_tag_real, &v));
+            assert(!vf_f64_write_byval(dst, v));
+        }
+    }
+    auto et = bench_stop();
 
-    assert(fabs(f - 3.141592) < 0.0001);
-    vf_buf_destroy(buf);
+    vf_buf_reset(dst);
+    assert(!vf_f64_read_array(dst, f, array_len));
+    assert(fabs(f[array_len-1] - 3.141592) < 0.0001);
+    vf_buf_destroy(src);
+    vf_buf_destroy(dst);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f64-asn.1-read-byptr", count, t, 8 * count };
+    return bench_result { "f64-asn.1-to-vf128-f64", count, t, 8 * count };
 }
 
-static bench_result bench_asn1_read_byval_real(llong count)
+static bench_result bench_transcode_vf128_asn1_real(llong count)
 {
-    f64_result r;
-    vf_buf *buf = vf_buf_new(128);
-    vf_buf_write_bytes(buf, (const char*)pi_asn, sizeof(pi_asn));
+    double f[array_len], v;
+    vf_buf *src = vf_buf_new(array_len * 16);
+    vf_buf *dst = vf_buf_new(array_len * sizeof(pi_asn) + 8);
+    for (llong i = 0; i < array_len; i++) {
+        f[i] = 3.141592653589793;
+    }
+    assert(!vf_f64_write_array(src, f, array_len));
 
-    auto st = high_resolution_clock::now();
-    for (llong i = 0; i < count; i++) {
-        vf_buf_reset(buf);
-        r = vf_asn1_der_real_f64_read_byval(buf, asn1_tag_real);
-        assert(!r.error);
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
+        vf_buf_reset(src);
+        vf_buf_reset(dst);
+        assert(!vf_transcode_vf128_to_asn1(dst, src, array_len));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    assert(fabs(r.value - 3.141592) < 0.0001);
-    vf_buf_destroy(buf);
+    vf_buf_reset(dst);
+    assert(!vf_asn1_der_real_f64_read(dst, asn1_tag_real, &v));
+    assert(fabs(v - 3.141592) < 0.0001);
+    vf_buf_destroy(src);
+    vf_buf_destroy(dst);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f64-asn.1-read-byval", count, t, 8 * count };
+    return bench_result { "f64-vf128-to-asn.1", count, t, 8 * count };
 }
 
-static bench_result bench_asn1_write_byptr_real(llong count)
+static bench_result bench_asn1_read_int(llong count)
 {
-    double f = 3.141592653589793;
+    u64 v;
     vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)i12_asn, sizeof(i12_asn));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
-        assert(!vf_asn1_der_real_f64_write(buf, asn1_tag_real, &f));
+        assert(!vf_asn1_der_integer_u64_read(buf, asn1_tag_integer, &v));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    vf_buf_reset(buf);
-    vf_asn1_der_real_f64_read(buf, asn1_tag_real, &f);
-    assert(fabs(f - 3.141592) < 0.0001);
+    assert(v == i12);
     vf_buf_destroy(buf);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f64-asn.1-write-byptr", count, t, 8 * count };
+    return bench_result { "u64-asn.1-read", count, t, 8 * count };
 }
 
-static bench_result bench_asn1_write_byval_real(llong count)
+static bench_result bench_asn1_write_int(llong count)
 {
-    f64_result r;
-    double f = 3.141592653589793;
+    u64 v = i12;
     vf_buf *buf = vf_buf_new(128);
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
-        assert(!vf_asn1_der_real_f64_write_byval(buf, asn1_tag_real, f));
+        assert(!vf_asn1_der_integer_u64_write(buf, asn1_tag_integer, &v));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    vf_buf_reset(buf);
-    r = vf_asn1_der_real_f64_read_byval(buf, asn1_tag_real);
-    assert(fabs(r.value - 3.141592) < 0.0001);
+    assert(memcmp(vf_buf_data(buf), i12_asn, sizeof(i12_asn)) == 0);
     vf_buf_destroy(buf);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f64-asn.1-write-byval", count, t, 8 * count };
+    return bench_result { "u64-asn.1-write", count, t, 8 * count };
 }
 
-static bench_result bench_vf64_read_byptr_real(llong count)
+static bench_result bench_le_ber_read_int(llong count)
 {
-    double f;
+    u64 v;
     vf_buf *buf = vf_buf_new(128);
-    vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
+    vf_buf_write_bytes(buf, (const char*)i12_le, sizeof(i12_le));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
-        assert(!vf_f64_read(buf, &f));
+        assert(!vf_le_ber_integer_u64_read(buf, sizeof(i12_le), &v));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    assert(fabs(f - 3.141592) < 0.0001);
+    assert(v == i12);
     vf_buf_destroy(buf);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f64-vf128-read-byptr", count, t, 8 * count };
+    return bench_result { "u64-le-ber-read", count, t, 8 * count };
 }
 
-static bench_result bench_vf64_read_byval_real(llong count)
+static bench_result bench_le_ber_write_int(llong count)
 {
-    f64_result r;
+    u64 v = i12;
     vf_buf *buf = vf_buf_new(128);
-    vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
-        r = vf_f64_read_byval(buf);
-        assert(!r.error);
+        assert(!vf_le_ber_integer_u64_write(buf, sizeof(i12_le), &v));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    assert(fabs(r.value - 3.141592) < 0.0001);
+    assert(memcmp(vf_buf_data(buf), i12_le, sizeof(i12_le)) == 0);
     vf_buf_destroy(buf);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f64-vf128-read-byval", count, t, 8 * count };
+    return bench_result { "u64-le-ber-write", count, t, 8 * count };
 }
 
-static bench_result bench_vf64_write_byptr_real(llong count)
+static bench_result bench_leb128_read_int(llong count)
 {
-    double f = 3.141592653589793;
+    u64 v;
     vf_buf *buf = vf_buf_new(128);
+    vf_buf_write_bytes(buf, (const char*)i12_leb, sizeof(i12_leb));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
-        assert(!vf_f64_write(buf, &f));
+        assert(!vf_leb128_u64_read(buf, &v));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    vf_buf_reset(buf);
-    vf_f64_read(buf, &f);
-    assert(fabs(f - 3.141592) < 0.0001);
+    assert(v == i12);
     vf_buf_destroy(buf);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f64-vf128-write-byptr", count, t, 8 * count };
+    return bench_result { "u64-leb128-read", count, t, 8 * count };
 }
 
-static bench_result bench_vf64_write_byval_real(llong count)
+static bench_result bench_leb128_write_int(llong count)
 {
-    f64_result r;
-    double f = 3.141592653589793;
+    u64 v = i12;
     vf_buf *buf = vf_buf_new(128);
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
-        assert(!vf_f64_write_byval(buf, f));
+        assert(!vf_leb128_u64_write(buf, &v));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    vf_buf_reset(buf);
-    r = vf_f64_read_byval(buf);
-    assert(fabs(r.value - 3.141592) < 0.0001);
+    assert(memcmp(vf_buf_data(buf), i12_leb, sizeof(i12_leb)) == 0);
     vf_buf_destroy(buf);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f64-vf128-write-byval", count, t, 8 * count };
+    return bench_result { "u64-leb128-write", count, t, 8 * count };
 }
 
-static bench_result bench_vf32_read_byptr_real(llong count)
+static bench_result bench_vlu_read_int(llong count)
 {
-    float f;
+    u64 v;
     vf_buf *buf = vf_buf_new(128);
-    vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
+    vf_buf_write_bytes(buf, (const char*)i12_vlu, sizeof(i12_vlu));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
-        assert(!vf_f32_read(buf, &f));
+        assert(!vf_vlu_u64_read(buf, &v));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    assert(fabs(f - 3.141592f) < 0.0001);
+    assert(v == i12);
     vf_buf_destroy(buf);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f32-vf128-read-byptr", count, t, 4 * count };
+    return bench_result { "u64-vlu-read", count, t, 8 * count };
 }
 
-static bench_result bench_vf32_read_byval_real(llong count)
+static bench_result bench_vlu_write_int(llong count)
 {
-    f32_result r;
+    u64 v = i12;
     vf_buf *buf = vf_buf_new(128);
-    vf_buf_write_bytes(buf, (const char*)pi_vf8, sizeof(pi_vf8));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
-        r = vf_f32_read_byval(buf);
-        assert(!r.error);
+        assert(!vf_vlu_u64_write(buf, &v));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    assert(fabs(r.value - 3.141592f) < 0.0001);
+    assert(memcmp(vf_buf_data(buf), i12_vlu, sizeof(i12_vlu)) == 0);
     vf_buf_destroy(buf);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f32-vf128-read-byval", count, t, 4 * count };
+    return bench_result { "u64-vlu-write", count, t, 8 * count };
 }
 
-static bench_result bench_vf32_write_byptr_real(llong count)
+static bench_result bench_leb128_read_array_int(llong count)
 {
-    float f = 3.141592f;
-    vf_buf *buf = vf_buf_new(128);
+    u64 v[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(i12_leb));
+    for (llong i = 0; i < array_len; i++) {
+        vf_buf_write_bytes(buf, (const char*)i12_leb, sizeof(i12_leb));
+    }
 
-    auto st = high_resolution_clock::now();
-    for (llong i = 0; i < count; i++) {
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
         vf_buf_reset(buf);
-        assert(!vf_f32_write(buf, &f));
+        assert(!vf_leb128_u64_read_array(buf, v, array_len));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    vf_buf_reset(buf);
-    vf_f32_read(buf, &f);
-    assert(fabs(f - 3.141592f) < 0.0001);
+    assert(v[array_len-1] == i12);
     vf_buf_destroy(buf);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f32-vf128-write-byptr", count, t, 4 * count };
+    return bench_result { "u64-leb128-read-array", count, t, 8 * count };
 }
 
-static bench_result bench_vf32_write_byval_real(llong count)
+static bench_result bench_vlu_read_array_int(llong count)
 {
-    f32_result r;
-    float f = 3.141592f;
-    vf_buf *buf = vf_buf_new(128);
+    u64 v[array_len];
+    vf_buf *buf = vf_buf_new(array_len * sizeof(i12_vlu));
+    for (llong i = 0; i < array_len; i++) {
+        vf_buf_write_bytes(buf, (const char*)i12_vlu, sizeof(i12_vlu));
+    }
 
-    auto st = high_resolution_clock::now();
-    for (llong i = 0; i < count; i++) {
+    auto st = bench_start();
+    for (llong i = 0; i < count; i += array_len) {
         vf_buf_reset(buf);
-        assert(!vf_f32_write_byval(buf, f));
+        assert(!vf_vlu_u64_read_array(buf, v, array_len));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
-    vf_buf_reset(buf);
-    r = vf_f32_read_byval(buf);
-    assert(fabs(r.value - 3.141592f) < 0.0001);
+    assert(v[array_len-1] == i12);
     vf_buf_destroy(buf);
 
     double t = (double)duration_cast<nanoseconds>(et - st).count();
-    return bench_result { "f32-vf128-write-byval", count, t, 4 * count };
+    return bench_result { "u64-vlu-read-array", count, t, 8 * count };
 }
 
 static bench_result bench_f64_read_byptr_real(llong count)
@@ -378,12 +1734,12 @@ static bench_result bench_f64_read_byptr_real(llong count)
     vf_buf *buf = vf_buf_new(128);
     vf_buf_write_bytes(buf, (const char*)pi_f64, sizeof(pi_f64));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
         assert(!ieee754_f64_read(buf, &f));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     assert(fabs(f - 3.141592) < 0.0001);
     vf_buf_destroy(buf);
@@ -398,13 +1754,13 @@ static bench_result bench_f64_read_byval_real(llong count)
     vf_buf *buf = vf_buf_new(128);
     vf_buf_write_bytes(buf, (const char*)pi_f64, sizeof(pi_f64));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
         r = ieee754_f64_read_byval(buf);
         assert(!r.error);
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     assert(fabs(r.value - 3.141592) < 0.0001);
     vf_buf_destroy(buf);
@@ -418,12 +1774,12 @@ static bench_result bench_f64_write_byptr_real(llong count)
     double f = 3.141592653589793;
     vf_buf *buf = vf_buf_new(128);
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
         assert(!ieee754_f64_write(buf, &f));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     vf_buf_reset(buf);
     ieee754_f64_read(buf, &f);
@@ -440,12 +1796,12 @@ static bench_result bench_f64_write_byval_real(llong count)
     double f = 3.141592653589793;
     vf_buf *buf = vf_buf_new(128);
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
         assert(!ieee754_f64_write_byval(buf, f));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     vf_buf_reset(buf);
     r = ieee754_f64_read_byval(buf);
@@ -462,12 +1818,12 @@ static bench_result bench_f32_read_byptr_real(llong count)
     vf_buf *buf = vf_buf_new(128);
     vf_buf_write_bytes(buf, (const char*)pi_f32, sizeof(pi_f32));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
         assert(!ieee754_f32_read(buf, &f));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     assert(fabs(f - 3.141592f) < 0.0001);
     vf_buf_destroy(buf);
@@ -482,13 +1838,13 @@ static bench_result bench_f32_read_byval_real(llong count)
     vf_buf *buf = vf_buf_new(128);
     vf_buf_write_bytes(buf, (const char*)pi_f32, sizeof(pi_f32));
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
         r = ieee754_f32_read_byval(buf);
         assert(!r.error);
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     assert(fabs(r.value - 3.141592f) < 0.0001);
     vf_buf_destroy(buf);
@@ -502,12 +1858,12 @@ static bench_result bench_f32_write_byptr_real(llong count)
     float f = 3.141592f;
     vf_buf *buf = vf_buf_new(128);
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
         assert(!ieee754_f32_write(buf, &f));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     vf_buf_reset(buf);
     ieee754_f32_read(buf, &f);
@@ -524,12 +1880,12 @@ static bench_result bench_f32_write_byval_real(llong count)
     float f = 3.141592f;
     vf_buf *buf = vf_buf_new(128);
 
-    auto st = high_resolution_clock::now();
+    auto st = bench_start();
     for (llong i = 0; i < count; i++) {
         vf_buf_reset(buf);
         assert(!ieee754_f32_write_byval(buf, f));
     }
-    auto et = high_resolution_clock::now();
+    auto et = bench_stop();
 
     vf_buf_reset(buf);
     r = ieee754_f32_read_byval(buf);
@@ -555,6 +1911,21 @@ static const char* format_unit(llong count)
     return buf;
 }
 
+static const char* format_size(size_t size)
+{
+    static char buf[32];
+    if (size >= (1 << 30) && size % (1 << 30) == 0) {
+        snprintf(buf, sizeof(buf), "%zuGiB", size >> 30);
+    } else if (size >= (1 << 20) && size % (1 << 20) == 0) {
+        snprintf(buf, sizeof(buf), "%zuMiB", size >> 20);
+    } else if (size >= (1 << 10) && size % (1 << 10) == 0) {
+        snprintf(buf, sizeof(buf), "%zuKiB", size >> 10);
+    } else {
+        snprintf(buf, sizeof(buf), "%zuB", size);
+    }
+    return buf;
+}
+
 static const char* format_comma(llong count)
 {
     static char buf[32];
@@ -579,10 +1950,31 @@ static bench_result(* const benchmarks[])(llong) = {
     bench_ascii_strtof,
     bench_ascii_snprintf_f,
     bench_ascii_snprintf_d,
+    bench_vf64_write_decimal,
+    bench_vf64_read_decimal,
     bench_asn1_read_byptr_real,
     bench_asn1_read_byval_real,
+    bench_asn1_read_base16_real,
+    bench_asn1_read_decimal_real,
     bench_asn1_write_byptr_real,
     bench_asn1_write_byval_real,
+    bench_asn1_f32_read_byptr_real,
+    bench_asn1_f32_read_byval_real,
+    bench_asn1_f32_write_byptr_real,
+    bench_asn1_f32_write_byval_real,
+#if defined(VF_HAS_F80)
+    bench_asn1_f80_read_byptr_real,
+    bench_asn1_f80_write_byptr_real,
+#endif
+#if defined(VF_HAS_F128)
+    bench_asn1_f128_read_byptr_real,
+    bench_asn1_f128_write_byptr_real,
+#endif
+    bench_asn1_read_array_real,
+    bench_asn1_write_array_real,
+    bench_transcode_asn1_vf128_real,
+    bench_transcode_asn1_vf128_f64_real,
+    bench_transcode_vf128_asn1_real,
     bench_vf32_read_byptr_real,
     bench_vf32_read_byval_real,
     bench_vf32_write_byptr_real,
@@ -591,6 +1983,31 @@ static bench_result(* const benchmarks[])(llong) = {
     bench_vf64_read_byval_real,
     bench_vf64_write_byptr_real,
     bench_vf64_write_byval_real,
+    bench_vf32_read_array_real,
+    bench_vf32_read_any_real,
+    bench_vf32_write_array_real,
+    bench_vf64_read_array_real,
+    bench_vf64_write_array_real,
+    bench_vf64_read_packed_real,
+    bench_vf64_write_packed_real,
+    bench_vf64_read_coded_real,
+    bench_vf64_write_coded_real,
+    bench_vf64_read_dod_real,
+    bench_vf64_write_dod_real,
+    bench_c64_read_real,
+    bench_c64_write_real,
+    bench_vec3_read_real,
+    bench_vec3_write_real,
+    bench_vf32_read_vec_real,
+    bench_vf32_write_vec_real,
+    bench_tick_read_schema,
+    bench_tick_write_schema,
+    bench_tick_write_fields,
+    bench_tick_write_tuple,
+    bench_buf_new_destroy,
+    bench_buf_acquire_release,
+    bench_vf32_read_mx_real,
+    bench_vf32_write_mx_real,
     bench_f32_read_byptr_real,
     bench_f32_read_byval_real,
     bench_f32_write_byptr_real,
@@ -599,6 +2016,16 @@ static bench_result(* const benchmarks[])(llong) = {
     bench_f64_read_byval_real,
     bench_f64_write_byptr_real,
     bench_f64_write_byval_real,
+    bench_asn1_read_int,
+    bench_asn1_write_int,
+    bench_le_ber_read_int,
+    bench_le_ber_write_int,
+    bench_leb128_read_int,
+    bench_leb128_write_int,
+    bench_vlu_read_int,
+    bench_vlu_write_int,
+    bench_leb128_read_array_int,
+    bench_vlu_read_array_int,
 };
 
 #define array_size(arr) ((sizeof(arr)/sizeof(arr[0])))
@@ -654,11 +2081,15 @@ static void run_benchmark(size_t n, llong repeat, llong count, llong pause_ms)
         print_header(num);
         print_rules("       ");
     }
+    perf_counts best = perf_counts();
     for (llong i = 0; i < llabs(repeat); i++) {
         bench_result r = benchmarks[n](count);
         name = r.name;
         size = r.size;
-        if (min_t == 0. || r.t < min_t) min_t = r.t;
+        if (min_t == 0. || r.t < min_t) {
+            min_t = r.t;
+            best = perf_last;
+        }
         if (max_t == 0. || r.t > max_t) max_t = r.t;
         sum_t += r.t;
         if (repeat > 0) {
@@ -672,11 +2103,13 @@ static void run_benchmark(size_t n, llong repeat, llong count, llong pause_ms)
         print_result("worst: ", name, count, max_t, size);
         print_result("  avg: ", name, count, sum_t / repeat, size);
         print_result(" best: ", name, count, min_t, size);
+        print_perf(" perf:", best, (double)count);
         puts("");
     } else if (llabs(repeat) >= 1) {
         char num[32];
         snprintf(num, sizeof(num), "[%2zu] ", n);
         print_result(num, name, count, min_t, size);
+        print_perf("      perf:", best, (double)count);
     }
 }
 
@@ -684,12 +2117,611 @@ static void run_benchmark(size_t n, llong repeat, llong count, llong pause_ms)
 # define strtok_r strtok_s
 #endif
 
+/*
+ * dataset benchmarks
+ *
+ * the single value benchmarks above run from L1 with a perfectly
+ * predicted branch. the dataset suite encodes and decodes arrays of
+ * generated or loaded values at sizes from L1-resident to DRAM-resident
+ * and reports ns/value, GB/s of raw f64 input and encoded bytes/value.
+ */
+
+struct dataset
+{
+    std::string name;
+    std::vector<double> values;
+};
+
+typedef void (*dataset_gen)(std::vector<double> &v, std::mt19937_64 &g);
+
+static void gen_uniform_unit(std::vector<double> &v, std::mt19937_64 &g)
+{
+    std::uniform_real_distribution<double> d(0, 1);
+    for (auto &x : v) x = d(g);
+}
+
+static void gen_uniform_1000(std::vector<double> &v, std::mt19937_64 &g)
+{
+    std::uniform_real_distribution<double> d(-1000, 1000);
+    for (auto &x : v) x = d(g);
+}
+
+static void gen_uniform_1e307(std::vector<double> &v, std::mt19937_64 &g)
+{
+    std::uniform_real_distribution<double> d(-1e307, 1e307);
+    for (auto &x : v) x = d(g);
+}
+
+/* prices quoted in cents */
+static void gen_walk(std::vector<double> &v, std::mt19937_64 &g)
+{
+    std::normal_distribution<double> d(0, 0.5);
+    double x = 100.;
+    for (auto &y : v) {
+        x = fabs(x + d(g));
+        y = round(x * 100.) / 100.;
+    }
+}
+
+/* model weights trained in f32 */
+static void gen_weights(std::vector<double> &v, std::mt19937_64 &g)
+{
+    std::normal_distribution<float> d(0, 0.02f);
+    for (auto &x : v) x = d(g);
+}
+
+static void gen_sparse(std::vector<double> &v, std::mt19937_64 &g)
+{
+    std::uniform_real_distribution<double> z(0, 1);
+    std::normal_distribution<double> d(0, 1);
+    for (auto &x : v) x = z(g) < 0.9 ? 0. : d(g);
+}
+
+static void gen_integer(std::vector<double> &v, std::mt19937_64 &g)
+{
+    std::uniform_int_distribution<int> d(0, 65535);
+    for (auto &x : v) x = (double)d(g);
+}
+
+/* event times in microseconds about a millisecond apart */
+static void gen_timestamps(std::vector<double> &v, std::mt19937_64 &g)
+{
+    std::normal_distribution<double> d(1000, 50);
+    llong us = 1700000000000000ll;
+    for (auto &x : v) {
+        us += (llong)d(g);
+        x = (double)us / 1e6;
+    }
+}
+
+static const struct { const char *name; dataset_gen gen; } dataset_gens[] = {
+    { "uniform-0:1", gen_uniform_unit },
+    { "uniform-1e3", gen_uniform_1000 },
+    { "uniform-1e307", gen_uniform_1e307 },
+    { "walk", gen_walk },
+    { "weights", gen_weights },
+    { "sparse", gen_sparse },
+    { "integer", gen_integer },
+    { "timestamps", gen_timestamps },
+};
+
+/* raw little-endian f64 values, tiled or truncated to n */
+static bool dataset_load(const char *path, std::vector<double> &v)
+{
+    std::vector<double> file;
+    FILE *f = fopen(path, "rb");
+    double x;
+    if (!f) return false;
+    while (fread(&x, sizeof(x), 1, f) == 1) file.push_back(x);
+    fclose(f);
+    if (file.empty()) return false;
+    for (size_t i = 0; i < v.size(); i++) v[i] = file[i % file.size()];
+    return true;
+}
+
+static bool dataset_make(const char *name, size_t n, dataset &ds)
+{
+    std::mt19937_64 g(0);
+    ds.values.resize(n);
+    if (strncmp(name, "file:", 5) == 0) {
+        const char *base = strrchr(name + 5, '/');
+        ds.name = base ? base + 1 : name + 5;
+        return dataset_load(name + 5, ds.values);
+    }
+    for (size_t i = 0; i < array_size(dataset_gens); i++) {
+        if (strcmp(name, dataset_gens[i].name) == 0) {
+            ds.name = name;
+            dataset_gens[i].gen(ds.values, g);
+            return true;
+        }
+    }
+    return false;
+}
+
+/* best of repeat, each timing at least count values */
+template <typename F>
+static double time_best_ns(llong repeat, llong count, size_t n, F fn,
+    perf_counts *pc)
+{
+    double best = 0.;
+    llong passes = count > (llong)n ? (count + n - 1) / n : 1;
+    for (llong r = 0; r < llabs(repeat); r++) {
+        auto st = bench_start();
+        for (llong i = 0; i < passes; i++) fn();
+        auto et = bench_stop();
+        double t = (double)duration_cast<nanoseconds>(et - st).count() / passes;
+        if (best == 0. || t < best) {
+            best = t;
+            *pc = perf_last;
+            for (int i = 0; i < perf_counter_count; i++) {
+                pc->value[i] /= passes;
+            }
+        }
+    }
+    return best;
+}
+
+static void print_dataset_header()
+{
+    printf("%-16s %8s %-6s %-6s %9s %8s %11s\n",
+        "dataset", "size", "codec", "op", "ns/value", "GB/s", "bytes/value");
+    printf("%-16s %8s %-6s %-6s %9s %8s %11s\n",
+        "----------------", "--------", "------", "------",
+        "---------", "--------", "-----------");
+}
+
+static void print_dataset_result(const dataset &ds, size_t size,
+    const char *codec, const char *op, double t, size_t n, size_t bytes,
+    const perf_counts &pc)
+{
+    printf("%-16s %8s %-6s %-6s %9.3f %8.3f %11.3f\n",
+        ds.name.c_str(), format_size(size), codec, op,
+        t / n, (double)(n * sizeof(double)) / t, (double)bytes / n);
+    print_perf("  perf:", pc, (double)n);
+}
+
+static void run_dataset(const dataset &ds, size_t size, llong repeat, llong count)
+{
+    size_t n = ds.values.size(), vf_len, pk_len, cd_len, dd_len, asn_len;
+    std::vector<double> out(n);
+    vf_buf *vf = vf_buf_new(n * 11);
+    vf_buf *pk = vf_buf_new(n * 11 + 16);
+    vf_buf *cd = vf_buf_new(n * 11 + 16);
+    vf_buf *dd = vf_buf_new(n * 11 + 16);
+    vf_buf *asn = vf_buf_new(n * 13 + 16);
+    perf_counts pc;
+    double t;
+
+    assert(!vf_f64_write_array(vf, ds.values.data(), n));
+    vf_len = vf_buf_offset(vf);
+    assert(!vf_f64_write_packed(pk, ds.values.data(), n));
+    pk_len = vf_buf_offset(pk);
+    assert(!vf_f64_write_coded(cd, ds.values.data(), n));
+    cd_len = vf_buf_offset(cd);
+    assert(!vf_f64_write_dod(dd, ds.values.data(), n));
+    dd_len = vf_buf_offset(dd);
+    assert(!vf_asn1_der_real_f64_write_array(asn, asn1_tag_real, ds.values.data(), n));
+    asn_len = vf_buf_offset(asn);
+
+    t = time_best_ns(repeat, count, n, [&] {
+        vf_buf_reset(vf);
+        assert(!vf_f64_write_array(vf, ds.values.data(), n));
+    }, &pc);
+    print_dataset_result(ds, size, "vf128", "write", t, n, vf_len, pc);
+    t = time_best_ns(repeat, count, n, [&] {
+        vf_buf_reset(vf);
+        assert(!vf_f64_read_array(vf, out.data(), n));
+    }, &pc);
+    print_dataset_result(ds, size, "vf128", "read", t, n, vf_len, pc);
+    for (size_t i = 0; i < n; i++) {
+        assert(out[i] == ds.values[i] || (out[i] != out[i] && ds.values[i] != ds.values[i]));
+    }
+
+    /* a column sum, decoded into a vector or fused through decode_view */
+    double sum = 0, view_sum = 0;
+    t = time_best_ns(repeat, count, n, [&] {
+        vf_buf_reset(vf);
+        assert(!vf_f64_read_array(vf, out.data(), n));
+        sum = std::accumulate(out.begin(), out.end(), 0.0);
+    }, &pc);
+    print_dataset_result(ds, size, "vf128", "sum", t, n, vf_len, pc);
+    t = time_best_ns(repeat, count, n, [&] {
+        vf::decode_view<double> view(vf_span { vf_buf_data(vf), vf_len });
+        view_sum = std::accumulate(view.begin(), view.end(), 0.0);
+    }, &pc);
+    print_dataset_result(ds, size, "view", "sum", t, n, vf_len, pc);
+    assert(memcmp(&sum, &view_sum, sizeof(sum)) == 0);
+
+    t = time_best_ns(repeat, count, n, [&] {
+        vf_buf_reset(pk);
+        assert(!vf_f64_write_packed(pk, ds.values.data(), n));
+    }, &pc);
+    print_dataset_result(ds, size, "packed", "write", t, n, pk_len, pc);
+    t = time_best_ns(repeat, count, n, [&] {
+        vf_buf_reset(pk);
+        assert(!vf_f64_read_packed(pk, out.data(), n));
+    }, &pc);
+    print_dataset_result(ds, size, "packed", "read", t, n, pk_len, pc);
+    for (size_t i = 0; i < n; i++) {
+        assert(out[i] == ds.values[i] || (out[i] != out[i] && ds.values[i] != ds.values[i]));
+    }
+
+    t = time_best_ns(repeat, count, n, [&] {
+        vf_buf_reset(cd);
+        assert(!vf_f64_write_coded(cd, ds.values.data(), n));
+    }, &pc);
+    print_dataset_result(ds, size, "coded", "write", t, n, cd_len, pc);
+    t = time_best_ns(repeat, count, n, [&] {
+        vf_buf_reset(cd);
+        assert(!vf_f64_read_coded(cd, out.data(), n));
+    }, &pc);
+    print_dataset_result(ds, size, "coded", "read", t, n, cd_len, pc);
+    for (size_t i = 0; i < n; i++) {
+        assert(out[i] == ds.values[i] || (out[i] != out[i] && ds.values[i] != ds.values[i]));
+    }
+
+    t = time_best_ns(repeat, count, n, [&] {
+        vf_buf_reset(dd);
+        assert(!vf_f64_write_dod(dd, ds.values.data(), n));
+    }, &pc);
+    print_dataset_result(ds, size, "dod", "write", t, n, dd_len, pc);
+    t = time_best_ns(repeat, count, n, [&] {
+        vf_buf_reset(dd);
+        assert(!vf_f64_read_dod(dd, out.data(), n));
+    }, &pc);
+    print_dataset_result(ds, size, "dod", "read", t, n, dd_len, pc);
+    for (size_t i = 0; i < n; i++) {
+        assert(out[i] == ds.values[i] || (out[i] != out[i] && ds.values[i] != ds.values[i]));
+    }
+
+    t = time_best_ns(repeat, count, n, [&] {
+        vf_buf_reset(asn);
+        assert(!vf_asn1_der_real_f64_write_array(asn, asn1_tag_real, ds.values.data(), n));
+    }, &pc);
+    print_dataset_result(ds, size, "asn.1", "write", t, n, asn_len, pc);
+    t = time_best_ns(repeat, count, n, [&] {
+        size_t m = n;
+        vf_buf_reset(asn);
+        assert(!vf_asn1_der_real_f64_read_array(asn, asn1_tag_real, out.data(), &m));
+    }, &pc);
+    print_dataset_result(ds, size, "asn.1", "read", t, n, asn_len, pc);
+
+    t = time_best_ns(repeat, count, n, [&] {
+        memcpy(out.data(), ds.values.data(), n * sizeof(double));
+    }, &pc);
+    print_dataset_result(ds, size, "ieee", "copy", t, n, n * sizeof(double), pc);
+
+    vf_buf_destroy(vf);
+    vf_buf_destroy(pk);
+    vf_buf_destroy(cd);
+    vf_buf_destroy(dd);
+    vf_buf_destroy(asn);
+}
+
+/* L1, L2, L3 and DRAM resident input sizes */
+static const size_t dataset_sizes[] = { 16 << 10, 256 << 10, 4 << 20, 64 << 20 };
+
+static size_t parse_size(const char *s)
+{
+    char *end;
+    size_t v = strtoull(s, &end, 10);
+    switch (*end) {
+    case 'k': case 'K': return v << 10;
+    case 'm': case 'M': return v << 20;
+    case 'g': case 'G': return v << 30;
+    default: return v;
+    }
+}
+
+static void run_datasets(char *data, char *sizes, llong repeat, llong count)
+{
+    std::vector<const char*> names;
+    std::vector<size_t> sz;
+    char *save, *comp;
+
+    if (strcmp(data, "all") == 0) {
+        for (size_t i = 0; i < array_size(dataset_gens); i++) {
+            names.push_back(dataset_gens[i].name);
+        }
+    } else {
+        for (comp = strtok_r(data, ",", &save); comp; comp = strtok_r(nullptr, ",", &save)) {
+            names.push_back(comp);
+        }
+    }
+    if (sizes) {
+        for (comp = strtok_r(sizes, ",", &save); comp; comp = strtok_r(nullptr, ",", &save)) {
+            sz.push_back(parse_size(comp));
+        }
+    } else {
+        sz.assign(dataset_sizes, dataset_sizes + array_size(dataset_sizes));
+    }
+
+    print_dataset_header();
+    for (const char *name : names) {
+        for (size_t size : sz) {
+            dataset ds;
+            size_t n = size / sizeof(double);
+            if (n == 0) continue;
+            if (!dataset_make(name, n, ds)) {
+                fprintf(stderr, "unknown or unreadable dataset: %s\n", name);
+                exit(1);
+            }
+            run_dataset(ds, size, repeat, count);
+        }
+    }
+}
+
+
+/*
+ * thread scaling
+ *
+ * --threads runs the vf128 array write and read on N threads at once, each
+ * pinned to its own cpu and working on private buffers. with local
+ * placement the buffers are first touched by the thread that uses them.
+ * with remote placement they are first touched while the thread is pinned
+ * to a cpu on the next NUMA node, then the thread moves back to its own
+ * cpu. cpus are taken node by node so low thread counts stay on one socket.
+ */
+
+struct numa_topology
+{
+    std::vector<std::vector<int>> node_cpus;
+    std::vector<int> cpus;
+    std::vector<int> cpu_node;
+};
+
+static void parse_cpulist(const char *s, std::vector<int> &cpus)
+{
+    while (*s) {
+        char *end;
+        long lo = strtol(s, &end, 10), hi = lo;
+        if (end == s) break;
+        if (*end == '-') hi = strtol(end + 1, &end, 10);
+        for (long c = lo; c <= hi; c++) cpus.push_back((int)c);
+        s = *end == ',' ? end + 1 : end;
+    }
+}
+
+static numa_topology numa_probe()
+{
+    numa_topology topo;
+#if defined(__linux__)
+    for (int node = 0; ; node++) {
+        char path[64], line[4096];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *f = fopen(path, "r");
+        if (!f) break;
+        std::vector<int> cpus;
+        if (fgets(line, sizeof(line), f)) parse_cpulist(line, cpus);
+        fclose(f);
+        if (!cpus.empty()) topo.node_cpus.push_back(cpus);
+    }
+#endif
+    if (topo.node_cpus.empty()) {
+        std::vector<int> cpus;
+        unsigned n = std::thread::hardware_concurrency();
+        for (unsigned c = 0; c < (n ? n : 1); c++) cpus.push_back((int)c);
+        topo.node_cpus.push_back(cpus);
+    }
+    for (size_t node = 0; node < topo.node_cpus.size(); node++) {
+        for (int c : topo.node_cpus[node]) {
+            topo.cpus.push_back(c);
+            if ((size_t)c >= topo.cpu_node.size()) topo.cpu_node.resize(c + 1, 0);
+            topo.cpu_node[c] = (int)node;
+        }
+    }
+    return topo;
+}
+
+static void pin_cpu(int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+/* all threads leave together, the last to arrive resets the count */
+struct spin_barrier
+{
+    std::atomic<int> waiting{0}, phase{0};
+    int count;
+
+    void wait()
+    {
+        int p = phase.load();
+        if (waiting.fetch_add(1) + 1 == count) {
+            waiting.store(0);
+            phase.fetch_add(1);
+        } else {
+            while (phase.load() == p) std::this_thread::yield();
+        }
+    }
+};
+
+struct scaling_result
+{
+    double write_ns, read_ns;
+    size_t vf_len;
+};
+
+static scaling_result run_scaling(const numa_topology &topo, const dataset &ds,
+    int nthreads, bool remote, llong repeat, llong count)
+{
+    size_t n = ds.values.size();
+    llong passes = count > (llong)n ? (count + n - 1) / n : 1;
+    scaling_result res = { 0., 0., 0 };
+    std::vector<std::thread> threads;
+    high_resolution_clock::time_point st;
+    spin_barrier bar;
+
+    bar.count = nthreads + 1;
+    for (int t = 0; t < nthreads; t++) {
+        threads.emplace_back([&, t] {
+            int cpu = topo.cpus[t % topo.cpus.size()];
+            int home = topo.cpu_node[cpu], nodes = (int)topo.node_cpus.size();
+            if (remote) {
+                const std::vector<int> &other = topo.node_cpus[(home + 1) % nodes];
+                pin_cpu(other[t % other.size()]);
+            } else {
+                pin_cpu(cpu);
+            }
+            std::vector<double> in(ds.values), out(n);
+            vf_buf *vf = vf_buf_new(n * 11);
+            memset(vf->data, 0, vf->data_size);
+            assert(!vf_f64_write_array(vf, in.data(), n));
+            if (t == 0) res.vf_len = vf_buf_offset(vf);
+            pin_cpu(cpu);
+            bar.wait();
+
+            for (llong r = 0; r < llabs(repeat); r++) {
+                bar.wait();
+                for (llong i = 0; i < passes; i++) {
+                    vf_buf_reset(vf);
+                    assert(!vf_f64_write_array(vf, in.data(), n));
+                }
+                bar.wait();
+                bar.wait();
+                for (llong i = 0; i < passes; i++) {
+                    vf_buf_reset(vf);
+                    assert(!vf_f64_read_array(vf, out.data(), n));
+                }
+                bar.wait();
+            }
+            vf_buf_destroy(vf);
+        });
+    }
+
+    /* wait for the workers to copy and encode their inputs, then take
+     * wall time from the release of the start barrier to the last thread */
+    bar.wait();
+    for (llong r = 0; r < llabs(repeat); r++) {
+        st = high_resolution_clock::now();
+        bar.wait();
+        bar.wait();
+        double tw = (double)duration_cast<nanoseconds>(high_resolution_clock::now() - st).count() / passes;
+        st = high_resolution_clock::now();
+        bar.wait();
+        bar.wait();
+        double tr = (double)duration_cast<nanoseconds>(high_resolution_clock::now() - st).count() / passes;
+        if (res.write_ns == 0. || tw < res.write_ns) res.write_ns = tw;
+        if (res.read_ns == 0. || tr < res.read_ns) res.read_ns = tr;
+    }
+    for (auto &th : threads) th.join();
+    return res;
+}
+
+static void print_scaling_result(const dataset &ds, size_t size, int nthreads,
+    const char *numa, const char *op, double t, size_t n, size_t bytes)
+{
+    double gbs = (double)(n * sizeof(double)) * nthreads / t;
+    printf("%-16s %8s %7d %-6s %-6s %9.3f %9.3f %11.3f\n",
+        ds.name.c_str(), format_size(size), nthreads, numa, op,
+        gbs, gbs / nthreads, (double)bytes / n);
+}
+
+static void run_thread_scaling(char *data, char *sizes, char *thread_list,
+    llong repeat, llong count)
+{
+    numa_topology topo = numa_probe();
+    std::vector<int> nthreads;
+    std::vector<size_t> sz;
+    char *save, *comp;
+
+    if (strcmp(thread_list, "all") == 0) {
+        for (size_t t = 1; t < topo.cpus.size(); t <<= 1) nthreads.push_back((int)t);
+        nthreads.push_back((int)topo.cpus.size());
+    } else {
+        for (comp = strtok_r(thread_list, ",", &save); comp; comp = strtok_r(nullptr, ",", &save)) {
+            if (atoi(comp) > 0) nthreads.push_back(atoi(comp));
+        }
+    }
+    if (sizes) {
+        for (comp = strtok_r(sizes, ",", &save); comp; comp = strtok_r(nullptr, ",", &save)) {
+            sz.push_back(parse_size(comp));
+        }
+    } else {
+        sz.push_back(64 << 20);
+    }
+
+    printf("cpus: %zu, numa nodes: %zu\n", topo.cpus.size(), topo.node_cpus.size());
+    printf("%-16s %8s %7s %-6s %-6s %9s %9s %11s\n",
+        "dataset", "size", "threads", "numa", "op", "GB/s", "GB/s/thr", "bytes/value");
+    printf("%-16s %8s %7s %-6s %-6s %9s %9s %11s\n",
+        "----------------", "--------", "-------", "------", "------",
+        "---------", "---------", "-----------");
+    for (comp = strtok_r(data, ",", &save); comp; comp = strtok_r(nullptr, ",", &save)) {
+        for (size_t size : sz) {
+            dataset ds;
+            size_t n = size / sizeof(double);
+            if (n == 0) continue;
+            if (!dataset_make(comp, n, ds)) {
+                fprintf(stderr, "unknown or unreadable dataset: %s\n", comp);
+                exit(1);
+            }
+            for (int t : nthreads) {
+                for (int remote = 0; remote < (topo.node_cpus.size() > 1 ? 2 : 1); remote++) {
+                    const char *numa = remote ? "remote" : "local";
+                    scaling_result r = run_scaling(topo, ds, t, remote, repeat, count);
+                    print_scaling_result(ds, size, t, numa, "write", r.write_ns, n, r.vf_len);
+                    print_scaling_result(ds, size, t, numa, "read", r.read_ns, n, r.vf_len);
+                }
+            }
+        }
+    }
+}
+
+
 int main(int argc, char **argv)
 {
     llong bench_num = -1, repeat = 1, count = 10000000, pause_ms = 0;
+    char *data = nullptr, *sizes = nullptr, *threads = nullptr;
+    int j = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--data=", 7) == 0) {
+            data = argv[i] + 7;
+        } else if (strncmp(argv[i], "--size=", 7) == 0) {
+            sizes = argv[i] + 7;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = argv[i] + 10;
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            perf_enabled = true;
+        } else {
+            argv[j++] = argv[i];
+        }
+    }
+    argc = j;
+    if (perf_enabled) perf_init();
+    if (threads && argc == 1) {
+        char def_data[] = "uniform-1e3";
+        printf("kernel: %s\n", vf_kernel_name(vf_kernel_get()));
+        run_thread_scaling(data ? data : def_data, sizes, threads, 3, 100000000);
+        exit(0);
+    }
+    if (data && argc == 1) {
+        printf("kernel: %s\n", vf_kernel_name(vf_kernel_get()));
+        run_datasets(data, sizes, 3, count);
+        exit(0);
+    }
     if (argc != 5) {
         fprintf(stderr, "usage: %s [bench_num(,…)] [repeat] [count] [pause_ms]\n", argv[0]);
+        fprintf(stderr, "       %s --data=<name|file:path|all>(,…) [--size=<n[K|M|G]>(,…)]"
+            " [-1 repeat count pause_ms]\n", argv[0]);
+        fprintf(stderr, "       %s --threads=<n|all>(,…) [--data=<name>(,…)] [--size=<n[K|M|G]>(,…)]"
+            " [-1 repeat count pause_ms]\n", argv[0]);
+        fprintf(stderr, "       --perf adds hardware counters per op (Linux perf_event_open)\n");
         fprintf(stderr, "\ne.g.   %s -1 -10 10000000 1000\n", argv[0]);
+        fprintf(stderr, "       %s --data=all --size=16K,64M\n", argv[0]);
+        fprintf(stderr, "       %s --threads=all --data=walk --size=256M\n", argv[0]);
+        fprintf(stderr, "\ndatasets:");
+        for (size_t i = 0; i < array_size(dataset_gens); i++) {
+            fprintf(stderr, " %s", dataset_gens[i].name);
+        }
+        fprintf(stderr, "\n");
         exit(0);
     }
     if (argc > 1) {
@@ -704,6 +2736,16 @@ int main(int argc, char **argv)
     if (argc > 4) {
         pause_ms = atoll(argv[4]);
     }
+    printf("kernel: %s\n", vf_kernel_name(vf_kernel_get()));
+    if (threads) {
+        char def_data[] = "uniform-1e3";
+        run_thread_scaling(data ? data : def_data, sizes, threads, repeat, count);
+        exit(0);
+    }
+    if (data) {
+        run_datasets(data, sizes, repeat, count);
+        exit(0);
+    }
     if (repeat < 0) {
         print_header("     ");
         print_rules("     ");
@@ -1,5 +1,6 @@
 #undef NDEBUG
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <math.h>
@@ -123,9 +124,1097 @@ void test_vf32_loop()
     test_vf32(0.000001f);
 }
 
+static double test_array_value(size_t i)
+{
+    union { u64 u; f64 d; } subnormal = { 0x1ull + i };
+    switch (i % 8) {
+    case 0: return (double)i * 0.0625;
+    case 1: return -3.141592653589793 * (double)i;
+    case 2: return 1.0 / (double)(i + 1);
+    case 3: return (double)(1ull << (i % 60));
+    case 4: return subnormal.d;
+    case 5: return i & 8 ? _f64_inf() : -0.0;
+    case 6: return 1e300 / (double)(i + 1);
+    default: return -1e-300 * (double)i;
+    }
+}
+
+/*
+ * headers 0x01 and 0x41 hold the inline mantissa 1, ±2^-4, where the
+ * subnormal normalization shifts by the full register width.
+ */
+void test_inline_one()
+{
+    static const unsigned char rec[] = { 0x01, 0x41 };
+    vf_buf *buf = vf_buf_new(16);
+    double d[2];
+    float f[2];
+
+    assert(!vf_f64_write_byval(buf, 0x1p-4));
+    assert(!vf_f32_write_byval(buf, -0x1p-4f));
+    assert(vf_buf_offset(buf) == 2);
+    assert(memcmp(vf_buf_data(buf), rec, 2) == 0);
+
+    vf_buf_reset(buf);
+    assert(!vf_f64_read(buf, &d[0]) && d[0] == 0x1p-4);
+    assert(vf_f64_read_byval(buf).value == -0x1p-4);
+    vf_buf_reset(buf);
+    assert(!vf_f32_read(buf, &f[0]) && f[0] == 0x1p-4f);
+    assert(vf_f32_read_byval(buf).value == -0x1p-4f);
+    for (int isa = 0; isa <= (int)vf_kernel_best(); isa++) {
+        assert(!vf_kernel_set((vf_kernel_isa)isa));
+        vf_buf_reset(buf);
+        assert(!vf_f64_read_array(buf, d, 2));
+        assert(d[0] == 0x1p-4 && d[1] == -0x1p-4);
+        vf_buf_reset(buf);
+        assert(!vf_f32_read_array(buf, f, 2));
+        assert(f[0] == 0x1p-4f && f[1] == -0x1p-4f);
+    }
+    vf_kernel_set(vf_kernel_best());
+
+    vf_buf_destroy(buf);
+}
+
+void test_array(vf_kernel_isa isa)
+{
+    enum { count = 1000 };
+    static double f64_in[count], f64_out[count];
+    static float f32_in[count], f32_out[count];
+    vf_buf *buf1 = vf_buf_new(count * 11);
+    vf_buf *buf2 = vf_buf_new(count * 11);
+
+    if (vf_kernel_set(isa) < 0) {
+        printf("\narray kernel %s not supported\n", vf_kernel_name(isa));
+        return;
+    }
+    printf("\narray kernel %s\n", vf_kernel_name(isa));
+
+    for (size_t i = 0; i < count; i++) {
+        f64_in[i] = test_array_value(i);
+        f32_in[i] = (float)f64_in[i];
+    }
+
+    /* array output must match the scalar codec byte for byte */
+    for (size_t i = 0; i < count; i++) {
+        assert(!vf_f64_write(buf1, &f64_in[i]));
+    }
+    assert(!vf_f64_write_array(buf2, f64_in, count));
+    assert(vf_buf_offset(buf1) == vf_buf_offset(buf2));
+    assert(memcmp(vf_buf_data(buf1), vf_buf_data(buf2), vf_buf_offset(buf1)) == 0);
+    vf_buf_reset(buf2);
+    assert(!vf_f64_read_array(buf2, f64_out, count));
+    for (size_t i = 0; i < count; i++) {
+        assert(memcmp(&f64_in[i], &f64_out[i], sizeof(double)) == 0);
+    }
+
+    vf_buf_reset(buf1);
+    vf_buf_reset(buf2);
+    for (size_t i = 0; i < count; i++) {
+        assert(!vf_f32_write(buf1, &f32_in[i]));
+    }
+    assert(!vf_f32_write_array(buf2, f32_in, count));
+    assert(vf_buf_offset(buf1) == vf_buf_offset(buf2));
+    assert(memcmp(vf_buf_data(buf1), vf_buf_data(buf2), vf_buf_offset(buf1)) == 0);
+    vf_buf_reset(buf2);
+    assert(!vf_f32_read_array(buf2, f32_out, count));
+    for (size_t i = 0; i < count; i++) {
+        assert(memcmp(&f32_in[i], &f32_out[i], sizeof(float)) == 0);
+    }
+
+    /* writes past the end of the buffer fail */
+    vf_buf_seek(buf2, count * 11 - 4);
+    assert(vf_f64_write_array(buf2, f64_in, count) < 0);
+
+    vf_buf_destroy(buf1);
+    vf_buf_destroy(buf2);
+}
+
+void test_array_loop()
+{
+    vf_kernel_isa best = vf_kernel_best();
+    test_array(vf_kernel_scalar);
+    test_array(vf_kernel_bmi2);
+    test_array(vf_kernel_avx2);
+    test_array(vf_kernel_avx512);
+    vf_kernel_set(best);
+}
+
+void test_unpadded()
+{
+    enum { count = 64 };
+    double in[count], out[count];
+    vf_buf *buf = vf_buf_new(count * 11);
+    vf_buf nopad = { 0 };
+
+    for (size_t i = 0; i < count; i++) {
+        in[i] = test_array_value(i);
+        assert(!vf_f64_write(buf, &in[i]));
+    }
+
+    /* exact size copy without tail padding uses the checked reads */
+    nopad.data = (char*)malloc(vf_buf_offset(buf));
+    nopad.data_offset = 0;
+    nopad.data_size = vf_buf_offset(buf);
+    nopad.data_pad = 0;
+    memcpy(nopad.data, vf_buf_data(buf), nopad.data_size);
+
+    for (size_t i = 0; i < count; i++) {
+        assert(!vf_f64_read(&nopad, &out[i]));
+        assert(memcmp(&in[i], &out[i], sizeof(double)) == 0);
+    }
+    assert(vf_f64_read(&nopad, &out[0]) < 0);
+    vf_buf_reset(&nopad);
+    assert(!vf_f64_read_array(&nopad, out, count));
+    assert(memcmp(in, out, sizeof(in)) == 0);
+
+    /* truncated record */
+    vf_buf_reset(&nopad);
+    nopad.data_size = 5;
+    assert(vf_f64_read_array(&nopad, out, count) < 0);
+
+    free(nopad.data);
+    vf_buf_destroy(buf);
+}
+
+void test_asn1_array()
+{
+    enum { count = 1000 };
+    static double in[count], out[count];
+    vf_buf *buf1 = vf_buf_new(count * 13 + 8);
+    vf_buf *buf2 = vf_buf_new(count * 13 + 8);
+    size_t n = count, hdr;
+
+    for (size_t i = 0; i < count; i++) {
+        in[i] = test_array_value(i);
+        assert(!vf_asn1_der_real_f64_write(buf1, asn1_tag_real, &in[i]));
+    }
+
+    /* sequence elements must match the scalar codec byte for byte */
+    assert(!vf_asn1_der_real_f64_write_array(buf2, asn1_tag_real, in, count));
+    hdr = vf_buf_offset(buf2) - vf_buf_offset(buf1);
+    assert(memcmp(vf_buf_data(buf1), vf_buf_data(buf2) + hdr, vf_buf_offset(buf1)) == 0);
+    vf_buf_reset(buf2);
+    assert(!vf_asn1_der_real_f64_read_array(buf2, asn1_tag_real, out, &n));
+    assert(n == count);
+    assert(memcmp(in, out, sizeof(in)) == 0);
+
+    /* output capacity and buffer capacity are checked */
+    vf_buf_reset(buf2);
+    n = count - 1;
+    assert(vf_asn1_der_real_f64_read_array(buf2, asn1_tag_real, out, &n) < 0);
+    assert(n == count - 1);
+    vf_buf_seek(buf2, count * 13 + 8 - hdr - 4);
+    assert(vf_asn1_der_real_f64_write_array(buf2, asn1_tag_real, in, count) < 0);
+
+    /* an exactly sized buffer and short sequences give the same bytes */
+    size_t used = vf_buf_offset(buf1) + hdr;
+    vf_buf_reset(buf2);
+    buf2->data_size = used;
+    assert(!vf_asn1_der_real_f64_write_array(buf2, asn1_tag_real, in, count));
+    assert(vf_buf_offset(buf2) == used);
+    assert(memcmp(vf_buf_data(buf1), vf_buf_data(buf2) + hdr, vf_buf_offset(buf1)) == 0);
+    buf2->data_size = count * 13 + 8;
+    for (size_t m = 0; m < 30; m++) {
+        vf_buf_reset(buf1);
+        vf_buf_reset(buf2);
+        for (size_t i = 0; i < m; i++) {
+            assert(!vf_asn1_der_real_f64_write(buf1, asn1_tag_real, &in[i]));
+        }
+        assert(!vf_asn1_der_real_f64_write_array(buf2, asn1_tag_real, in, m));
+        hdr = vf_buf_offset(buf2) - vf_buf_offset(buf1);
+        assert(hdr == 1 + vf_asn1_ber_length_length(vf_buf_offset(buf1)));
+        assert(memcmp(vf_buf_data(buf1), vf_buf_data(buf2) + hdr, vf_buf_offset(buf1)) == 0);
+        vf_buf_reset(buf2);
+        n = count;
+        assert(!vf_asn1_der_real_f64_read_array(buf2, asn1_tag_real, out, &n) && n == m);
+    }
+
+    /* element lengths past the sequence and foreign tags are rejected */
+    static const char overread[] = "\x30\x09\x6f\x88\xb5\xb5\xe9\x24\x82\xfb\xf6\x87\xa7\x07\xe7\xbc";
+    static const char foreign[] = "\x30\x06\x09\x00\x04\x81\x01\x00";
+    vf_buf_reset(buf2);
+    vf_buf_write_bytes(buf2, overread, 16);
+    buf2->data_size = 16;
+    vf_buf_reset(buf2);
+    n = count;
+    assert(vf_asn1_der_real_f64_read_array(buf2, asn1_tag_real, out, &n) < 0 && n == 0);
+    vf_buf_reset(buf2);
+    vf_buf_write_bytes(buf2, foreign, 8);
+    buf2->data_size = 8;
+    vf_buf_reset(buf2);
+    n = count;
+    assert(vf_asn1_der_real_f64_read_array(buf2, asn1_tag_real, out, &n) < 0 && n == 1);
+
+    vf_buf_destroy(buf1);
+    vf_buf_destroy(buf2);
+}
+
+typedef struct { const char *data; size_t len; double value; int error; } real_vec;
+
+#define REAL_VEC(s,v,e) { s, sizeof(s) - 1, v, e }
+#define PI_FRAC "\x03\x24\x3F\x6A\x88\x85\xA3"
+
+static const real_vec real_vecs[] = {
+    REAL_VEC("", 0.0, 0),
+    REAL_VEC("\x40", INFINITY, 0),
+    REAL_VEC("\x41", -INFINITY, 0),
+    REAL_VEC("\x43", -0.0, 0),
+    REAL_VEC("\x44", 0.0, -1),
+    REAL_VEC("\x80\xD0" PI_FRAC, 3.141592653589793, 0),
+    REAL_VEC("\x90\xF0" PI_FRAC, 3.141592653589793, 0),
+    REAL_VEC("\xA0\xF4" PI_FRAC, 3.141592653589793, 0),
+    REAL_VEC("\xA4\xF3\x19\x21\xFB\x54\x44\x2D\x18", 3.141592653589793, 0),
+    REAL_VEC("\x82\xFF\xFF\xD0" PI_FRAC, 3.141592653589793, 0),
+    REAL_VEC("\x83\x01\xD0" PI_FRAC, 3.141592653589793, 0),
+    REAL_VEC("\x83\x0A\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xD0" PI_FRAC, 3.141592653589793, 0),
+    REAL_VEC("\x83\x08\xFF\xFF\xFF\xFF\xFF\xFF\xFC\x00\x01", 0x1p-1024, 0),
+    REAL_VEC("\xC0\x00\x01", -1.0, 0),
+    REAL_VEC("\x81\xF0\x00\x01", 0.0, 0),
+    REAL_VEC("\x81\x7F\xFF\x01", INFINITY, 0),
+    REAL_VEC("\xB0\x00\x01", 0.0, -1),
+    REAL_VEC("\x03" "3141592653589793.E-15", 3.141592653589793, 0),
+    REAL_VEC("\x03" "3.14159265358979323846264338327950288E0", 3.141592653589793, 0),
+    REAL_VEC("\x03" "4.9406564584124654E-324", 4.9406564584124654e-324, 0),
+    REAL_VEC("\x03" "1E400", INFINITY, 0),
+    REAL_VEC("\x02" "-0,5", -0.5, 0),
+    REAL_VEC("\x01" " 42", 42.0, 0),
+    REAL_VEC("\x01" "4.2", 0.0, -1),
+    REAL_VEC("\x03" "4.2", 0.0, -1),
+    REAL_VEC("\x04" "42", 0.0, -1),
+};
+
+void test_asn1_real_forms()
+{
+    static const unsigned char min_sub[] = { 0x09, 0x04, 0x81, 0xfb, 0xce, 0x01 };
+    static const double sub[] = { 5e-324, 1e-310, -1e-310 };
+    vf_buf *buf = vf_buf_new(128);
+    double f;
+
+    for (size_t i = 0; i < sizeof(real_vecs) / sizeof(real_vecs[0]); i++) {
+        const real_vec *v = &real_vecs[i];
+        vf_buf_reset(buf);
+        vf_buf_write_bytes(buf, v->data, v->len);
+        vf_buf_reset(buf);
+        int ret = vf_asn1_ber_real_f64_read(buf, v->len, &f);
+        assert(ret == v->error);
+        if (ret == 0) {
+            assert(memcmp(&f, &v->value, sizeof(double)) == 0);
+            assert(vf_buf_offset(buf) == v->len);
+        }
+    }
+
+    vf_buf_reset(buf);
+    vf_buf_write_bytes(buf, "\x42", 1);
+    vf_buf_reset(buf);
+    assert(!vf_asn1_ber_real_f64_read(buf, 1, &f) && isnan(f));
+
+    /* the writer uses the X.690 codes, 0x42 for NaN and 0x43 for -0 */
+    vf_buf_reset(buf);
+    assert(!vf_asn1_der_real_f64_write_byval(buf, asn1_tag_real, NAN));
+    assert(!vf_asn1_der_real_f64_write_byval(buf, asn1_tag_real, -0.0));
+    assert(vf_buf_offset(buf) == 6);
+    assert(memcmp(vf_buf_data(buf), "\x09\x01\x42\x09\x01\x43", 6) == 0);
+
+    /* subnormals carry the exponent of their lowest set bit */
+    vf_buf_reset(buf);
+    assert(!vf_asn1_der_real_f64_write_byval(buf, asn1_tag_real, sub[0]));
+    assert(vf_buf_offset(buf) == sizeof(min_sub));
+    assert(memcmp(vf_buf_data(buf), min_sub, sizeof(min_sub)) == 0);
+    for (size_t i = 0; i < sizeof(sub) / sizeof(sub[0]); i++) {
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f64_write(buf, asn1_tag_real, &sub[i]));
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f64_read(buf, asn1_tag_real, &f) && f == sub[i]);
+    }
+
+    /* a long form length near 2^64 must not wrap the capacity check */
+    vf_buf_reset(buf);
+    vf_buf_write_bytes(buf, "\x09\x88\xff\xff\xff\xff\xff\xff\xff\xf8\x80\x00\x01", 13);
+    buf->data_size = 13;
+    vf_buf_reset(buf);
+    assert(vf_asn1_der_real_f64_read(buf, asn1_tag_real, &f) < 0);
+
+    vf_buf_destroy(buf);
+}
+
+void test_asn1_real_types()
+{
+    static const unsigned char pi_asn_f32[] = { 0x80, 0xED, 0x19, 0x21, 0xFB };
+    vf_buf *buf = vf_buf_new(128);
+    float f;
+
+    /* f32 contents are minimal for the f32 layout */
+    assert(vf_asn1_ber_real_f32_length(&pi_f32) == sizeof(pi_asn_f32));
+    assert(!vf_asn1_ber_real_f32_write(buf, sizeof(pi_asn_f32), &pi_f32));
+    assert(memcmp(vf_buf_data(buf), pi_asn_f32, sizeof(pi_asn_f32)) == 0);
+
+    /* f64 contents round to nearest f32 */
+    vf_buf_reset(buf);
+    vf_buf_write_bytes(buf, (const char*)pi_asn, sizeof(pi_asn));
+    vf_buf_reset(buf);
+    assert(!vf_asn1_ber_real_f32_read(buf, sizeof(pi_asn), &f));
+    assert(f == (float)pi_f64);
+
+    for (size_t i = 0; i < 1000; i++) {
+        double v = test_array_value(i);
+        float v32 = (float)v, r32;
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f32_write(buf, asn1_tag_real, &v32));
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f32_read(buf, asn1_tag_real, &r32));
+        assert(memcmp(&v32, &r32, sizeof(float)) == 0);
+#if defined(VF_HAS_F80)
+        f80 v80 = (f80)v / 3, r80;
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f80_write(buf, asn1_tag_real, &v80));
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f80_read(buf, asn1_tag_real, &r80));
+        assert(r80 == v80 || (isnan(v80) && isnan(r80)));
+#endif
+#if defined(VF_HAS_F128)
+        f128 v128 = (f128)v / 3, r128;
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f128_write(buf, asn1_tag_real, &v128));
+        vf_buf_reset(buf);
+        assert(!vf_asn1_der_real_f128_read(buf, asn1_tag_real, &r128));
+        assert(memcmp(&v128, &r128, sizeof(f128)) == 0);
+#endif
+    }
+
+    /* contents with a long form length near 2^64 fail in every precision */
+    vf_buf_reset(buf);
+    vf_buf_write_bytes(buf, "\x09\x88\xff\xff\xff\xff\xff\xff\xff\xf8\x80\x00\x01", 13);
+    buf->data_size = 13;
+    vf_buf_reset(buf);
+    assert(vf_asn1_der_real_f32_read(buf, asn1_tag_real, &f) < 0);
+    vf_buf_reset(buf);
+    assert(vf_asn1_der_real_f32_read_byval(buf, asn1_tag_real).error < 0);
+#if defined(VF_HAS_F80)
+    f80 r80;
+    vf_buf_reset(buf);
+    assert(vf_asn1_der_real_f80_read(buf, asn1_tag_real, &r80) < 0);
+#endif
+#if defined(VF_HAS_F128)
+    f128 r128;
+    vf_buf_reset(buf);
+    assert(vf_asn1_der_real_f128_read(buf, asn1_tag_real, &r128) < 0);
+#endif
+
+    vf_buf_destroy(buf);
+}
+
+void test_decimal()
+{
+    static const struct { const char *in; const char *out; } vecs[] = {
+        { "3.141592653589793", "3.141592653589793" },
+        { "0.1", "0.1" },
+        { "-0", "-0" },
+        { "  42", "42" },
+        { "1e23", "1e+23" },
+        { "123456789012345678901234567890", "1.2345678901234568e+29" },
+        { "4.9406564584124654E-324", "5e-324" },
+        { ".000015", "0.000015" },
+        { "1e-6", "1e-06" },
+        { "1e400", "inf" },
+        { "-Infinity", "-inf" },
+        { "nan", "nan" },
+    };
+    vf_buf *buf = vf_buf_new(128);
+    char str[32];
+
+    for (size_t i = 0; i < sizeof(vecs) / sizeof(vecs[0]); i++) {
+        vf_buf_reset(buf);
+        assert(!vf_f64_write_decimal(buf, vecs[i].in, strlen(vecs[i].in)));
+        vf_buf_reset(buf);
+        assert(vf_f64_read_decimal(buf, str, sizeof(str)) == (int)strlen(vecs[i].out));
+        assert(strcmp(str, vecs[i].out) == 0);
+    }
+
+    /* output must round-trip */
+    for (size_t i = 0; i < 1000; i++) {
+        double f = test_array_value(i), r;
+        vf_buf_reset(buf);
+        assert(!vf_f64_write(buf, &f));
+        vf_buf_reset(buf);
+        assert(vf_f64_read_decimal(buf, str, sizeof(str)) > 0);
+        r = strtod(str, NULL);
+        assert(memcmp(&f, &r, sizeof(double)) == 0);
+    }
+
+    /* malformed input and short output */
+    assert(vf_f64_write_decimal(buf, "1.2.3", 5) < 0);
+    assert(vf_f64_write_decimal(buf, "e5", 2) < 0);
+    vf_buf_reset(buf);
+    assert(!vf_f64_write_decimal(buf, "0.125", 5));
+    vf_buf_reset(buf);
+    assert(vf_f64_read_decimal(buf, str, 5) < 0);
+    assert(vf_buf_offset(buf) == 0);
+
+    vf_buf_destroy(buf);
+}
+
+void test_transcode()
+{
+    enum { count = 5000 };
+    vf_buf *asn1 = vf_buf_new(count * 16), *asn2 = vf_buf_new(count * 16);
+    vf_buf *vf1 = vf_buf_new(count * 16), *vf2 = vf_buf_new(count * 16);
+    u64 x = 0x9e3779b97f4a7c15ull;
+
+    /* output must match the scalar codecs byte for byte */
+    for (size_t i = 0; i < count; i++) {
+        union { u64 u; f64 d; } r;
+        if (i < 1000) {
+            r.d = test_array_value(i);
+        } else {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+            r.u = x;
+            if (r.d != r.d) r.u >>= 1;
+        }
+        assert(!vf_asn1_der_real_f64_write(asn1, asn1_tag_real, &r.d));
+        assert(!vf_f64_write(vf1, &r.d));
+    }
+    vf_buf_reset(asn1);
+    assert(!vf_transcode_asn1_to_vf128(vf2, asn1, count));
+    assert(vf_buf_offset(vf1) == vf_buf_offset(vf2));
+    assert(memcmp(vf_buf_data(vf1), vf_buf_data(vf2), vf_buf_offset(vf1)) == 0);
+    vf_buf_reset(vf1);
+    assert(!vf_transcode_vf128_to_asn1(asn2, vf1, count));
+    assert(vf_buf_offset(asn1) == vf_buf_offset(asn2));
+    assert(memcmp(vf_buf_data(asn1), vf_buf_data(asn2), vf_buf_offset(asn1)) == 0);
+
+    /* non-canonical REAL forms are rounded as by the scalar decoder */
+    for (size_t i = 0; i < sizeof(real_vecs) / sizeof(real_vecs[0]); i++) {
+        const real_vec *v = &real_vecs[i];
+        vf_buf_reset(asn1);
+        vf_buf_reset(vf1);
+        vf_buf_reset(vf2);
+        vf_buf_write_i8(asn1, asn1_tag_real);
+        vf_buf_write_i8(asn1, (s8)v->len);
+        vf_buf_write_bytes(asn1, v->data, v->len);
+        vf_buf_reset(asn1);
+        if (v->error) {
+            assert(vf_transcode_asn1_to_vf128(vf2, asn1, 1) < 0);
+            continue;
+        }
+        assert(!vf_transcode_asn1_to_vf128(vf2, asn1, 1));
+        assert(!vf_f64_write_byval(vf1, v->value));
+        assert(vf_buf_offset(vf1) == vf_buf_offset(vf2));
+        assert(memcmp(vf_buf_data(vf1), vf_buf_data(vf2), vf_buf_offset(vf1)) == 0);
+    }
+
+    /* short output is an error */
+    vf_buf_reset(vf1);
+    vf_buf_seek(asn2, count * 16 - 4);
+    assert(vf_transcode_vf128_to_asn1(asn2, vf1, count) < 0);
+
+    /* wrapping long form lengths and tags other than REAL are errors */
+    static const struct { const char *data; size_t len; } bad[] = {
+        { "\x09\x88\xff\xff\xff\xff\xff\xff\xff\xf8\x80\x00\x01", 13 },
+        { "\x04\x01\x00", 3 },
+        { "\x04\x81\x01\x00", 4 },
+        { "\x29\x81\x01\x00", 4 },
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        vf_buf_reset(asn1);
+        vf_buf_reset(vf2);
+        vf_buf_write_bytes(asn1, bad[i].data, bad[i].len);
+        asn1->data_size = bad[i].len;
+        vf_buf_reset(asn1);
+        assert(vf_transcode_asn1_to_vf128(vf2, asn1, 1) < 0);
+    }
+
+    vf_buf_destroy(asn1);
+    vf_buf_destroy(asn2);
+    vf_buf_destroy(vf1);
+    vf_buf_destroy(vf2);
+}
+
+/*
+ * write count values with wr, then read them back with rd under every
+ * kernel: one byte short must fail and the full length must end at the
+ * written offset and reproduce the size bytes of in. returns the length.
+ */
+typedef int (*codec_write)(vf_buf *buf, const void *in, size_t count, const void *arg);
+typedef int (*codec_read)(vf_buf *buf, void *out, size_t count, const void *arg);
+
+static size_t test_codec(vf_buf *buf, codec_write wr, codec_read rd, const void *arg,
+    const void *in, void *out, size_t count, size_t size)
+{
+    size_t cap = buf->data_size, used;
+
+    vf_buf_reset(buf);
+    assert(!wr(buf, in, count, arg));
+    used = vf_buf_offset(buf);
+    for (int isa = 0; isa <= (int)vf_kernel_best(); isa++) {
+        assert(!vf_kernel_set((vf_kernel_isa)isa));
+        vf_buf_reset(buf);
+        buf->data_size = used - 1;
+        assert(rd(buf, out, count, arg) < 0);
+        vf_buf_reset(buf);
+        buf->data_size = used;
+        assert(!rd(buf, out, count, arg));
+        assert(vf_buf_offset(buf) == used);
+        assert(memcmp(in, out, size) == 0);
+    }
+    vf_kernel_set(vf_kernel_best());
+    buf->data_size = cap;
+
+    return used;
+}
+
+/* arg points to the codec, LEB128 u64 and s64 then VLU u64 and s64 */
+static int varint_write(vf_buf *b, const void *in, size_t n, const void *a)
+{
+    const u64 *v = in;
+    int ret = 0;
+    for (size_t i = 0; i < n && ret == 0; i++) {
+        switch (*(const int*)a) {
+        case 0: ret = vf_leb128_u64_write(b, &v[i]); break;
+        case 1: ret = vf_leb128_s64_write(b, (const s64*)&v[i]); break;
+        case 2: ret = vf_vlu_u64_write(b, &v[i]); break;
+        case 3: ret = vf_vlu_s64_write(b, (const s64*)&v[i]); break;
+        }
+    }
+    return ret;
+}
+
+static int varint_read(vf_buf *b, void *out, size_t n, const void *a)
+{
+    switch (*(const int*)a) {
+    case 0: return vf_leb128_u64_read_array(b, out, n);
+    case 1: return vf_leb128_s64_read_array(b, out, n);
+    case 2: return vf_vlu_u64_read_array(b, out, n);
+    default: return vf_vlu_s64_read_array(b, out, n);
+    }
+}
+
+void test_varint()
+{
+    enum { count = 1000 };
+    static u64 in[count], out[count];
+    static const u8 i12_leb[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x20 };
+    static const u8 i12_vlu[] = { 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40 };
+    vf_buf *buf = vf_buf_new(count * 10);
+    u64 x = 0x9e3779b97f4a7c15ull;
+    s64 s;
+
+    assert(!vf_leb128_u64_write_byval(buf, 1ull << 54));
+    assert(!vf_vlu_u64_write_byval(buf, 1ull << 54));
+    assert(memcmp(vf_buf_data(buf), i12_leb, 8) == 0);
+    assert(memcmp(vf_buf_data(buf) + 8, i12_vlu, 8) == 0);
+    vf_buf_reset(buf);
+    assert(!vf_leb128_s64_write_byval(buf, INT64_MIN));
+    assert(!vf_vlu_s64_write_byval(buf, -65));
+    vf_buf_reset(buf);
+    assert(!vf_leb128_s64_read(buf, &s) && s == INT64_MIN);
+    assert(!vf_vlu_s64_read(buf, &s) && s == -65);
+
+    /* array readers on every kernel match the scalar writers */
+    for (size_t i = 0; i < count; i++) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        in[i] = i % 3 ? x >> (x % 64) : i;
+    }
+    for (int codec = 0; codec < 4; codec++) {
+        test_codec(buf, varint_write, varint_read, &codec, in, out, count, sizeof(in));
+    }
+
+    vf_buf_destroy(buf);
+}
+
+static int packed_write(vf_buf *b, const void *in, size_t n, const void *a)
+{
+    (void)a;
+    return vf_f64_write_packed(b, in, n);
+}
+
+static int packed_read(vf_buf *b, void *out, size_t n, const void *a)
+{
+    (void)a;
+    return vf_f64_read_packed(b, out, n);
+}
+
+void test_packed()
+{
+    enum { count = 200 };
+    static double in[count], out[count];
+    vf_buf *buf = vf_buf_new(count * 12);
+    u64 x = 0x9e3779b97f4a7c15ull;
+
+    /* prices with a few zero, nan and huge outliers patched per block */
+    for (size_t i = 0; i < count; i++) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        in[i] = (double)(10000 + (x >> 52)) / 100.;
+    }
+    in[3] = 0.0;
+    in[70] = NAN;
+    in[71] = -1e300;
+    in[199] = 5e-324;
+
+    size_t used = test_codec(buf, packed_write, packed_read, NULL,
+        in, out, count, sizeof(in));
+    assert(used < count * 8);
+
+    vf_buf_destroy(buf);
+}
+
+void test_mx()
+{
+    enum { count = 100 };
+    static float in[count], out[count];
+    vf_buf *buf = vf_buf_new(count * 8);
+
+    /* a block of 4-bit magnitudes with scale 2^1, steps of 2^-2 */
+    for (size_t i = 0; i < count; i++) {
+        in[i] = (float)((int)(i * 7 % 64) - 32) / 16.f;
+    }
+    in[40] = 3.0f;
+    in[41] = 0.1f;
+    in[90] = INFINITY;
+
+    assert(!vf_f32_write_mx(buf, in, count, 32, 4));
+    size_t used = vf_buf_offset(buf);
+    for (int isa = 0; isa <= (int)vf_kernel_best(); isa++) {
+        assert(!vf_kernel_set((vf_kernel_isa)isa));
+        vf_buf_reset(buf);
+        assert(!vf_f32_read_mx(buf, out, count));
+        assert(vf_buf_offset(buf) == used);
+        assert(out[40] == 3.0f && out[41] == 0.0f && out[0] == -2.0f);
+        /* the third block holds the infinity and is stored exactly */
+        for (size_t i = 0; i < count; i++) {
+            if (i >= 64 && i < 96) assert(out[i] == in[i]);
+            else assert(fabsf(out[i] - in[i]) <= 0.125f);
+        }
+    }
+    vf_kernel_set(vf_kernel_best());
+
+    /* widths past the f32 significand are rejected */
+    assert(vf_f32_write_mx(buf, in, count, 32, 25) < 0);
+    assert(vf_f32_write_mx(buf, in, count, 65, 4) < 0);
+
+    vf_buf_destroy(buf);
+}
+
+static int coded_write(vf_buf *b, const void *in, size_t n, const void *a)
+{
+    (void)a;
+    return vf_f64_write_coded(b, in, n);
+}
+
+static int coded_read(vf_buf *b, void *out, size_t n, const void *a)
+{
+    (void)a;
+    return vf_f64_read_coded(b, out, n);
+}
+
+void test_coded()
+{
+    enum { count = 5000 };
+    static double in[count], out[count];
+    vf_buf *buf = vf_buf_new(count * 12);
+    vf_buf *ref = vf_buf_new(count * 12);
+    u64 x = 0x9e3779b97f4a7c15ull;
+
+    /* a full coded block of prices and a short tail with a single symbol */
+    for (size_t i = 0; i < count; i++) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        in[i] = i < 4096 ? (double)(10000 + (x >> 52)) / 100. : 1.5;
+    }
+    in[7] = NAN;
+    in[8] = -INFINITY;
+    in[9] = 5e-324;
+
+    size_t used = test_codec(buf, coded_write, coded_read, NULL,
+        in, out, count, sizeof(in));
+    assert(!vf_f64_write_array(ref, in, count));
+    assert(used < vf_buf_offset(ref));
+
+    /* a symbol repeated in the code table is rejected */
+    char *p = vf_buf_data(buf);
+    size_t nsym = (u8)p[1] + 1;
+    assert(p[0] == 1 && nsym > 2);
+    for (size_t k = 1; k < nsym; k++) {
+        char s = p[2 + 2 * k];
+        p[2 + 2 * k] = p[2];
+        vf_buf_reset(buf);
+        assert(vf_f64_read_coded(buf, out, count) < 0);
+        p[2 + 2 * k] = s;
+    }
+
+    vf_buf_destroy(ref);
+    vf_buf_destroy(buf);
+}
+
+static int dod_write(vf_buf *b, const void *in, size_t n, const void *a)
+{
+    (void)a;
+    return vf_f64_write_dod(b, in, n);
+}
+
+static int dod_read(vf_buf *b, void *out, size_t n, const void *a)
+{
+    (void)a;
+    return vf_f64_read_dod(b, out, n);
+}
+
+void test_dod()
+{
+    enum { count = 2500 };
+    static double in[count], out[count];
+    vf_buf *buf = vf_buf_new(count * 12);
+    long long us = 1700000000000000ll;
+
+    /* millisecond timestamps with jitter in microseconds, one plain block */
+    for (size_t i = 0; i < count; i++) {
+        us += 1000 + (long long)(i * 7919 % 11) - 5;
+        in[i] = (double)us / 1e6;
+    }
+    in[1500] = NAN;
+
+    size_t used = test_codec(buf, dod_write, dod_read, NULL,
+        in, out, count, sizeof(in));
+    assert(used < count * 5);
+
+    vf_buf_destroy(buf);
+}
+
+static int vec3_write(vf_buf *b, const void *in, size_t n, const void *a)
+{
+    (void)a;
+    return vf_vec3_write_array(b, in, n);
+}
+
+static int vec3_read(vf_buf *b, void *out, size_t n, const void *a)
+{
+    (void)a;
+    return vf_vec3_read_array(b, out, n);
+}
+
+void test_tuple()
+{
+    enum { count = 300 };
+    static double c[count * 2], c2[count * 2];
+    static float v[count * 3], vout[count * 3];
+    vf_buf *buf = vf_buf_new(count * vf_c64_max_length);
+    size_t used, plain;
+
+    for (size_t i = 0; i < count; i++) {
+        c[i * 2] = cos((double)i / 7.) * (double)(i + 1);
+        c[i * 2 + 1] = sin((double)i / 7.) * (double)(i + 1);
+        v[i * 3] = (float)i / 16.f;
+        v[i * 3 + 1] = -(float)i / 32.f;
+        v[i * 3 + 2] = 1.f;
+    }
+    c[20] = INFINITY;
+    c[41] = NAN;
+    c[60] = -0.0;
+    c[61] = 5e-324;
+    v[30] = 1e-40f;
+    v[31] = -INFINITY;
+
+    /* the joint form is shorter than the plain records */
+    assert(!vf_f32_write_array(buf, v, count * 3));
+    plain = vf_buf_offset(buf);
+    used = test_codec(buf, vec3_write, vec3_read, NULL, v, vout, count, sizeof(v));
+    assert(used < plain);
+
+    vf_buf_reset(buf);
+    assert(!vf_c64_write_array(buf, c, count));
+    assert(!vf_c64_write(buf, c + 2));
+    used = vf_buf_offset(buf);
+    buf->data_size = used;
+    vf_buf_reset(buf);
+    assert(!vf_c64_read_array(buf, c2, count));
+    assert(memcmp(c, c2, sizeof(c)) == 0);
+    assert(!vf_c64_read(buf, c2));
+    assert(c2[0] == c[2] && c2[1] == c[3]);
+    assert(vf_c64_read(buf, c2) < 0);
+
+    vf_buf_destroy(buf);
+}
+
+/* arg points to the dimension, vectors are written exactly */
+static int vec_write(vf_buf *b, const void *in, size_t n, const void *a)
+{
+    return vf_f32_write_vec(b, in, *(const size_t*)a, n, 24);
+}
+
+static int vec_read(vf_buf *b, void *out, size_t n, const void *a)
+{
+    return vf_f32_read_vec(b, out, *(const size_t*)a, n);
+}
+
+void test_vec()
+{
+    enum { dim = 100, count = 5 };
+    static float in[dim * count], out[dim * count];
+    vf_buf *buf = vf_buf_new(count * (3 + 4 * dim));
+    size_t used, d = dim;
+
+    /* bfloat16 values keep 7 mantissa bits, fields are 1 + k + 7 bits */
+    for (size_t i = 0; i < dim * count; i++) {
+        union { u32 u; f32 d; } x = { .d = sinf((float)i) / (float)(i % 7 + 1) };
+        x.u &= 0xffff0000u;
+        in[i] = x.d;
+    }
+    in[3] = INFINITY;
+    in[dim + 4] = -0.f;
+    in[dim + 5] = 1e-40f;
+    in[dim * 2 + 6] = NAN;
+    memset(in + dim * 3, 0, dim * sizeof(float));
+
+    used = test_codec(buf, vec_write, vec_read, &d, in, out, count, sizeof(in));
+    assert(used < dim * count * 2);
+
+    /* rounded to 5 significant bits, the relative error is at most 2^-5 */
+    vf_buf_reset(buf);
+    assert(vf_f32_write_vec(buf, in, dim, count, 25) < 0);
+    assert(vf_f32_write_vec(buf, in, 0, count, 24) < 0);
+    assert(!vf_f32_write_vec(buf, in + dim * 4, dim, 1, 5));
+    assert(vf_buf_offset(buf) < dim * 2);
+    vf_buf_reset(buf);
+    assert(!vf_f32_read_vec(buf, out, dim, 1));
+    for (size_t i = 0; i < dim; i++) {
+        float x = in[dim * 4 + i];
+        assert(fabsf(out[i] - x) <= fabsf(x) * 0x1p-5f);
+    }
+
+    /* rounding near FLT_MAX clamps to the largest finite value */
+    static const float big[2] = { 0x1.e472ap+127f, -0x1.ff5254p+127f };
+    static const float big1[2] = { 0x1p+127f, -0x1p+127f };
+    static const float big7[2] = { 0x1.e4p+127f, -0x1.fcp+127f };
+    vf_buf_reset(buf);
+    assert(!vf_f32_write_vec(buf, big, 2, 1, 1));
+    assert(!vf_f32_write_vec(buf, big, 2, 1, 7));
+    vf_buf_reset(buf);
+    assert(!vf_f32_read_vec(buf, out, 2, 1));
+    assert(memcmp(out, big1, sizeof(big1)) == 0);
+    assert(!vf_f32_read_vec(buf, out, 2, 1));
+    assert(memcmp(out, big7, sizeof(big7)) == 0);
+
+    vf_buf_destroy(buf);
+}
+
+struct schema_rec
+{
+    double price;
+    float qty;
+    s32 side;
+    s64 ts;
+    u64 id;
+};
+
+static int schema_write(vf_buf *b, const void *in, size_t n, const void *a)
+{
+    return vf_schema_write(b, a, in, n);
+}
+
+static int schema_read(vf_buf *b, void *out, size_t n, const void *a)
+{
+    return vf_schema_read(b, a, out, n);
+}
+
+void test_schema()
+{
+    enum { count = 20 };
+    static const vf_field fields[] = {
+        { offsetof(struct schema_rec, ts), vf_field_s64 },
+        { offsetof(struct schema_rec, price), vf_field_f64 },
+        { offsetof(struct schema_rec, qty), vf_field_f32 },
+        { offsetof(struct schema_rec, side), vf_field_s32 },
+        { offsetof(struct schema_rec, id), vf_field_u64 },
+    };
+    static const vf_field bad[] = { { 4, vf_field_f64 } };
+    static struct schema_rec in[count], out[count];
+    vf_schema *s = vf_schema_new(fields, 5, sizeof(struct schema_rec));
+    vf_buf *buf = vf_buf_new(count * vf_schema_max_length(s));
+    vf_buf *ref = vf_buf_new(count * vf_schema_max_length(s));
+
+    assert(vf_schema_max_length(s) == 9 + 11 + 7 + 9 + 9);
+    for (size_t i = 0; i < count; i++) {
+        in[i].price = 100. + (double)i / 4.;
+        in[i].qty = (float)(i * 100);
+        in[i].side = (s32)(i % 3) - 1;
+        in[i].ts = 1700000000000000000ll + (s64)i * 1000;
+        in[i].id = ~0ull >> i;
+    }
+
+    /* the same bytes as writing each field by hand */
+    size_t used = test_codec(buf, schema_write, schema_read, s,
+        in, out, count, sizeof(in));
+    for (size_t i = 0; i < count; i++) {
+        assert(!vf_vlu_s64_write(ref, &in[i].ts));
+        assert(!vf_f64_write(ref, &in[i].price));
+        assert(!vf_f32_write(ref, &in[i].qty));
+        assert(!vf_vlu_s64_write_byval(ref, in[i].side));
+        assert(!vf_vlu_u64_write(ref, &in[i].id));
+    }
+    assert(used == vf_buf_offset(ref));
+    assert(memcmp(vf_buf_data(buf), vf_buf_data(ref), used) == 0);
+
+    /* a truncated record leaves the offset at its start */
+    vf_buf_reset(buf);
+    buf->data_size = used - 1;
+    assert(vf_schema_read(buf, s, out, count) < 0);
+    assert(vf_buf_offset(buf) < used && vf_buf_offset(buf) > 0);
+
+    /* fields must lie inside the stride */
+    assert(vf_schema_new(bad, 1, 8) == NULL);
+
+    vf_buf_destroy(ref);
+    vf_buf_destroy(buf);
+    vf_schema_destroy(s);
+}
+
+void test_pool()
+{
+    vf_buf_pool *pool = vf_buf_pool_new();
+    vf_buf *a = vf_buf_acquire(pool, 1000), *b, *c;
+    double f;
+
+    /* sizes round up to a class and the rest becomes padding */
+    assert(a->data_size == 1000 && a->data_offset == 0);
+    assert(a->data_pad == 1024 - 1000 + VF_BUF_PADDING);
+    assert(!vf_f64_write(a, &pi_f64));
+    vf_buf_release(pool, a);
+
+    /* the same class is reused from the thread cache, reset not cleared */
+    b = vf_buf_acquire(pool, 600);
+    assert(b == a && b->data_offset == 0 && b->data_size == 600);
+    assert(!vf_f64_read(b, &f) && f == pi_f64);
+
+    c = vf_buf_acquire(pool, 100 << 20);
+    assert(c != NULL && c->data_pad == VF_BUF_PADDING);
+    vf_buf_release(pool, c);
+    vf_buf_release(pool, b);
+
+    vf_buf_pool_destroy(pool);
+
+    /* with more pools than thread cache slots, evicted caches are flushed
+     * to their pool, so a released buffer is reused and not stranded */
+    enum { npools = 7 };
+    vf_buf_pool *pools[npools];
+    vf_buf *last[npools];
+    for (size_t i = 0; i < npools; i++) pools[i] = vf_buf_pool_new();
+    for (size_t r = 0; r < 100; r++) {
+        for (size_t i = 0; i < npools; i++) {
+            a = vf_buf_acquire(pools[i], 4000);
+            assert(r == 0 || a == last[i]);
+            last[i] = a;
+            vf_buf_release(pools[i], a);
+        }
+    }
+    /* a destroyed pool in the thread table is skipped when evicted */
+    vf_buf_pool_destroy(pools[0]);
+    pools[0] = vf_buf_pool_new();
+    for (size_t i = 0; i < npools; i++) {
+        vf_buf_release(pools[i], vf_buf_acquire(pools[i], 100));
+        vf_buf_pool_destroy(pools[i]);
+    }
+}
+
+void test_read_any()
+{
+    static const double in[] = { 1 + 0x1p-30, -(1 + 0x1p-30), 1 + 0x1p-23 + 0x1p-24, 1e39, 1e-50, 0x1p-140 };
+    static const float out[4][6] = {
+        { 1.f, -1.f, 1 + 0x1p-22f, INFINITY, 0.f, 0x1p-140f },
+        { 1.f, -1.f, 1 + 0x1p-23f, INFINITY, 0.f, 0x1p-140f },
+        { 1 + 0x1p-23f, -1.f, 1 + 0x1p-22f, INFINITY, 0x1p-149f, 0x1p-140f },
+        { 1.f, -(1 + 0x1p-23f), 1 + 0x1p-23f, INFINITY, 0.f, 0x1p-140f },
+    };
+    enum { n = sizeof(in) / sizeof(in[0]) };
+    float sub = 0x1p-149f, f[n];
+    double d;
+    vf_buf *buf = vf_buf_new(256);
+
+    /* f64 records rounded to float in each mode, overflowing to Inf */
+    assert(!vf_f64_write_array(buf, in, n));
+    for (int m = 0; m < 4; m++) {
+        vf_buf_reset(buf);
+        assert(!vf_f32_read_from_any(buf, f, n, vf_field_f64, (vf_rounding)m));
+        for (size_t i = 0; i < n; i++) assert(f[i] == out[m][i]);
+    }
+
+    /* float subnormals are renormalized relative to the f32 range */
+    vf_buf_reset(buf);
+    assert(!vf_f32_write(buf, &sub));
+    vf_buf_reset(buf);
+    assert(!vf_f64_read_from_any(buf, &d, 1, vf_field_f32, vf_round_nearest));
+    assert(d == 0x1p-149);
+    vf_buf_reset(buf);
+    assert(vf_f64_read_from_any(buf, &d, 1, vf_field_u64, vf_round_nearest) < 0);
+
+    vf_buf_destroy(buf);
+}
+
+void test_stats()
+{
+    static const double vals[] = {
+        0.0, INFINITY, NAN, 1.5, 1024.0, 0.1, 4.9406564584124654e-324, 3.141592653589793
+    };
+    static const vf_class cls[] = {
+        vf_class_zero, vf_class_inf, vf_class_nan, vf_class_inline,
+        vf_class_pow2, vf_class_unary, vf_class_subnormal, vf_class_full
+    };
+    enum { n = sizeof(vals) / sizeof(vals[0]) };
+    vf_buf *buf = vf_buf_new(256);
+    vf_stats s1, s2;
+    double out[n];
+    size_t bytes;
+
+    vf_stats_reset(&s1);
+    vf_stats_reset(&s2);
+    vf_buf_set_stats(buf, &s1);
+    for (size_t i = 0; i < n; i++) {
+        assert(!vf_f64_write(buf, &vals[i]));
+        assert(s1.records[cls[i]] == 1);
+    }
+    bytes = vf_buf_offset(buf);
+    assert(s1.header_bytes + s1.exp_bytes + s1.man_bytes == bytes);
+    assert(s1.length[1] == 4 && s1.length[9] == 1);
+
+    /* scalar decode counts the same records, a failed read none */
+    vf_buf_set_stats(buf, &s2);
+    vf_buf_reset(buf);
+    buf->data_size = bytes;
+    for (size_t i = 0; i < n; i++) {
+        assert(!vf_f64_read_byval(buf).error);
+    }
+    assert(vf_f64_read(buf, out) < 0);
+    assert(memcmp(&s1, &s2, sizeof(vf_stats)) == 0);
+
+    /* array decode counts the same records, merge adds them up */
+    vf_stats_reset(&s2);
+    vf_buf_reset(buf);
+    assert(!vf_f64_read_array(buf, out, n));
+    assert(memcmp(&s1, &s2, sizeof(vf_stats)) == 0);
+    vf_stats_merge(&s1, &s2);
+    assert(s1.records[vf_class_full] == 2 && s1.header_bytes == 2 * n);
+
+    vf_buf_destroy(buf);
+}
+
 int main(int argc, const char **argv)
 {
     test_ber_pi();
     test_vf64_loop();
     test_vf32_loop();
+    test_inline_one();
+    test_array_loop();
+    test_unpadded();
+    test_asn1_array();
+    test_asn1_real_forms();
+    test_asn1_real_types();
+    test_decimal();
+    test_transcode();
+    test_varint();
+    test_packed();
+    test_mx();
+    test_coded();
+    test_dod();
+    test_tuple();
+    test_vec();
+    test_schema();
+    test_pool();
+    test_read_any();
+    test_stats();
 }
@@ -0,0 +1,169 @@
+#undef NDEBUG
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <thread>
+
+#include "vf128.hpp"
+
+static_assert(vf::max_length<double, float, s64> == 11 + 7 + 9);
+static_assert(vf::max_length<const int&, u8> == 9 + 9);
+
+/* the bytes match the C codecs and one write covers the tuple */
+void test_write_read()
+{
+    vf_buf *buf = vf_buf_new(128), *ref = vf_buf_new(128);
+    double d = 3.141592653589793;
+    float f = 0.1f;
+    s64 ts = -1700000000000000000ll;
+    u32 id = 0xdeadbeef;
+
+    assert(!vf::write(buf, d, f, ts, id));
+    assert(!vf_f64_write(ref, &d));
+    assert(!vf_f32_write(ref, &f));
+    assert(!vf_vlu_s64_write(ref, &ts));
+    assert(!vf_vlu_u64_write_byval(ref, id));
+    size_t used = vf_buf_offset(buf);
+    assert(used == vf_buf_offset(ref));
+    assert(memcmp(vf_buf_data(buf), vf_buf_data(ref), used) == 0);
+
+    vf_buf_reset(buf);
+    auto t = vf::read<double, float, s64, u32>(buf);
+    assert(t && *t == std::make_tuple(d, f, ts, id));
+    assert(vf_buf_offset(buf) == used);
+
+    double d2;
+    float f2;
+    s64 ts2;
+    u32 id2;
+    vf_buf_reset(buf);
+    assert(!vf::read(buf, std::tie(d2, f2, ts2, id2)));
+    assert(d2 == d && f2 == f && ts2 == ts && id2 == id);
+
+    /* the u32 does not fit in a u16, the offset is left at the start */
+    u16 small;
+    vf_buf_reset(buf);
+    assert(vf::read(buf, d2, f2, ts2, small) < 0);
+    assert(vf_buf_offset(buf) == 0);
+
+    vf_buf_destroy(ref);
+    vf_buf_destroy(buf);
+}
+
+/* near the end of the buffer the checked writers are used */
+void test_short_buffer()
+{
+    vf_buf *buf = vf_buf_new(8);
+    std::tuple<double, double> t { 1.5, M_PI };
+
+    assert(vf::write(buf, t) < 0);
+    assert(vf_buf_offset(buf) == 0);
+    assert(!vf::write(buf, std::get<0>(t), std::get<1>(t) * 0));
+    assert(vf_buf_offset(buf) == 2);
+
+    buf->data_size = vf_buf_offset(buf);
+    vf_buf_reset(buf);
+    std::tuple<double, double> r;
+    assert(!vf::read(buf, r));
+    assert(std::get<0>(r) == 1.5 && std::get<1>(r) == 0.0);
+    assert(!vf::read<double>(buf));
+
+    vf_buf_destroy(buf);
+}
+
+/* a range over the records decodes in batches across the span */
+void test_decode_view()
+{
+    enum { count = 1000 };
+    static double in[count];
+    vf_buf *buf = vf_buf_new(count * 11);
+    double sum = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        in[i] = (double)i / 8.;
+        sum += in[i];
+    }
+    assert(!vf_f64_write_array(buf, in, count));
+    vf_span span = { vf_buf_data(buf), vf_buf_offset(buf) };
+
+    vf::decode_view<double> view(span);
+    size_t n = 0;
+    for (double x : view) assert(x == in[n++]);
+    assert(n == count && !view.error());
+    assert(std::accumulate(view.begin(), view.end(), 0.0) == sum);
+    assert(std::count_if(view.begin(), view.end(), [](double x) { return x >= 100.; }) == 200);
+
+    /* a truncated last record ends the range and sets error */
+    span.length--;
+    vf::decode_view<double> cut(span);
+    assert(std::distance(cut.begin(), cut.end()) == count - 1 && cut.error());
+
+    /* a view of the records left in a buffer */
+    vf_buf_reset(buf);
+    assert(!vf_f32_write_byval(buf, 0.5f));
+    assert(!vf_f32_write_byval(buf, -2.f));
+    buf->data_size = vf_buf_offset(buf);
+    vf_buf_reset(buf);
+    assert(vf_f32_read_byval(buf).value == 0.5f);
+    vf::decode_view<float> rest(buf);
+    assert(*rest.begin() == -2.f && ++rest.begin() == rest.end());
+
+    vf_buf_destroy(buf);
+}
+
+/* std::complex<double> is one joint-exponent tuple */
+void test_complex()
+{
+    enum { count = 64 };
+    static std::complex<double> in[count], out[count];
+    vf_buf *buf = vf_buf_new(count * vf_c64_max_length + 64);
+
+    for (size_t i = 0; i < count; i++) in[i] = std::polar(1. + (double)i, (double)i / 10.);
+    assert(!vf::write_array(buf, in, count));
+    std::complex<double> c { 0.25, -3.0 };
+    assert(!vf::write(buf, c, 1.5));
+    size_t used = vf_buf_offset(buf);
+
+    buf->data_size = used;
+    vf_buf_reset(buf);
+    assert(!vf::read_array(buf, out, count));
+    assert(std::equal(in, in + count, out));
+    auto t = vf::read<std::complex<double>, double>(buf);
+    assert(t && *t == std::make_tuple(c, 1.5));
+    assert(vf_buf_offset(buf) == used);
+
+    vf_buf_destroy(buf);
+}
+
+/* a thread that exits returns its cached buffers to the pool */
+void test_pool_thread_exit()
+{
+    vf_buf_pool *pool = vf_buf_pool_new();
+    vf_buf *held = nullptr;
+
+    for (int i = 0; i < 3; i++) {
+        std::thread([&] {
+            vf_buf *b = vf_buf_acquire(pool, 4000);
+            assert(!held || b == held);
+            held = b;
+            vf_buf_release(pool, b);
+        }).join();
+    }
+    vf_buf *b = vf_buf_acquire(pool, 4000);
+    assert(b == held);
+    vf_buf_release(pool, b);
+
+    vf_buf_pool_destroy(pool);
+}
+
+int main(int argc, const char **argv)
+{
+    test_write_read();
+    test_short_buffer();
+    test_decode_view();
+    test_complex();
+    test_pool_thread_exit();
+}